@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "dynloader.h"
+#include "debug.h"
+
+/*
+ * Chargement de plusieurs bibliothèques à froid : my_dlopen() l'une après
+ * l'autre contre my_dlopen_async() pour toutes puis my_dlasync_wait().
+ * Avant chaque tour, les fichiers sont retirés du cache de pages
+ * (POSIX_FADV_DONTNEED, sans effet sur les pages encore projetées). On
+ * mesure le temps pendant lequel l'appelant est bloqué et le temps total.
+ *
+ * usage: bench_async ROUNDS LIBRARY...
+ */
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void evict(char **paths, int count) {
+    for (int i = 0; i < count; i++) {
+        int fd = open(paths[i], O_RDONLY);
+        if (fd >= 0) {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+}
+
+// Un tour ; *blocked reçoit le temps passé dans les appels de soumission
+static int run_round(char **paths, int count, int async, uint64_t *blocked, uint64_t *total) {
+    void **handles = calloc(count, sizeof(void *));
+    if (!handles) {
+        perror("calloc failed");
+        return -1;
+    }
+    evict(paths, count);
+
+    int ok = 1;
+    uint64_t start = now_ns();
+    if (async) {
+        for (int i = 0; i < count; i++) {
+            handles[i] = my_dlopen_async(paths[i], 0);
+        }
+        *blocked = now_ns() - start;
+        // L'appelant serait libre ici ; on attend simplement la fin
+        for (int i = 0; i < count; i++) {
+            handles[i] = handles[i] ? my_dlasync_wait(handles[i]) : NULL;
+        }
+    } else {
+        for (int i = 0; i < count; i++) {
+            handles[i] = my_dlopen(paths[i]);
+        }
+        *blocked = now_ns() - start;
+    }
+    *total = now_ns() - start;
+
+    for (int i = 0; i < count; i++) {
+        if (handles[i]) {
+            my_dlclose(handles[i]);
+        } else {
+            ok = 0;
+        }
+    }
+    free(handles);
+    return ok ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s ROUNDS LIBRARY...\n", argv[0]);
+        return 1;
+    }
+    int rounds = atoi(argv[1]);
+    if (rounds <= 0) {
+        fprintf(stderr, "invalid ROUNDS\n");
+        return 1;
+    }
+    char **paths = argv + 2;
+    int count = argc - 2;
+    debug_init(DBG_NONE);
+
+    // Les messages de chargement ne doivent pas fausser la mesure
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, 1);
+
+    uint64_t blocked[2] = {0, 0}, total[2] = {0, 0};
+    int status = 0;
+    for (int r = 0; r < rounds && status == 0; r++) {
+        for (int async = 0; async < 2 && status == 0; async++) {
+            uint64_t b, t;
+            status = run_round(paths, count, async, &b, &t);
+            blocked[async] += b;
+            total[async] += t;
+        }
+    }
+
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+    close(null_fd);
+    close(saved_stdout);
+    if (status != 0) {
+        fprintf(stderr, "load failed\n");
+        return 1;
+    }
+
+    printf("%d libraries, %d rounds (cold page cache)\n", count, rounds);
+    static const char *labels[2] = {"my_dlopen", "my_dlopen_async"};
+    for (int async = 0; async < 2; async++) {
+        printf("%-16s blocked %9.1f us  total %9.1f us\n", labels[async],
+               (double) blocked[async] / rounds / 1000.0, (double) total[async] / rounds / 1000.0);
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "dynloader.h"
+#include "debug.h"
+
+/*
+ * Coût du profil des appels (LOAD_CALLSTATS) sur un import d'une PLT
+ * standard : plain_call() de libplain.so appelle plain_hook(), lié par
+ * GOT[2]. Modes :
+ *   - off     : sans LOAD_CALLSTATS, slot lié directement à la cible ;
+ *   - count   : stub de comptage seul (my_dlstats_sample(0)) ;
+ *   - sample  : un appel sur CALLSTATS_DEFAULT_PERIOD chronométré ;
+ *   - every   : chaque appel chronométré.
+ * Chaque mode tourne sur 1 puis THREADS threads, qui comptent chacun dans
+ * leurs propres lignes ; le total de my_dlstats() est contrôlé.
+ *
+ * usage: bench_callstats ./bench/lib/libplain.so [CALLS] [THREADS]
+ */
+
+#define DEFAULT_CALLS 10000000
+#define DEFAULT_THREADS 4
+
+typedef long (*plain_call_fn)(long);
+
+// Import de libplain.so, résolu dans l'exécutable (-rdynamic)
+__attribute__((noinline)) long plain_hook(long x) {
+    return x * 2;
+}
+
+typedef struct {
+    plain_call_fn fn;
+    long calls;
+    long sum;
+} worker_arg;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void *worker(void *arg) {
+    worker_arg *w = arg;
+    long sum = 0;
+    for (long i = 0; i < w->calls; i++) {
+        sum += w->fn(i);
+    }
+    w->sum = sum;
+    return NULL;
+}
+
+// ns par appel, -1 en cas d'échec ; *counted : appels vus par le profil
+static double run(const char *path, int flags, int threads, long calls, uint64_t *counted) {
+    void *handle = my_dlopen_flags(path, flags);
+    plain_call_fn fn = handle ? (plain_call_fn) my_dlsym(handle, "plain_call") : NULL;
+    if (!fn) {
+        if (handle) {
+            my_dlclose(handle);
+        }
+        return -1;
+    }
+    // Liaison du slot hors mesure
+    fn(0);
+
+    pthread_t tids[threads];
+    worker_arg args[threads];
+    uint64_t start = now_ns();
+    for (int t = 0; t < threads; t++) {
+        args[t] = (worker_arg){fn, calls / threads, 0};
+        pthread_create(&tids[t], NULL, worker, &args[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    *counted = 0;
+    import_stats_t stats[8];
+    int count = my_dlstats(handle, stats, 8);
+    for (int i = 0; i < count && i < 8; i++) {
+        if (strcmp(stats[i].name, "plain_hook") == 0) {
+            *counted = stats[i].calls;
+        }
+    }
+    my_dlclose(handle);
+    return (double) elapsed / (calls / threads * threads);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s LIBRARY [CALLS] [THREADS]\n", argv[0]);
+        return 1;
+    }
+    long calls = argc > 2 ? atol(argv[2]) : DEFAULT_CALLS;
+    int threads = argc > 3 ? atoi(argv[3]) : DEFAULT_THREADS;
+    if (calls <= 0 || threads <= 0 || threads > 256) {
+        fprintf(stderr, "invalid CALLS/THREADS\n");
+        return 1;
+    }
+    debug_init(DBG_NONE);
+
+    static const struct {
+        const char *label;
+        int flags;
+        unsigned period;
+    } modes[] = {
+        {"off", 0, 0},
+        {"count", LOAD_CALLSTATS, 0},
+        {"sample", LOAD_CALLSTATS, CALLSTATS_DEFAULT_PERIOD},
+        {"every", LOAD_CALLSTATS, 1},
+    };
+
+    printf("%s, %ld calls\n", argv[1], calls);
+    int status = 0;
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        my_dlstats_sample(modes[m].period);
+        int counts[2] = {1, threads};
+        for (int k = 0; k < (threads > 1 ? 2 : 1); k++) {
+            uint64_t counted;
+            double ns = run(argv[1], modes[m].flags, counts[k], calls, &counted);
+            if (ns < 0) {
+                fprintf(stderr, "load failed\n");
+                return 1;
+            }
+            // Appels mesurés, plus celui de la liaison
+            uint64_t expected = modes[m].flags ? (uint64_t) (calls / counts[k] * counts[k]) + 1 : 0;
+            printf("%-7s %3d thread(s): %6.2f ns/call  counted %lu%s\n", modes[m].label,
+                   counts[k], ns, counted, counted == expected ? "" : "  MISMATCH");
+            if (counted != expected) {
+                status = 1;
+            }
+        }
+    }
+    return status;
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "dynloader.h"
+#include "isosz.h"
+#include "debug.h"
+
+/*
+ * Bibliothèque ordinaire contre son conteneur compressé (.isosz) :
+ * my_dlopen() puis lecture de toutes les pages de l'image, à froid
+ * (fichiers retirés du cache de pages par POSIX_FADV_DONTNEED) et à
+ * chaud. Une image projetée est chargée page par page au premier accès,
+ * une image compressée est décompressée en entier au chargement : on
+ * compare donc chargement + accès à toute l'image.
+ *
+ * usage: bench_compress LIBRARY [ROUNDS]
+ */
+
+#define DEFAULT_ROUNDS 20
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void evict(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+static void touch_image(lib_handle_t *lib) {
+    size_t page_size = getpagesize();
+    for (int i = 0; i < lib->range_count; i++) {
+        const volatile char *p = lib->ranges[i].start;
+        for (size_t off = 0; off < lib->ranges[i].size; off += page_size) {
+            (void) p[off];
+        }
+    }
+}
+
+// Temps moyen d'un chargement suivi de la lecture de toute l'image
+static int run(const char *path, int rounds, int cold, double *load_us, double *total_us) {
+    uint64_t load_ns = 0, total_ns = 0;
+    for (int r = 0; r < rounds; r++) {
+        if (cold) {
+            evict(path);
+        }
+        uint64_t start = now_ns();
+        lib_handle_t *lib = my_dlopen(path);
+        uint64_t loaded = now_ns();
+        if (!lib) {
+            return -1;
+        }
+        touch_image(lib);
+        total_ns += now_ns() - start;
+        load_ns += loaded - start;
+        my_dlclose(lib);
+    }
+    *load_us = (double) load_ns / rounds / 1000.0;
+    *total_us = (double) total_ns / rounds / 1000.0;
+    return 0;
+}
+
+static long file_size(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long) st.st_size : -1;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s LIBRARY [ROUNDS]\n", argv[0]);
+        return 1;
+    }
+    int rounds = argc > 2 ? atoi(argv[2]) : DEFAULT_ROUNDS;
+    if (rounds <= 0) {
+        fprintf(stderr, "invalid ROUNDS\n");
+        return 1;
+    }
+    debug_init(DBG_NONE);
+
+    char container[4096];
+    snprintf(container, sizeof(container), "/tmp/bench_compress.%d" ISOSZ_SUFFIX, (int) getpid());
+
+    // Les messages de chargement ne doivent pas fausser la mesure
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, 1);
+
+    int status = isosz_write(argv[1], container) < 0 ? -1 : 0;
+    const char *paths[2] = {argv[1], container};
+    double load_us[2][2], total_us[2][2];
+    for (int z = 0; z < 2 && status == 0; z++) {
+        for (int cold = 0; cold < 2 && status == 0; cold++) {
+            status = run(paths[z], rounds, cold, &load_us[z][cold], &total_us[z][cold]);
+        }
+    }
+
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+    close(null_fd);
+    close(saved_stdout);
+    if (status != 0) {
+        fprintf(stderr, "load failed\n");
+        unlink(container);
+        return 1;
+    }
+
+    printf("%s: %ld -> %ld bytes compressed, %d rounds\n", argv[1], file_size(argv[1]),
+           file_size(container), rounds);
+    static const char *labels[2] = {"plain", "compressed"};
+    static const char *cache[2] = {"warm", "cold"};
+    for (int z = 0; z < 2; z++) {
+        for (int cold = 0; cold < 2; cold++) {
+            printf("%-10s %s: load %9.1f us  load+touch %9.1f us\n", labels[z], cache[cold],
+                   load_us[z][cold], total_us[z][cold]);
+        }
+    }
+    unlink(container);
+    return 0;
+}
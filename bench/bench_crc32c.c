@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "dynloader.h"
+#include "crc32c.h"
+#include "integrity.h"
+#include "debug.h"
+
+/*
+ * Vérification d'intégrité au chargement. D'abord le débit du CRC32C
+ * (instruction SSE4.2 contre table). Puis, sur une copie de LIBRARY
+ * dotée de sa note .note.isos.crc32c, à froid et à chaud :
+ *   - plain    : my_dlopen() sans vérification ;
+ *   - separate : lecture du fichier entier pour le hacher, puis my_dlopen() ;
+ *   - verify   : my_dlopen_flags(LOAD_VERIFY).
+ * Chaque chargement est suivi de la lecture de toute l'image.
+ *
+ * usage: bench_crc32c LIBRARY [ROUNDS]
+ */
+
+#define DEFAULT_ROUNDS 20
+#define THROUGHPUT_SIZE (64u << 20)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void evict(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+static void touch_image(lib_handle_t *lib) {
+    size_t page_size = getpagesize();
+    for (int i = 0; i < lib->range_count; i++) {
+        const volatile char *p = lib->ranges[i].start;
+        for (size_t off = 0; off < lib->ranges[i].size; off += page_size) {
+            (void) p[off];
+        }
+    }
+}
+
+// Passe de hachage séparée : tout le fichier lu et haché avant le chargement
+static uint32_t hash_file(const char *path) {
+    static uint8_t buf[1 << 20];
+    uint32_t crc = 0;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        crc = crc32c(crc, buf, n);
+    }
+    close(fd);
+    return crc;
+}
+
+enum { PLAIN, SEPARATE, VERIFY, MODES };
+
+static int run(const char *path, int mode, int cold, int rounds, double *load_us,
+               double *total_us) {
+    uint64_t load_ns = 0, total_ns = 0;
+    for (int r = 0; r < rounds; r++) {
+        if (cold) {
+            evict(path);
+        }
+        uint64_t start = now_ns();
+        if (mode == SEPARATE) {
+            (void) hash_file(path);
+        }
+        lib_handle_t *lib = my_dlopen_flags(path, mode == VERIFY ? LOAD_VERIFY : 0);
+        uint64_t loaded = now_ns();
+        if (!lib) {
+            return -1;
+        }
+        touch_image(lib);
+        total_ns += now_ns() - start;
+        load_ns += loaded - start;
+        my_dlclose(lib);
+    }
+    *load_us = (double) load_ns / rounds / 1000.0;
+    *total_us = (double) total_ns / rounds / 1000.0;
+    return 0;
+}
+
+static int copy_file(const char *from, const char *to) {
+    int in = open(from, O_RDONLY);
+    int out = open(to, O_WRONLY | O_CREAT | O_TRUNC, 0755);
+    char buf[1 << 16];
+    ssize_t n = -1;
+    while (in >= 0 && out >= 0 && (n = read(in, buf, sizeof(buf))) > 0) {
+        if (write(out, buf, n) != n) {
+            n = -1;
+            break;
+        }
+    }
+    if (in >= 0) {
+        close(in);
+    }
+    if (out >= 0) {
+        close(out);
+    }
+    return n == 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s LIBRARY [ROUNDS]\n", argv[0]);
+        return 1;
+    }
+    int rounds = argc > 2 ? atoi(argv[2]) : DEFAULT_ROUNDS;
+    if (rounds <= 0) {
+        fprintf(stderr, "invalid ROUNDS\n");
+        return 1;
+    }
+    debug_init(DBG_NONE);
+
+    // Débit du CRC32C seul
+    uint8_t *buf = malloc(THROUGHPUT_SIZE);
+    if (!buf) {
+        perror("malloc failed");
+        return 1;
+    }
+    for (size_t i = 0; i < THROUGHPUT_SIZE; i++) {
+        buf[i] = (uint8_t) (i * 2654435761u >> 13);
+    }
+    uint64_t start = now_ns();
+    uint32_t sw = crc32c_sw(0, buf, THROUGHPUT_SIZE);
+    double sw_gbs = THROUGHPUT_SIZE / (double) (now_ns() - start);
+    start = now_ns();
+    uint32_t hw = crc32c_hw(0, buf, THROUGHPUT_SIZE);
+    double hw_gbs = THROUGHPUT_SIZE / (double) (now_ns() - start);
+    free(buf);
+    printf("crc32c table  %6.2f GB/s\n", sw_gbs);
+    if (crc32c_hw_available()) {
+        printf("crc32c sse4.2 %6.2f GB/s%s\n", hw_gbs, hw == sw ? "" : "  MISMATCH");
+    }
+
+    char copy[4096];
+    snprintf(copy, sizeof(copy), "/tmp/bench_crc32c.%d.so", (int) getpid());
+
+    // Les messages de chargement ne doivent pas fausser la mesure
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, 1);
+
+    int status = copy_file(argv[1], copy) == 0 && integrity_write(copy) >= 0 ? 0 : -1;
+    double load_us[MODES][2], total_us[MODES][2];
+    for (int mode = 0; mode < MODES && status == 0; mode++) {
+        for (int cold = 0; cold < 2 && status == 0; cold++) {
+            status = run(copy, mode, cold, rounds, &load_us[mode][cold], &total_us[mode][cold]);
+        }
+    }
+
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+    close(null_fd);
+    close(saved_stdout);
+    unlink(copy);
+    if (status != 0) {
+        fprintf(stderr, "load failed\n");
+        return 1;
+    }
+
+    printf("%s, %d rounds\n", argv[1], rounds);
+    static const char *labels[MODES] = {"plain", "separate", "verify"};
+    static const char *cache[2] = {"warm", "cold"};
+    for (int mode = 0; mode < MODES; mode++) {
+        for (int cold = 0; cold < 2; cold++) {
+            printf("%-9s %s: load %9.1f us  load+touch %9.1f us\n", labels[mode], cache[cold],
+                   load_us[mode][cold], total_us[mode][cold]);
+        }
+    }
+    return hw == sw ? 0 : 1;
+}
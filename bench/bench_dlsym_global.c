@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "dynloader.h"
+#include "debug.h"
+
+/*
+ * Recherche globale d'un symbole sur de nombreux handles : boucle de
+ * my_dlsym() sur chaque handle (comparaisons de noms dans toutes les
+ * tables) contre my_dlsym_global() (filtre de Bloom par handle). COPIES
+ * copies d'une grosse bibliothèque sont chargées, puis une petite : les
+ * noms cherchés sont exportés par la première, par la dernière, ou par
+ * aucune.
+ *
+ * usage: bench_dlsym_global ./bench/lib/libbigtext.so ./libmylib.so [COPIES] [ROUNDS]
+ */
+
+#define DEFAULT_COPIES 32
+#define DEFAULT_ROUNDS 2000
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+// Ce que ferait un appelant sans recherche globale
+static void *lookup_each(void **handles, int count, const char *name) {
+    for (int i = 0; i < count; i++) {
+        void *addr = my_dlsym(handles[i], name);
+        if (addr) {
+            return addr;
+        }
+    }
+    return NULL;
+}
+
+static void run_lookups(const char *label, const char *name, void **handles, int count,
+                        int rounds) {
+    void *expected = lookup_each(handles, count, name);
+
+    uint64_t start = now_ns();
+    for (int r = 0; r < rounds; r++) {
+        if (lookup_each(handles, count, name) != expected) {
+            fprintf(stderr, "lookup mismatch\n");
+        }
+    }
+    uint64_t each_ns = now_ns() - start;
+
+    start = now_ns();
+    for (int r = 0; r < rounds; r++) {
+        if (my_dlsym_global(name, NULL) != expected) {
+            fprintf(stderr, "global lookup mismatch: %s\n", name);
+        }
+    }
+    uint64_t global_ns = now_ns() - start;
+
+    printf("%-12s %-16s my_dlsym loop=%9.1f ns  my_dlsym_global=%8.1f ns  (x%.1f)\n", label,
+           name, (double) each_ns / rounds, (double) global_ns / rounds,
+           (double) each_ns / (double) (global_ns ? global_ns : 1));
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s BIG_LIBRARY SMALL_LIBRARY [COPIES] [ROUNDS]\n", argv[0]);
+        return 1;
+    }
+    int copies = argc > 3 ? atoi(argv[3]) : DEFAULT_COPIES;
+    int rounds = argc > 4 ? atoi(argv[4]) : DEFAULT_ROUNDS;
+    debug_init(DBG_NONE);
+
+    int count = copies + 1;
+    void **handles = calloc(count, sizeof(void *));
+    if (!handles) {
+        perror("calloc failed");
+        return 1;
+    }
+
+    // Les messages de chargement ne doivent pas fausser la mesure
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved_stdout < 0 || null_fd < 0) {
+        perror("open failed");
+        return 1;
+    }
+    dup2(null_fd, 1);
+    for (int i = 0; i < count; i++) {
+        handles[i] = my_dlopen(i < copies ? argv[1] : argv[2]);
+        if (!handles[i]) {
+            fflush(stdout);
+            dup2(saved_stdout, 1);
+            fprintf(stderr, "load %d failed\n", i);
+            return 1;
+        }
+    }
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+
+    printf("%d handles (%d x %s, 1 x %s)\n", count, copies, argv[1], argv[2]);
+    run_lookups("first handle", "fn_1000", handles, count, rounds);
+    run_lookups("last handle", "foo_exported", handles, count, rounds);
+    run_lookups("miss", "no_such_symbol", handles, count, rounds);
+    fflush(stdout);
+
+    for (int i = 0; i < count; i++) {
+        my_dlclose(handles[i]);
+    }
+    close(null_fd);
+    close(saved_stdout);
+    free(handles);
+    return 0;
+}
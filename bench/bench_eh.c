@@ -0,0 +1,137 @@
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include "dynloader.h"
+#include "debug.h"
+
+/*
+ * Débit d'exceptions C++ à travers des bibliothèques chargées :
+ * eh_catch() de libehcatch.so appelle eh_throw() de libehthrow.so, qui
+ * empile DEPTH cadres puis lance ; chaque lancer déroule les deux images.
+ * Les deux bibliothèques sont chargées par dlopen() (référence : tables
+ * trouvées par le _dl_find_object() de la libc), puis par my_dlopen()
+ * (tables enregistrées par __register_frame_info_bases(), cherchées par
+ * libgcc sous son mutex global). Chaque mode tourne sur 1 puis THREADS
+ * threads.
+ *
+ * usage: bench_eh ./bench/lib/libehthrow.so ./bench/lib/libehcatch.so [THROWS] [THREADS] [DEPTH]
+ */
+
+#define DEFAULT_THROWS 200000
+#define DEFAULT_THREADS 4
+#define DEFAULT_DEPTH 8
+
+typedef long (*eh_catch_fn)(long, long, long *);
+
+typedef struct {
+    eh_catch_fn fn;
+    long throws;
+    long depth;
+    long unwound;
+    long errors;
+} worker_arg;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void *worker(void *arg) {
+    worker_arg *w = arg;
+    for (long i = 0; i < w->throws; i++) {
+        if (w->fn(w->depth, i, &w->unwound) != i) {
+            w->errors++;
+        }
+    }
+    return NULL;
+}
+
+// ns par lancer rattrapé, -1 si un résultat est faux
+static double run(eh_catch_fn fn, int threads, long throws, long depth) {
+    pthread_t tids[threads];
+    worker_arg args[threads];
+    uint64_t start = now_ns();
+    for (int t = 0; t < threads; t++) {
+        args[t] = (worker_arg){fn, throws / threads, depth, 0, 0};
+        pthread_create(&tids[t], NULL, worker, &args[t]);
+    }
+    long errors = 0;
+    long unwound = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+        errors += args[t].errors;
+        unwound += args[t].unwound;
+    }
+    uint64_t elapsed = now_ns() - start;
+    long done = throws / threads * threads;
+    if (errors || unwound != done * (depth + 1)) {
+        return -1;
+    }
+    return (double) elapsed / done;
+}
+
+static int measure(const char *label, eh_catch_fn fn, int threads, long throws, long depth) {
+    int counts[2] = {1, threads};
+    for (int k = 0; k < (threads > 1 ? 2 : 1); k++) {
+        double ns = run(fn, counts[k], throws, depth);
+        if (ns < 0) {
+            fprintf(stderr, "%s: wrong results\n", label);
+            return -1;
+        }
+        printf("%-9s %3d thread(s): %8.1f ns/throw  %10.0f throws/s\n", label, counts[k], ns,
+               1e9 / ns);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s THROWER CATCHER [THROWS] [THREADS] [DEPTH]\n", argv[0]);
+        return 1;
+    }
+    long throws = argc > 3 ? atol(argv[3]) : DEFAULT_THROWS;
+    int threads = argc > 4 ? atoi(argv[4]) : DEFAULT_THREADS;
+    long depth = argc > 5 ? atol(argv[5]) : DEFAULT_DEPTH;
+    if (throws <= 0 || threads <= 0 || threads > 256 || depth < 0) {
+        fprintf(stderr, "invalid THROWS/THREADS/DEPTH\n");
+        return 1;
+    }
+    debug_init(DBG_NONE);
+
+    // Runtime C++ des deux bibliothèques (my_dlopen() ne charge pas les DT_NEEDED)
+    if (!dlopen("libstdc++.so.6", RTLD_NOW | RTLD_GLOBAL)) {
+        fprintf(stderr, "%s\n", dlerror());
+        return 1;
+    }
+    printf("%s, %ld throws, depth %ld\n", argv[2], throws, depth);
+
+    void *thrower = dlopen(argv[1], RTLD_NOW | RTLD_GLOBAL);
+    void *catcher = thrower ? dlopen(argv[2], RTLD_NOW) : NULL;
+    eh_catch_fn fn = catcher ? (eh_catch_fn) dlsym(catcher, "eh_catch") : NULL;
+    if (!fn) {
+        fprintf(stderr, "%s\n", dlerror());
+        return 1;
+    }
+    int status = measure("dlopen", fn, threads, throws, depth);
+    dlclose(catcher);
+    dlclose(thrower);
+
+    void *my_thrower = my_dlopen(argv[1]);
+    void *my_catcher = my_thrower ? my_dlopen(argv[2]) : NULL;
+    fn = my_catcher ? (eh_catch_fn) my_dlsym(my_catcher, "eh_catch") : NULL;
+    if (!fn) {
+        fprintf(stderr, "load failed\n");
+        return 1;
+    }
+    if (measure("my_dlopen", fn, threads, throws, depth) != 0) {
+        status = 1;
+    }
+    my_dlclose(my_catcher);
+    my_dlclose(my_thrower);
+    return status;
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "elf_parser.h"
+#include "debug.h"
+
+/*
+ * Débit du parseur ELF zéro-copie : projection, validation et parcours
+ * de toutes les tables (phdrs, shdrs, dynamique, .dynsym) de chaque
+ * bibliothèque passée en argument.
+ *
+ * usage: bench_elf_parse [ROUNDS] LIBRARY...
+ *        bench_elf_parse 20 /usr/lib/x86_64-linux-gnu/lib*.so*
+ */
+
+#define DEFAULT_ROUNDS 10
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+// Parcourt tout le fichier ; retourne une somme pour éviter l'élimination
+static uint64_t parse_one(const char *path) {
+    elf_file elf;
+    if (elf_open(path, &elf) != 0) {
+        elf_close(&elf);
+        return 0;
+    }
+
+    uint64_t sum = 0;
+    elf_iter it;
+    const elf_phdr *ph;
+    elf_iter_init(&it, &elf);
+    while ((ph = elf_next_phdr(&it)) != NULL) {
+        sum += ph->p_memsz;
+    }
+
+    const char *name;
+    elf_iter_init(&it, &elf);
+    while (elf_next_shdr(&it, &name) != NULL) {
+        sum += name ? (uint8_t) name[0] : 0;
+    }
+
+    elf_iter_init(&it, &elf);
+    while (elf_next_dyn(&it) != NULL) {
+        sum++;
+    }
+
+    elf_iter_init(&it, &elf);
+    while (elf_next_dynsym(&it, &name) != NULL) {
+        sum += name ? (uint8_t) name[0] : 0;
+    }
+
+    elf_close(&elf);
+    return sum + 1;
+}
+
+int main(int argc, char **argv) {
+    int first = 1;
+    int rounds = DEFAULT_ROUNDS;
+    if (argc > 2 && atoi(argv[1]) > 0) {
+        rounds = atoi(argv[1]);
+        first = 2;
+    }
+    if (first >= argc) {
+        fprintf(stderr, "usage: %s [ROUNDS] LIBRARY...\n", argv[0]);
+        return 1;
+    }
+
+    debug_init(DBG_NONE);
+
+    // Premier passage : on ne garde que les bibliothèques valides
+    int count = 0;
+    for (int i = first; i < argc; i++) {
+        if (parse_one(argv[i]) != 0) {
+            argv[first + count++] = argv[i];
+        }
+    }
+    if (count == 0) {
+        fprintf(stderr, "no valid library\n");
+        return 1;
+    }
+
+    uint64_t sum = 0;
+    uint64_t start = now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < count; i++) {
+            sum += parse_one(argv[first + i]);
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    double parsed = (double) rounds * count;
+    printf("libraries            : %d (x%d rounds)\n", count, rounds);
+    printf("time per library     : %.2f us\n", elapsed / parsed / 1000.0);
+    printf("libraries per second : %.0f\n", parsed * 1e9 / elapsed);
+    printf("checksum             : %lu\n", (unsigned long) sum);
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "dynloader.h"
+#include "debug.h"
+#include "bench_perf.h"
+
+/*
+ * Texte en pages normales ou en pages de 2 Mo (LOAD_HUGE_TEXT) : appels
+ * dispersés dans tout le texte de bench/lib/libbigtext.so, coût par appel
+ * et défauts d'iTLB. "make bench-perf" fait la même mesure sous perf stat.
+ *
+ * usage: bench_hugetext ./bench/lib/libbigtext.so [small|huge] [ROUNDS]
+ */
+
+#define DEFAULT_ROUNDS 20000
+#define MAX_FUNCTIONS  512
+// Pas premier avec 512 : l'ordre des appels ne suit pas les adresses
+#define CALL_STRIDE    167
+
+typedef long (*long_fn)(long);
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static int run(const char *path, int flags, int rounds) {
+    // Les messages de chargement ne doivent pas fausser la mesure
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, 1);
+    close(null_fd);
+    void *handle = my_dlopen_flags(path, flags);
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+    close(saved_stdout);
+    if (!handle) {
+        fprintf(stderr, "load failed: %s\n", path);
+        return -1;
+    }
+
+    long_fn fns[MAX_FUNCTIONS];
+    int count = 0;
+    char name[16];
+    for (int i = 0; i < MAX_FUNCTIONS; i++) {
+        snprintf(name, sizeof(name), "fn_1%03o", i);
+        long_fn fn = (long_fn) my_dlsym(handle, name);
+        if (fn) {
+            fns[count++] = fn;
+        }
+    }
+    if (count == 0) {
+        fprintf(stderr, "no fn_* symbol in %s\n", path);
+        my_dlclose(handle);
+        return -1;
+    }
+
+    // Échauffement : toutes les pages présentes avant la mesure
+    long sink = 0;
+    for (int i = 0; i < count; i++) {
+        sink += fns[i](i);
+    }
+
+    int counter = itlb_counter_open();
+    itlb_counter_start(counter);
+    uint64_t start = now_ns();
+    int next = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < count; i++) {
+            sink += fns[next](r);
+            next = (next + CALL_STRIDE) % count;
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+    uint64_t misses = itlb_counter_stop(counter);
+
+    const load_stats_t *stats = my_dlloadstats(handle);
+    uint64_t calls = (uint64_t) rounds * count;
+    printf("%-6s text=%zu KiB huge=%zu KiB  %6.2f ns/call", flags ? "huge" : "small",
+           stats->text_size >> 10, stats->text_huge_size >> 10,
+           (double) elapsed / (double) calls);
+    if (counter >= 0) {
+        printf("  iTLB misses/1k calls=%7.2f", 1000.0 * (double) misses / (double) calls);
+    } else {
+        printf("  iTLB misses: n/a");
+    }
+    printf("  (checksum %ld)\n", sink);
+
+    my_dlclose(handle);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s LIBRARY_PATH [small|huge] [ROUNDS]\n", argv[0]);
+        return 1;
+    }
+    const char *mode = argc > 2 ? argv[2] : "both";
+    int rounds = argc > 3 ? atoi(argv[3]) : DEFAULT_ROUNDS;
+    debug_init(DBG_NONE);
+
+    int status = 0;
+    if (strcmp(mode, "huge") != 0) {
+        status |= run(argv[1], 0, rounds);
+    }
+    if (strcmp(mode, "small") != 0) {
+        status |= run(argv[1], LOAD_HUGE_TEXT, rounds);
+    }
+    return status ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include "dynloader.h"
+#include "debug.h"
+
+/*
+ * Bibliothèque ordinaire (.plt/.got.plt de l'éditeur de liens) chargée par
+ * my_dlopen() puis par dlopen(RTLD_LAZY) de la glibc. Pour chaque cycle
+ * ouverture / premier appel / fermeture on mesure le temps d'ouverture, le
+ * premier appel de plain_call() (liaison paresseuse de plain_hook via
+ * GOT[2]) puis le coût d'un appel une fois le slot lié.
+ *
+ * usage: bench_lazyplt ./bench/lib/libplain.so [CYCLES] [CALLS]
+ */
+
+#define DEFAULT_CYCLES 200
+#define DEFAULT_CALLS 1000000
+
+typedef long (*plain_call_fn)(long);
+
+// Import de libplain.so, résolu dans l'exécutable (-rdynamic)
+__attribute__((noinline)) long plain_hook(long x) {
+    return x * 2;
+}
+
+typedef struct {
+    uint64_t open_ns;
+    uint64_t first_ns;
+    uint64_t steady_ns;
+} lazy_result;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static int measure_calls(plain_call_fn fn, long calls, lazy_result *res) {
+    uint64_t start = now_ns();
+    long first = fn(1);
+    res->first_ns += now_ns() - start;
+    if (first != 3) {
+        fprintf(stderr, "unexpected result: %ld\n", first);
+        return -1;
+    }
+
+    long sum = 0;
+    start = now_ns();
+    for (long i = 0; i < calls; i++) {
+        sum += fn(i);
+    }
+    res->steady_ns += now_ns() - start;
+    // Évite que la boucle soit éliminée
+    if (sum == 42) {
+        printf("\n");
+    }
+    return 0;
+}
+
+static int run_isos(const char *path, int cycles, long calls, lazy_result *res) {
+    for (int c = 0; c < cycles; c++) {
+        uint64_t start = now_ns();
+        void *handle = my_dlopen(path);
+        res->open_ns += now_ns() - start;
+        if (!handle) {
+            return -1;
+        }
+        plain_call_fn fn = (plain_call_fn) my_dlsym(handle, "plain_call");
+        if (!fn || measure_calls(fn, calls / cycles, res) != 0) {
+            my_dlclose(handle);
+            return -1;
+        }
+        my_dlclose(handle);
+    }
+    return 0;
+}
+
+static int run_glibc(const char *path, int cycles, long calls, lazy_result *res) {
+    for (int c = 0; c < cycles; c++) {
+        uint64_t start = now_ns();
+        void *handle = dlopen(path, RTLD_LAZY | RTLD_LOCAL);
+        res->open_ns += now_ns() - start;
+        if (!handle) {
+            fprintf(stderr, "dlopen: %s\n", dlerror());
+            return -1;
+        }
+        plain_call_fn fn = (plain_call_fn) dlsym(handle, "plain_call");
+        if (!fn || measure_calls(fn, calls / cycles, res) != 0) {
+            dlclose(handle);
+            return -1;
+        }
+        dlclose(handle);
+    }
+    return 0;
+}
+
+static void print_result(const char *label, const lazy_result *res, int cycles, long calls) {
+    long per_cycle = calls / cycles;
+    printf("%-8s open=%8.1f us  first call=%8.1f ns  steady=%5.2f ns/call\n", label,
+           (double) res->open_ns / cycles / 1000.0, (double) res->first_ns / cycles,
+           (double) res->steady_ns / ((double) per_cycle * cycles));
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s LIBRARY [CYCLES] [CALLS]\n", argv[0]);
+        return 1;
+    }
+    int cycles = argc > 2 ? atoi(argv[2]) : DEFAULT_CYCLES;
+    long calls = argc > 3 ? atol(argv[3]) : DEFAULT_CALLS;
+    if (cycles <= 0 || calls < cycles) {
+        fprintf(stderr, "invalid CYCLES/CALLS\n");
+        return 1;
+    }
+    debug_init(DBG_NONE);
+
+    // Les messages de chargement ne doivent pas fausser la mesure
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved_stdout < 0 || null_fd < 0) {
+        perror("open failed");
+        return 1;
+    }
+
+    lazy_result isos = {0}, glibc = {0};
+    dup2(null_fd, 1);
+    int rc = run_isos(argv[1], cycles, calls, &isos);
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+    if (rc != 0) {
+        fprintf(stderr, "my_dlopen run failed\n");
+        return 1;
+    }
+    if (run_glibc(argv[1], cycles, calls, &glibc) != 0) {
+        return 1;
+    }
+
+    printf("%s, %d cycles, %ld calls\n", argv[1], cycles, calls);
+    print_result("isos", &isos, cycles, calls);
+    print_result("glibc", &glibc, cycles, calls);
+    fflush(stdout);
+
+    close(null_fd);
+    close(saved_stdout);
+    return 0;
+}
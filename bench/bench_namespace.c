@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "dynloader.h"
+#include "debug.h"
+
+/*
+ * Coût d'une instance supplémentaire d'une même bibliothèque : COUNT
+ * my_dlopen() contre COUNT my_dlmopen() dans autant d'espaces. Chaque
+ * instance est ensuite lue en entier (toutes ses pages résidentes). On
+ * mesure par instance le temps de chargement, les pages privées du
+ * processus et l'engagement mémoire (Committed_AS) ; la taille des segments
+ * inscriptibles sert de référence.
+ *
+ * usage: bench_namespace LIBRARY [COUNT]
+ */
+
+#define DEFAULT_COUNT 16
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+// Pages propres au processus (Private_Clean + Private_Dirty), en octets.
+// La RSS compterait une fois par projection les pages partagées du texte.
+static long private_bytes(void) {
+    char line[128];
+    long kib, total = 0;
+    FILE *f = fopen("/proc/self/smaps_rollup", "r");
+    if (!f) {
+        return 0;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "Private_Clean: %ld kB", &kib) == 1 ||
+            sscanf(line, "Private_Dirty: %ld kB", &kib) == 1) {
+            total += kib;
+        }
+    }
+    fclose(f);
+    return total * 1024;
+}
+
+// Mémoire engagée par le système (Committed_AS), en octets
+static long committed_bytes(void) {
+    char line[128];
+    long kib = 0;
+    FILE *f = fopen("/proc/meminfo", "r");
+    if (!f) {
+        return 0;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "Committed_AS: %ld kB", &kib) == 1) {
+            break;
+        }
+    }
+    fclose(f);
+    return kib * 1024;
+}
+
+// Rend toutes les pages de l'image résidentes, en lecture
+static void touch_image(lib_handle_t *lib) {
+    size_t page_size = getpagesize();
+    for (int i = 0; i < lib->range_count; i++) {
+        const volatile char *p = lib->ranges[i].start;
+        for (size_t off = 0; off < lib->ranges[i].size; off += page_size) {
+            (void) p[off];
+        }
+    }
+}
+
+static size_t writable_bytes(lib_handle_t *lib) {
+    size_t total = 0;
+    for (int i = 0; i < lib->range_count; i++) {
+        if (lib->ranges[i].flags & PF_W) {
+            total += lib->ranges[i].size;
+        }
+    }
+    return total;
+}
+
+static int run(const char *label, const char *path, int count, int isolated) {
+    void **spaces = calloc(count, sizeof(void *));
+    void **handles = calloc(count, sizeof(void *));
+    if (!spaces || !handles) {
+        perror("calloc failed");
+        return -1;
+    }
+
+    // Les messages de chargement ne doivent pas fausser la mesure
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, 1);
+
+    // Deux instances hors mesure : cache de pages et verdict ELF chauds, et
+    // pages du fichier déjà partagées (une page projetée une seule fois
+    // compterait comme privée jusqu'à l'arrivée de la deuxième instance)
+    void *warm[2];
+    for (int i = 0; i < 2; i++) {
+        warm[i] = my_dlopen(path);
+        if (warm[i]) {
+            touch_image(warm[i]);
+        }
+    }
+
+    long private_before = private_bytes();
+    long commit_before = committed_bytes();
+    uint64_t load_ns = 0;
+    int loaded = 0;
+    for (; loaded < count; loaded++) {
+        uint64_t start = now_ns();
+        if (isolated) {
+            spaces[loaded] = my_dlns_create();
+            handles[loaded] = spaces[loaded] ? my_dlmopen(spaces[loaded], path) : NULL;
+        } else {
+            handles[loaded] = my_dlopen(path);
+        }
+        load_ns += now_ns() - start;
+        if (!handles[loaded]) {
+            break;
+        }
+        touch_image(handles[loaded]);
+    }
+    long private = private_bytes() - private_before;
+    long commit = committed_bytes() - commit_before;
+
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+    close(null_fd);
+    close(saved_stdout);
+
+    int ok = warm[0] && warm[1] && loaded == count;
+    if (ok) {
+        printf("%-11s x%d: load %8.1f us  private %+8.1f KiB  commit %+8.1f KiB  (per "
+               "instance, writable %zu KiB)\n",
+               label, count, (double) load_ns / count / 1000.0, (double) private / count / 1024.0,
+               (double) commit / count / 1024.0, writable_bytes(handles[0]) >> 10);
+    } else {
+        fprintf(stderr, "%s: load %d failed\n", label, loaded);
+    }
+
+    for (int i = 0; i < loaded; i++) {
+        if (isolated) {
+            my_dlns_destroy(spaces[i]);
+        } else {
+            my_dlclose(handles[i]);
+        }
+    }
+    if (isolated && loaded < count && spaces[loaded]) {
+        my_dlns_destroy(spaces[loaded]);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (warm[i]) {
+            my_dlclose(warm[i]);
+        }
+    }
+    free(spaces);
+    free(handles);
+    return ok ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s LIBRARY [COUNT]\n", argv[0]);
+        return 1;
+    }
+    int count = argc > 2 ? atoi(argv[2]) : DEFAULT_COUNT;
+    if (count <= 0) {
+        fprintf(stderr, "invalid COUNT\n");
+        return 1;
+    }
+    debug_init(DBG_NONE);
+
+    printf("%s\n", argv[1]);
+    if (run("my_dlopen", argv[1], count, 0) != 0 || run("my_dlmopen", argv[1], count, 1) != 0) {
+        return 1;
+    }
+    return 0;
+}
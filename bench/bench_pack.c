@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "dynloader.h"
+#include "debug.h"
+#include "bench_perf.h"
+
+/*
+ * Chargement de nombreuses petites bibliothèques, chacune dans sa propre
+ * réservation (my_dlopen) ou toutes dans un pack (my_dlopen_packed) :
+ * nombre de VMA, puis coût d'appels qui passent d'un plugin à l'autre
+ * et défauts d'iTLB correspondants (si perf_event_open est disponible).
+ *
+ * usage: bench_pack ./libmylib.so [COPIES] [ROUNDS]
+ */
+
+#define DEFAULT_COPIES 256
+#define DEFAULT_ROUNDS 2000
+
+typedef const char *(*str_fn)();
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static int count_vmas(void) {
+    FILE *maps = fopen("/proc/self/maps", "r");
+    if (!maps) {
+        return -1;
+    }
+    int count = 0;
+    int c;
+    while ((c = fgetc(maps)) != EOF) {
+        count += c == '\n';
+    }
+    fclose(maps);
+    return count;
+}
+
+// Appels en tourniquet : chaque appel atterrit dans un autre plugin
+static void run_calls(const char *label, str_fn *fns, int copies, int rounds, int vmas) {
+    int counter = itlb_counter_open();
+    itlb_counter_start(counter);
+
+    uint64_t start = now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < copies; i++) {
+            fns[i]();
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    uint64_t misses = itlb_counter_stop(counter);
+
+    uint64_t calls = (uint64_t) rounds * copies;
+    printf("%-10s vmas/lib=%5.2f  %6.2f ns/call", label, (double) vmas / copies,
+           (double) elapsed / (double) calls);
+    if (counter >= 0) {
+        printf("  iTLB misses/1k calls=%7.2f\n", 1000.0 * (double) misses / (double) calls);
+    } else {
+        printf("  iTLB misses: n/a (perf_event_open unavailable)\n");
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s LIBRARY_PATH [COPIES] [ROUNDS]\n", argv[0]);
+        return 1;
+    }
+    const char *path = argv[1];
+    int copies = argc > 2 ? atoi(argv[2]) : DEFAULT_COPIES;
+    int rounds = argc > 3 ? atoi(argv[3]) : DEFAULT_ROUNDS;
+    debug_init(DBG_NONE);
+
+    void **handles = calloc(copies, sizeof(void *));
+    str_fn *fns = calloc(copies, sizeof(str_fn));
+    if (!handles || !fns) {
+        perror("calloc failed");
+        return 1;
+    }
+
+    // Les messages de chargement ne doivent pas fausser la mesure
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved_stdout < 0 || null_fd < 0) {
+        perror("open failed");
+        return 1;
+    }
+
+    for (int packed = 0; packed <= 1; packed++) {
+        dup2(null_fd, 1);
+        void *pack = packed ? my_dlpack_create(0) : NULL;
+        int before = count_vmas();
+        for (int i = 0; i < copies; i++) {
+            handles[i] = packed ? my_dlopen_packed(pack, path) : my_dlopen(path);
+            if (!handles[i]) {
+                fprintf(stderr, "load %d failed\n", i);
+                return 1;
+            }
+            fns[i] = (str_fn) my_dlsym(handles[i], "foo_exported");
+        }
+        int vmas = count_vmas() - before;
+        fflush(stdout);
+        dup2(saved_stdout, 1);
+
+        // Un tour d'échauffement pour que toutes les pages soient présentes
+        for (int i = 0; i < copies; i++) {
+            fns[i]();
+        }
+        run_calls(packed ? "packed" : "separate", fns, copies, rounds, vmas);
+        fflush(stdout);
+
+        for (int i = 0; i < copies; i++) {
+            my_dlclose(handles[i]);
+        }
+        if (pack) {
+            my_dlpack_destroy(pack);
+        }
+    }
+
+    close(null_fd);
+    close(saved_stdout);
+    free(handles);
+    free(fns);
+    return 0;
+}
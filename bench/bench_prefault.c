@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "dynloader.h"
+#include "debug.h"
+
+/*
+ * Politiques de résidence : pour chacune, la bibliothèque est d'abord
+ * chassée du cache de pages, puis un processus fils la charge et suit le
+ * "chemin de démarrage" (une fonction sur STARTUP_STRIDE). On relève le
+ * temps de chargement, le temps de ces premiers appels, les défauts de
+ * page qu'ils prennent et la mémoire résidente de l'image. Le profil
+ * .isosprof est enregistré au préalable sur ce même chemin.
+ *
+ * usage: bench_prefault ./bench/lib/libbigtext.so [STARTUP_STRIDE]
+ */
+
+#define MAX_FUNCTIONS  512
+#define DEFAULT_STRIDE 8
+
+typedef long (*long_fn)(long);
+
+static const struct {
+    const char *name;
+    int flags;
+} policies[] = {
+    {"lazy", 0},
+    {"readahead", LOAD_READAHEAD},
+    {"populate", LOAD_POPULATE},
+    {"lock", LOAD_LOCK},
+    {"profile", LOAD_PROFILE},
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+// Chasse le fichier du cache de pages (aucune projection ne doit subsister)
+static void evict(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+// Charge la bibliothèque sans rien afficher ; NULL en cas d'échec
+static void *load_quiet(const char *path, int flags, uint64_t *load_ns) {
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, 1);
+    close(null_fd);
+    uint64_t start = now_ns();
+    void *handle = my_dlopen_flags(path, flags);
+    *load_ns = now_ns() - start;
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+    close(saved_stdout);
+    if (!handle) {
+        fprintf(stderr, "load failed: %s\n", path);
+    }
+    return handle;
+}
+
+// Fonctions du chemin de démarrage : une sur stride, réparties dans tout le texte
+static int startup_functions(void *handle, int stride, long_fn *fns) {
+    int count = 0;
+    char sym[16];
+    for (int i = 0; i < MAX_FUNCTIONS; i += stride) {
+        snprintf(sym, sizeof(sym), "fn_1%03o", i);
+        long_fn fn = (long_fn) my_dlsym(handle, sym);
+        if (fn) {
+            fns[count++] = fn;
+        }
+    }
+    return count;
+}
+
+static int record_profile(const char *path, int stride) {
+    uint64_t load_ns;
+    void *handle = load_quiet(path, 0, &load_ns);
+    if (!handle) {
+        return 1;
+    }
+    long_fn fns[MAX_FUNCTIONS];
+    int count = startup_functions(handle, stride, fns);
+    long sink = 0;
+    for (int i = 0; i < count; i++) {
+        sink += fns[i](i);
+    }
+    int pages = isosprof_write(path, handle);
+    printf("profile: %d pages recorded after %d startup calls (checksum %ld)\n", pages, count,
+           sink);
+    my_dlclose(handle);
+    return pages < 0;
+}
+
+static int run_policy(const char *path, const char *name, int flags, int stride) {
+    uint64_t load_ns;
+    void *handle = load_quiet(path, flags, &load_ns);
+    if (!handle) {
+        return 1;
+    }
+    long_fn fns[MAX_FUNCTIONS];
+    int count = startup_functions(handle, stride, fns);
+
+    struct rusage before, after;
+    long sink = 0;
+    getrusage(RUSAGE_SELF, &before);
+    uint64_t start = now_ns();
+    for (int i = 0; i < count; i++) {
+        sink += fns[i](i);
+    }
+    uint64_t calls_ns = now_ns() - start;
+    getrusage(RUSAGE_SELF, &after);
+
+    const load_stats_t *stats = my_dlloadstats(handle);
+    printf("%-10s load=%7.2f ms  %d startup calls=%6.2f ms  minflt=%5ld majflt=%4ld  "
+           "rss=%6zu KiB  populated=%6zu KiB locked=%6zu KiB (checksum %ld)\n",
+           name, load_ns / 1e6, count, calls_ns / 1e6, after.ru_minflt - before.ru_minflt,
+           after.ru_majflt - before.ru_majflt, isosprof_resident_bytes(handle) >> 10,
+           stats->populated_size >> 10, stats->locked_size >> 10, sink);
+    my_dlclose(handle);
+    return 0;
+}
+
+// Exécute fn dans un processus neuf, après avoir chassé la bibliothèque du cache
+static int in_child(const char *path, int (*fn)(const char *, const char *, int, int),
+                    const char *name, int flags, int stride) {
+    evict(path);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        int ret = fn(path, name, flags, stride);
+        fflush(stdout);
+        _exit(ret);
+    }
+    int status;
+    return pid < 0 || waitpid(pid, &status, 0) < 0 || status != 0;
+}
+
+static int record_step(const char *path, const char *name, int flags, int stride) {
+    (void) name;
+    (void) flags;
+    return record_profile(path, stride);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s LIBRARY_PATH [STARTUP_STRIDE]\n", argv[0]);
+        return 1;
+    }
+    int stride = argc > 2 ? atoi(argv[2]) : DEFAULT_STRIDE;
+    if (stride < 1) {
+        stride = 1;
+    }
+    debug_init(DBG_NONE);
+
+    int status = in_child(argv[1], record_step, "record", 0, stride);
+    for (size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++) {
+        status |= in_child(argv[1], run_policy, policies[i].name, policies[i].flags, stride);
+    }
+    return status;
+}
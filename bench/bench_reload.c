@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "dynloader.h"
+#include "epoch.h"
+#include "histogram.h"
+#include "debug.h"
+
+/*
+ * Latence des appels pendant des rechargements à chaud répétés : des
+ * threads lecteurs appellent FUNCTION_NAME en boucle (epoch_enter,
+ * my_dlsym, appel, epoch_leave) pendant que le thread principal alterne
+ * entre deux versions de la bibliothèque.
+ *
+ * usage: bench_reload ./libmylib.so ./libmylib_v2.so foo_exported [RELOADS] [THREADS]
+ */
+
+#define DEFAULT_RELOADS  200
+#define DEFAULT_THREADS  2
+#define RELOAD_PERIOD_US 1000
+
+typedef const char *(*str_fn)();
+
+typedef struct {
+    void *handle;
+    const char *func_name;
+    histogram_t hist;
+    uint64_t calls;
+    uint64_t misses;
+} reader_t;
+
+static volatile int running = 1;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void *reader_main(void *arg) {
+    reader_t *reader = arg;
+    hist_init(&reader->hist);
+    while (running) {
+        uint64_t start = now_ns();
+        epoch_enter();
+        str_fn fn = (str_fn) my_dlsym(reader->handle, reader->func_name);
+        if (fn) {
+            fn();
+        } else {
+            reader->misses++;
+        }
+        epoch_leave();
+        hist_record(&reader->hist, now_ns() - start);
+        reader->calls++;
+    }
+    return NULL;
+}
+
+// Nombre de projections issues de path encore présentes dans le processus
+static int count_mappings(const char *path) {
+    const char *name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+    FILE *maps = fopen("/proc/self/maps", "r");
+    if (!maps) {
+        return -1;
+    }
+    char line[512];
+    int count = 0;
+    while (fgets(line, sizeof(line), maps)) {
+        char *file = strrchr(line, '/');
+        if (file && strncmp(file + 1, name, strlen(name)) == 0 && file[1 + strlen(name)] == '\n') {
+            count++;
+        }
+    }
+    fclose(maps);
+    return count;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        fprintf(stderr, "usage: %s LIBRARY_V1 LIBRARY_V2 FUNCTION_NAME [RELOADS] [THREADS]\n",
+                argv[0]);
+        return 1;
+    }
+    const char *paths[2] = {argv[1], argv[2]};
+    int reloads = argc > 4 ? atoi(argv[4]) : DEFAULT_RELOADS;
+    int thread_count = argc > 5 ? atoi(argv[5]) : DEFAULT_THREADS;
+    debug_init(DBG_NONE);
+
+    // Les messages de chargement ne doivent pas fausser la mesure
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved_stdout < 0 || null_fd < 0 || dup2(null_fd, 1) < 0) {
+        perror("stdout redirection failed");
+        return 1;
+    }
+    close(null_fd);
+    void *handle = my_dlopen(paths[0]);
+    if (!handle) {
+        return 1;
+    }
+
+    reader_t *readers = calloc(thread_count, sizeof(reader_t));
+    pthread_t *threads = calloc(thread_count, sizeof(pthread_t));
+    for (int i = 0; i < thread_count; i++) {
+        readers[i].handle = handle;
+        readers[i].func_name = argv[3];
+        pthread_create(&threads[i], NULL, reader_main, &readers[i]);
+    }
+
+    histogram_t reload_hist;
+    hist_init(&reload_hist);
+    int failed = 0;
+    for (int i = 1; i <= reloads; i++) {
+        usleep(RELOAD_PERIOD_US);
+        uint64_t start = now_ns();
+        failed += my_dlreload(handle, paths[i % 2]) != 0;
+        hist_record(&reload_hist, now_ns() - start);
+    }
+
+    running = 0;
+    for (int i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    int pending = epoch_reclaim();
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+    close(saved_stdout);
+
+    histogram_t calls;
+    hist_init(&calls);
+    uint64_t total = 0;
+    uint64_t misses = 0;
+    for (int i = 0; i < thread_count; i++) {
+        hist_merge(&calls, &readers[i].hist);
+        total += readers[i].calls;
+        misses += readers[i].misses;
+    }
+
+    printf("reloads: %d (%d failed), reader threads: %d, calls: %lu, misses: %lu\n",
+           reloads, failed, thread_count, total, misses);
+    printf("call   mean=%8.1f p50=%8lu p99=%8lu p99.9=%8lu max=%8lu ns\n", hist_mean(&calls),
+           hist_percentile(&calls, 50.0), hist_percentile(&calls, 99.0),
+           hist_percentile(&calls, 99.9), calls.max);
+    printf("reload mean=%8.1f p50=%8lu p99=%8lu us\n", hist_mean(&reload_hist) / 1000.0,
+           hist_percentile(&reload_hist, 50.0) / 1000, hist_percentile(&reload_hist, 99.0) / 1000);
+    printf("retired versions pending: %d, mappings left: %d + %d\n", pending,
+           count_mappings(paths[0]), count_mappings(paths[1]));
+
+    my_dlclose(handle);
+    free(readers);
+    free(threads);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <x86intrin.h>
+#include "dynloader.h"
+#include "debug.h"
+#include "loader.h"
+
+/*
+ * Mesure en cycles (rdtsc) du coût d'un appel importé à travers
+ * isos_trampoline, comparé à un appel direct.
+ *
+ * usage: bench_trampoline ./libmylib.so [iterations]
+ */
+
+#define DEFAULT_ITERS 10000000
+
+const char *new_foo() {
+    return "new_foo";
+}
+
+const char *new_bar() {
+    return "new_bar";
+}
+
+const char *new_args(long a, long b, long c, long d, long e, long f, double x) {
+    (void) a; (void) b; (void) c; (void) d; (void) e; (void) f; (void) x;
+    return "new_args";
+}
+
+static symbol_entry resolve_table[] = {
+    {"new_foo", (void *) new_foo},
+    {"new_bar", (void *) new_bar},
+    {"new_args", (void *) new_args},
+    {NULL, NULL}
+};
+
+typedef const char *(*str_fn)(void);
+
+static double cycles_per_call(str_fn fn, long iters) {
+    // Échauffement : lie le slot PLT et remplit les caches
+    for (int i = 0; i < 1000; i++) {
+        fn();
+    }
+    uint64_t start = __rdtsc();
+    for (long i = 0; i < iters; i++) {
+        fn();
+        asm volatile("" ::: "memory");
+    }
+    uint64_t end = __rdtsc();
+    return (double) (end - start) / iters;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s LIBRARY_PATH [ITERATIONS]\n", argv[0]);
+        return 1;
+    }
+    long iters = argc > 2 ? atol(argv[2]) : DEFAULT_ITERS;
+
+    debug_init(DBG_NONE);
+    void *handle = my_dlopen(argv[1]);
+    if (!handle || my_set_plt_resolve(handle, resolve_table) != 0) {
+        fprintf(stderr, "cannot load %s\n", argv[1]);
+        return 1;
+    }
+
+    str_fn exported = (str_fn) my_dlsym(handle, "foo_exported");
+    str_fn imported = (str_fn) my_dlsym(handle, "foo_imported");
+    str_fn args = (str_fn) my_dlsym(handle, "args_imported");
+    if (!exported || !imported || !args) {
+        fprintf(stderr, "missing benchmark symbols in %s\n", argv[1]);
+        return 1;
+    }
+
+    // Premier appel : chemin lent (sauvegarde des registres + résolution)
+    uint64_t start = __rdtsc();
+    args();
+    uint64_t first = __rdtsc() - start;
+
+    double direct = cycles_per_call(exported, iters);
+    double via_plt = cycles_per_call(imported, iters);
+    double via_plt_args = cycles_per_call(args, iters);
+
+    printf("first call (bind)        : %lu cycles\n", (unsigned long) first);
+    printf("direct call              : %.2f cycles/call\n", direct);
+    printf("import via trampoline    : %.2f cycles/call\n", via_plt);
+    printf("import with 7 arguments  : %.2f cycles/call\n", via_plt_args);
+    printf("trampoline overhead      : %.2f cycles/call\n", via_plt - direct);
+    return 0;
+}
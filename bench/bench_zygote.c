@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <spawn.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "zygote.h"
+#include "histogram.h"
+#include "debug.h"
+
+/*
+ * Latence par requête : invocation à froid de isos_loader (exec, chargement,
+ * relogement, liaison, appel) contre requête au zygote (fork + appel).
+ *
+ * usage: bench_zygote ./isos_loader ./libmylib.so foo_imported [REQUESTS]
+ */
+
+#define DEFAULT_REQUESTS 200
+#define SOCKET_PATH_FMT  "/tmp/isos_bench_%d.sock"
+
+extern char **environ;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+// Lance argv avec stdout/stderr vers /dev/null
+static pid_t spawn_quiet(char **argv) {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+
+    pid_t pid;
+    int ret = posix_spawn(&pid, argv[0], &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    return ret == 0 ? pid : -1;
+}
+
+static void print_result(const char *label, const histogram_t *hist) {
+    printf("%-22s mean=%9.1f p50=%9.1f p99=%9.1f us/request\n", label,
+           hist_mean(hist) / 1000.0, hist_percentile(hist, 50.0) / 1000.0,
+           hist_percentile(hist, 99.0) / 1000.0);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        fprintf(stderr, "usage: %s LOADER LIBRARY_PATH FUNCTION_NAME [REQUESTS]\n", argv[0]);
+        return 1;
+    }
+    char *loader = argv[1];
+    char *lib_path = argv[2];
+    char *func_name = argv[3];
+    int requests = argc > 4 ? atoi(argv[4]) : DEFAULT_REQUESTS;
+    debug_init(DBG_NONE);
+
+    char socket_path[64];
+    snprintf(socket_path, sizeof(socket_path), SOCKET_PATH_FMT, (int) getpid());
+
+    // Démarrage du zygote et attente de sa socket
+    char *serve_argv[] = {loader, "--serve", socket_path, lib_path, NULL};
+    pid_t server = spawn_quiet(serve_argv);
+    if (server < 0) {
+        perror("spawn server failed");
+        return 1;
+    }
+    char reply[ZYGOTE_MAX_REQUEST];
+    int ready = 0;
+    for (int i = 0; i < 500 && !ready; i++) {
+        usleep(10000);
+        ready = access(socket_path, F_OK) == 0 &&
+                zygote_request(socket_path, lib_path, func_name, reply, sizeof(reply)) == 0;
+    }
+    if (!ready) {
+        fprintf(stderr, "server did not start\n");
+        kill(server, SIGTERM);
+        return 1;
+    }
+
+    histogram_t cold;
+    histogram_t warm;
+    hist_init(&cold);
+    hist_init(&warm);
+
+    char *cold_argv[] = {loader, lib_path, func_name, NULL};
+    for (int i = 0; i < requests; i++) {
+        uint64_t start = now_ns();
+        pid_t pid = spawn_quiet(cold_argv);
+        int status;
+        if (pid < 0 || waitpid(pid, &status, 0) < 0) {
+            perror("cold invocation failed");
+            break;
+        }
+        hist_record(&cold, now_ns() - start);
+    }
+
+    for (int i = 0; i < requests; i++) {
+        uint64_t start = now_ns();
+        if (zygote_request(socket_path, lib_path, func_name, reply, sizeof(reply)) != 0) {
+            fprintf(stderr, "request failed: %s\n", reply);
+            break;
+        }
+        hist_record(&warm, now_ns() - start);
+    }
+
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+
+    printf("requests: %d, last reply: %s\n", requests, reply);
+    print_result("cold isos_loader", &cold);
+    print_result("zygote (fork + call)", &warm);
+    return 0;
+}
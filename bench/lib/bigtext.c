@@ -0,0 +1,45 @@
+#include <stddef.h>
+#include "loader.h"
+#include "isos-support.h"
+
+/*
+ * Bibliothèque de test au texte volumineux : 512 fonctions séparées par
+ * BIGTEXT_STRIDE octets de remplissage, soit environ 16 Mo de texte.
+ * Appeler toutes les fonctions touche une page de 4 Ko différente à
+ * chaque appel, mais seulement 8 pages de 2 Mo.
+ */
+
+#define BIGTEXT_STRIDE 32768
+
+void *loader_handle = NULL;
+void *isos_trampoline = NULL;
+
+#define DEFINE_FN(n)                                                            \
+    static long fn_##n(long x) {                                                \
+        __asm__ volatile("jmp 1f\n.skip " XSTR(BIGTEXT_STRIDE) ", 0xcc\n1:");  \
+        return x + n;                                                           \
+    }
+#define EXPORT_FN(n) {"fn_" #n, (void *) fn_##n},
+
+// 8 x 8 x 8 fonctions, nommées fn_1000 à fn_1777
+#define REP8(M, p)   M(p##0) M(p##1) M(p##2) M(p##3) M(p##4) M(p##5) M(p##6) M(p##7)
+#define REP64(M, p)  REP8(M, p##0) REP8(M, p##1) REP8(M, p##2) REP8(M, p##3) \
+                     REP8(M, p##4) REP8(M, p##5) REP8(M, p##6) REP8(M, p##7)
+#define REP512(M, p) REP64(M, p##0) REP64(M, p##1) REP64(M, p##2) REP64(M, p##3) \
+                     REP64(M, p##4) REP64(M, p##5) REP64(M, p##6) REP64(M, p##7)
+
+REP512(DEFINE_FN, 1)
+
+const char *imported_symbols[] = {NULL};
+
+symbol_entry exported_symbols[] = {
+    REP512(EXPORT_FN, 1)
+    {NULL, NULL}
+};
+
+loader_info_t loader_info = {
+    .exported_symbols = exported_symbols,
+    .imported_symbols = imported_symbols,
+    .loader_handle = &loader_handle,
+    .isos_trampoline = &isos_trampoline
+};
@@ -0,0 +1,15 @@
+#ifndef EH_PLUGIN_H
+#define EH_PLUGIN_H
+
+// Exception lancée par libehthrow.so et rattrapée par libehcatch.so
+struct plugin_error {
+    long code;
+};
+
+extern "C" {
+// *unwound compte les cadres détruits pendant le déroulement
+long eh_throw(long depth, long value, long *unwound);
+long eh_catch(long depth, long value, long *unwound);
+}
+
+#endif
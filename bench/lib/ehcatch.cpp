@@ -0,0 +1,14 @@
+#include "eh_plugin.h"
+
+/*
+ * Rattrape l'exception de libehthrow.so : lancer et rattraper se font
+ * dans deux images chargées, la typeinfo est comparée par son nom.
+ */
+
+extern "C" long eh_catch(long depth, long value, long *unwound) {
+    try {
+        return eh_throw(depth, value, unwound);
+    } catch (const plugin_error &e) {
+        return e.code;
+    }
+}
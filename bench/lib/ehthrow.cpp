@@ -0,0 +1,25 @@
+#include "eh_plugin.h"
+
+/*
+ * Lanceur d'exceptions : eh_throw() empile depth cadres, chacun avec un
+ * objet à détruire, puis lance plugin_error. Le déroulement traverse
+ * donc les tables de cette image (FDE et landing pads) avant d'atteindre
+ * celles de l'appelant.
+ */
+
+namespace {
+struct frame_guard {
+    long *unwound;
+    ~frame_guard() {
+        (*unwound)++;
+    }
+};
+}
+
+extern "C" __attribute__((noinline)) long eh_throw(long depth, long value, long *unwound) {
+    frame_guard guard{unwound};
+    if (depth > 0) {
+        return eh_throw(depth - 1, value, unwound) + 1;
+    }
+    throw plugin_error{value};
+}
@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Bibliothèque ordinaire, compilée sans rien de propre au loader : ni
+ * loader_info ni PLT maison. Ses appels externes passent par la .plt et
+ * la .got.plt produites par l'éditeur de liens (relocations JUMP_SLOT),
+ * liées au premier appel.
+ */
+
+// Fournies par l'hôte (table de my_set_plt_resolve())
+const char *new_foo(void);
+const char *new_bar(void);
+// Fournie par le programme de mesure, exporté (-rdynamic)
+long plain_hook(long x);
+
+static char buffer[128];
+
+const char *plain_hello(void) {
+    snprintf(buffer, sizeof(buffer), "Hello from plain_hello() via %s", new_foo());
+    return buffer;
+}
+
+const char *plain_length(void) {
+    snprintf(buffer, sizeof(buffer), "strlen(new_bar()) = %zu", strlen(new_bar()));
+    return buffer;
+}
+
+// Un seul import par appel, pour mesurer le coût d'un appel lié
+long plain_call(long x) {
+    return plain_hook(x) + 1;
+}
+
+// État propre à chaque instance (données privées d'un espace de noms)
+static int counter;
+
+const char *plain_counter(void) {
+    snprintf(buffer, sizeof(buffer), "counter = %d", ++counter);
+    return buffer;
+}
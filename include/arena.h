@@ -0,0 +1,37 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Réservation par défaut : les pages non touchées ne coûtent rien
+#define ARENA_DEFAULT_RESERVE (1u << 20)
+#define ARENA_ALIGN           16
+
+/*
+ * Allocateur linéaire (bump) adossé à une seule projection anonyme.
+ * Toutes les métadonnées d'une bibliothèque y sont placées : elles sont
+ * libérées d'un coup par arena_destroy(). La mémoire rendue est à zéro.
+ */
+typedef struct arena {
+    unsigned char* base;
+    size_t size;
+    size_t used;
+    struct arena* next;     // projection supplémentaire si la première déborde
+} arena_t;
+
+// Position dans une arène, pour rendre ce qui a été alloué depuis (arena_rewind())
+typedef struct {
+    arena_t* chunk;
+    size_t used;
+} arena_mark_t;
+
+arena_t* arena_create(size_t reserve);
+void* arena_alloc(arena_t* arena, size_t size);
+void* arena_calloc(arena_t* arena, size_t count, size_t size);
+void* arena_memdup(arena_t* arena, const void* src, size_t size);
+size_t arena_used(const arena_t* arena);
+arena_mark_t arena_mark(arena_t* arena);
+void arena_rewind(arena_t* arena, arena_mark_t mark);
+void arena_destroy(arena_t* arena);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef ASYNC_LOAD_H
+#define ASYNC_LOAD_H
+
+#include <stdint.h>
+
+/*
+ * Chargement asynchrone : un thread du loader possède un anneau io_uring.
+ * Pour chaque requête il soumet l'ouverture du fichier, la lecture de
+ * l'en-tête ELF puis la lecture anticipée (WILLNEED) des segments et de
+ * la table des sections ; les E/S de toutes les requêtes en vol se
+ * recouvrent. La projection et les relocations se font ensuite sur ce
+ * même thread. Sans io_uring (noyau ancien, seccomp...), le thread fait
+ * les mêmes E/S de façon synchrone : l'appelant n'est jamais bloqué.
+ */
+
+// Octets lus au début du fichier : en-tête ELF et program headers
+#define ASYNC_HEADER_SIZE       4096
+// Plages de lecture anticipée par requête (segments PT_LOAD, sections)
+#define ASYNC_MAX_READAHEAD     16
+#define ASYNC_RING_ENTRIES      64
+
+// Fin du chargement, sur le thread du loader ; fd est cédé
+typedef void* (*async_finish_fn)(int fd, const char* path, int flags);
+
+typedef struct {
+    uint64_t offset;
+    uint64_t len;
+} async_range;
+
+typedef struct dl_async {
+    char* path;
+    int flags;
+    async_finish_fn finish;
+    // État de la requête (thread du loader seulement)
+    int state;
+    int pending;
+    int fd;
+    unsigned char header[ASYNC_HEADER_SIZE];
+    async_range readahead[ASYNC_MAX_READAHEAD];
+    int readahead_count;
+    struct dl_async* next;
+    // Requêtes confiées à l'anneau, jusqu'à leur fin
+    struct dl_async* inflight_next;
+    // Résultat, publié par done puis signalé sur done_fd (eventfd)
+    void* handle;
+    int done;
+    int done_fd;
+} dl_async_t;
+
+dl_async_t* async_load_start(const char* path, int flags, async_finish_fn finish);
+int async_load_done(dl_async_t* req);
+void* async_load_wait(dl_async_t* req);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "arena.h"
+
+/*
+ * Filtre de Bloom par blocs sur les noms exportés d'un handle : les deux
+ * bits d'un nom tombent dans le même mot de 64 bits, donc un test ne lit
+ * qu'une ligne de cache. Environ 16 bits par symbole (~1,5 % de faux
+ * positifs). Les hachages sont ceux de isosidx_hash().
+ */
+typedef struct {
+    uint64_t* words;
+    uint32_t mask;          // nombre de mots - 1 (puissance de deux)
+} bloom_t;
+
+#define BLOOM_BITS_PER_SYMBOL 16
+
+int bloom_init(bloom_t* bloom, arena_t* arena, size_t count);
+void bloom_add(bloom_t* bloom, uint32_t hash);
+int bloom_maybe(const bloom_t* bloom, uint32_t hash);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef CALLSTATS_H
+#define CALLSTATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "isosloader.h"
+
+/*
+ * Profil des appels d'imports (LOAD_CALLSTATS).
+ *
+ * Chaque import d'une image profilée a un stub : "mov $entrée, %r11 ;
+ * jmp isos_call_count". À la liaison, plt_bound[sym_id] (PLT du loader)
+ * ou le slot de la GOT (PLT standard) reçoit l'adresse du stub au lieu
+ * de celle de la cible ; sans LOAD_CALLSTATS rien ne change sur le
+ * chemin d'appel.
+ *
+ * isos_call_count incrémente le compteur de l'import dans le bloc du
+ * thread courant (une ligne de cache par import, jamais partagée entre
+ * threads) puis saute sur la cible. Tous les callstats_period appels, le
+ * chemin lent chronomètre l'appel : l'adresse de retour est déviée vers
+ * isos_call_return et mise de côté sur une pile propre au thread.
+ */
+
+// Lignes par bloc de thread : imports profilés en même temps, toutes images confondues
+#define CALLSTATS_MAX_SLOTS     16384
+#define CALLSTATS_STUB_SIZE     32
+// Appels chronométrés imbriqués par thread
+#define CALLSTATS_MAX_DEPTH     64
+#define CALLSTATS_DEFAULT_PERIOD 128
+// Sans chronométrage, le chemin lent relit la période de temps en temps
+#define CALLSTATS_IDLE_PERIOD   (1u << 20)
+
+// Compteurs d'un import pour un thread ; offsets utilisés par isos_call_count (asm)
+#define CALLSTATS_CALLS_OFF     0
+#define CALLSTATS_COUNTDOWN_OFF 8
+
+typedef struct {
+    uint64_t calls;
+    uint32_t countdown;     // appels avant le prochain chronométrage
+    uint32_t pad;
+    uint64_t samples;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+} __attribute__((aligned(64))) callstats_line;
+
+// Lu par un stub dans %r11 : cible liée et offset de la ligne dans un bloc
+#define CALLSTATS_TARGET_OFF    0
+#define CALLSTATS_LINE_OFF      8
+
+typedef struct {
+    void* target;
+    uint64_t line_offset;
+    // Compté mais jamais chronométré (imports qui reviennent deux fois)
+    int count_only;
+} callstats_entry;
+
+typedef struct callstats {
+    int count;
+    uint32_t first_slot;
+    callstats_entry* entries;
+    unsigned char* stubs;
+    size_t stubs_size;
+} callstats_t;
+
+// Bloc du thread courant (NULL avant son premier appel profilé)
+extern __thread callstats_line* isos_callstats_lines __attribute__((tls_model("initial-exec")));
+
+callstats_t* callstats_create(int count);
+void* callstats_bind(callstats_t* cs, int id, void* target);
+void callstats_set_count_only(callstats_t* cs, int id);
+int callstats_returns_twice(const char* name);
+int callstats_collect(const callstats_t* cs, int id, import_stats_t* out);
+void callstats_destroy(callstats_t* cs);
+void callstats_set_period(uint32_t period);
+
+// Chemin lent des stubs et retour d'un appel chronométré (appelés depuis l'asm)
+void* callstats_slow(callstats_entry* entry, void** return_slot);
+void* callstats_return(void** return_slot);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <stdint.h>
+
+// Capacités CPU transmises aux résolveurs IFUNC des bibliothèques
+#define ISOS_CPU_SSE42    (1u << 0)
+#define ISOS_CPU_AVX      (1u << 1)
+#define ISOS_CPU_AVX2     (1u << 2)
+#define ISOS_CPU_FMA      (1u << 3)
+#define ISOS_CPU_BMI2     (1u << 4)
+#define ISOS_CPU_AVX512F  (1u << 5)
+#define ISOS_CPU_AVX512BW (1u << 6)
+#define ISOS_CPU_AVX512VL (1u << 7)
+
+typedef struct {
+    uint32_t size;      // sizeof(isos_cpu_features_t), pour les évolutions
+    uint32_t flags;     // combinaison de ISOS_CPU_*
+} isos_cpu_features_t;
+
+// Signature d'un résolveur IFUNC appelé par le loader
+typedef void* (*isos_ifunc_resolver_t)(const isos_cpu_features_t* features);
+
+const isos_cpu_features_t* isos_cpu_features(void);
+
+// État étendu (XSAVE, masque ISOS_XSAVE_MASK) sauvé par les trampolines
+#define ISOS_XSAVE_MASK   0xee
+#define ISOS_FXSAVE_SIZE  512
+
+// Taille de la zone XSAVE (CPUID 0xD, multiple de 64), 0 sans XSAVE : FXSAVE
+extern uint32_t isos_xsave_size __attribute__((visibility("hidden")));
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * CRC32C (Castagnoli, polynôme réfléchi 0x82F63B78), celui de
+ * l'instruction SSE4.2 crc32 : instruction matérielle si le CPU l'a
+ * (isos_cpu_features()), table de 8 x 256 entrées sinon. crc32c(0, ...)
+ * démarre un calcul ; on peut le poursuivre en repassant le résultat.
+ */
+
+#define CRC32C_POLY 0x82F63B78u
+
+uint32_t crc32c(uint32_t crc, const void* buf, size_t len);
+uint32_t crc32c_sw(uint32_t crc, const void* buf, size_t len);
+uint32_t crc32c_hw(uint32_t crc, const void* buf, size_t len);
+int crc32c_hw_available(void);
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t len2);
+
+#endif
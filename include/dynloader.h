@@ -1,24 +1,94 @@
 #ifndef DYNLOADER_H
 #define DYNLOADER_H
 
+#include <stddef.h>
+#include "isosloader.h"
 #include "elf_parser.h"
 #include "loader.h"
+#include "symbol_index.h"
+#include "page_profile.h"
+#include "arena.h"
+#include "epoch.h"
+#include "pack.h"
+#include "meminfo.h"
+#include "bloom.h"
+#include "namespace.h"
+#include "async_load.h"
+#include "callstats.h"
+#include "eh_frame.h"
 
-void* my_dlopen(const char* library_path);
-void* my_dlsym(void* handle, const char* symbol_name);
-int check_elf(const char* library_path);
-int validate_load_segments(const char* library_path, elf_header* hdr);
+// Offsets de plt_bound et plt_bound_count dans lib_handle_t, utilisés par isos_trampoline (asm)
+#define LIB_HANDLE_PLT_BOUND_OFF 32
+#define LIB_HANDLE_PLT_BOUND_COUNT_OFF 40
 
+// API publique (my_dlopen(), my_dlsym(), ...) : isosloader.h
 
-
-typedef struct {
+typedef struct lib_handle {
     void* base_addr;
     void* plt_resolve_table;
     // Exported symbols table
     const char** imported_symbols;
     symbol_entry* exported_symbols;
+    // Cache des adresses déjà résolues, indexé par sym_id
+    void** plt_bound;
+    int plt_bound_count;
+    // Index des symboles exportés trié par nom (construit à la demande)
+    symbol_entry* sorted_exports;
+    int export_count;
+    // Index .isosidx projeté depuis le disque (map == NULL si absent)
+    isosidx_t sym_index;
+    // Arène contenant le handle et toutes ses métadonnées
+    arena_t* arena;
+    // Disposition des segments de cette bibliothèque (copie dans l'arène)
+    elf_phdr* phdrs;
+    int phnum;
+    // Version servie après my_dlreload() (NULL : ce handle lui-même)
+    struct lib_handle* current;
+    // Pack qui héberge l'image et l'arène (NULL : handle autonome)
+    lib_pack_t* pack;
+    // Options LOAD_* et bilan de load_library_ex() pour cette image
+    int load_flags;
+    load_stats_t load_stats;
+    // Plages projetées de l'image, une par segment PT_LOAD (copie dans l'arène)
+    mapped_range_t* ranges;
+    int range_count;
+    // PLT standard (DT_JMPREL) : tables dans l'image, et entrée PLT
+    // d'origine de chaque slot paresseux (0 sinon) pour en refaire la liaison
+    Elf64_Rela* jmprel;
+    int jmprel_count;
+    const Elf64_Sym* dynsym;
+    const char* dynstr;
+    // Bornes de dynsym et dynstr dans l'image (cf. find_dyn_tables())
+    size_t dynsym_count;
+    size_t dynstr_size;
+    uint64_t* plt_stubs;
+    // Filtre sur les noms exportés, pour my_dlsym_global()
+    bloom_t exports_bloom;
+    // Chaînage des handles ouverts d'un même espace, dans l'ordre de chargement
+    struct lib_handle* next_loaded;
+    struct lib_handle* prev_loaded;
+    // Espace du handle, où sont aussi cherchés ses imports (NULL : espace de base)
+    lib_namespace_t* ns;
+    // Table d'export partagée entre instances (my_dlmopen()), NULL sinon
+    shared_exports_t* shared_exports;
+    // Stubs et compteurs d'appels des imports (LOAD_CALLSTATS), NULL sinon
+    callstats_t* callstats;
+    // Tables de déroulement de l'image (PT_GNU_EH_FRAME) vues par l'unwinder
+    eh_frame_reg_t eh_frame;
+    // Constructeurs et destructeurs dans l'ordre d'appel (copies dans l'arène) ;
+    // initialized : constructeurs passés, les destructeurs restent à appeler
+    elf_init_fn* init_funcs;
+    int init_count;
+    elf_init_fn* fini_funcs;
+    int fini_count;
+    int initialized;
+    // DT_BIND_NOW, DF_BIND_NOW ou DF_1_NOW : imports liés dès le chargement
+    int bind_now;
 } lib_handle_t;
 
-int my_set_plt_resolve(void* handle, void* resolve_table);
+_Static_assert(offsetof(lib_handle_t, plt_bound) == LIB_HANDLE_PLT_BOUND_OFF,
+               "isos_trampoline depends on the plt_bound offset");
+_Static_assert(offsetof(lib_handle_t, plt_bound_count) == LIB_HANDLE_PLT_BOUND_COUNT_OFF,
+               "isos_trampoline depends on the plt_bound_count offset");
 
 #endif
\ No newline at end of file
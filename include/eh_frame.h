@@ -0,0 +1,33 @@
+#ifndef EH_FRAME_H
+#define EH_FRAME_H
+
+#include <stdint.h>
+#include "elf_parser.h"
+
+/*
+ * Tables de déroulement des images chargées (PT_GNU_EH_FRAME), pour
+ * qu'une exception C++ traverse le code d'une bibliothèque chargée.
+ *
+ * Le .eh_frame de chaque image est enregistré auprès de l'unwinder de
+ * libgcc par __register_frame_info_bases() une fois l'image relocalisée,
+ * et retiré avant son démontage. libgcc trie les FDE d'un objet au
+ * premier lancer qui le traverse, puis y cherche par dichotomie.
+ * L'enregistrement suppose libgcc_s déjà chargé (runtime C++ de l'hôte).
+ */
+
+// Taille réservée pour la struct object de libgcc (6 mots en gcc 12)
+#define EH_FRAME_OBJECT_SIZE 128
+
+typedef struct {
+    uintptr_t start;
+    uintptr_t end;
+    const uint8_t* eh_frame_hdr;
+    // Début de .eh_frame et objet libgcc (NULL : rien d'enregistré)
+    const void* eh_frame;
+    void* object;
+} eh_frame_reg_t;
+
+int eh_frame_register(eh_frame_reg_t* reg, void* base_addr, const elf_phdr* phdrs, int phnum);
+void eh_frame_deregister(eh_frame_reg_t* reg);
+
+#endif
@@ -2,6 +2,8 @@
 #define ELF_PARSER_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include "isosloader.h"
 
 #define ELF_MAGIC0  0x7f
 #define ELF_MAGIC1  'E'
@@ -14,13 +16,64 @@
 
 #define PT_LOAD     1
 #define PT_DYNAMIC  2
+#define PT_NOTE     4
+#define PT_TLS      7
+#define PT_GNU_EH_FRAME 0x6474e550
+
+#define NT_GNU_BUILD_ID 3
 
 #define PF_X        0x1  
 #define PF_W        0x2
 #define PF_R        0x4
 
+#define R_X86_64_64        1
+#define R_X86_64_GLOB_DAT  6
+#define R_X86_64_JUMP_SLOT 7
 #define R_X86_64_RELATIVE 8
+#define R_X86_64_IRELATIVE 37
 #define R_ACCH64_RELATIVE 1027
+#define R_AARCH64_IRELATIVE 1032
+
+#define DT_NULL     0
+#define DT_PLTRELSZ 2
+#define DT_PLTGOT   3
+#define DT_STRTAB   5
+#define DT_SYMTAB   6
+#define DT_RELA     7
+#define DT_RELASZ   8
+#define DT_STRSZ    10
+#define DT_INIT     12
+#define DT_FINI     13
+#define DT_JMPREL   23
+#define DT_BIND_NOW 24
+#define DT_INIT_ARRAY   25
+#define DT_FINI_ARRAY   26
+#define DT_INIT_ARRAYSZ 27
+#define DT_FINI_ARRAYSZ 28
+#define DT_FLAGS    30
+#define DT_RELR     36
+#define DT_FLAGS_1  0x6ffffffb
+
+#define DF_BIND_NOW 0x8
+#define DF_1_NOW    0x1
+
+#define SHT_NOTE    7
+#define SHT_NOBITS  8
+#define SHT_DYNSYM  11
+
+#define STT_OBJECT    1
+#define STT_FUNC      2
+#define STT_GNU_IFUNC 10
+#define STB_GLOBAL    1
+#define STB_WEAK      2
+#define STV_HIDDEN    2
+#define SHN_UNDEF     0
+
+#define ELF64_R_SYM(i)    ((i) >> 32)
+#define ELF64_R_TYPE(i)   ((i) & 0xffffffff)
+#define ELF64_ST_TYPE(i)  ((i) & 0xf)
+#define ELF64_ST_BIND(i)  ((i) >> 4)
+#define ELF64_ST_VISIBILITY(o) ((o) & 0x3)
 
 typedef struct {
     unsigned char   e_ident[16];
@@ -65,15 +118,164 @@ typedef struct {
     uint64_t    st_size;
 } Elf64_Sym;
 
+typedef struct {
+    uint32_t    sh_name;
+    uint32_t    sh_type;
+    uint64_t    sh_flags;
+    uint64_t    sh_addr;
+    uint64_t    sh_offset;
+    uint64_t    sh_size;
+    uint32_t    sh_link;
+    uint32_t    sh_info;
+    uint64_t    sh_addralign;
+    uint64_t    sh_entsize;
+} Elf64_Shdr;
+
+typedef struct {
+    int64_t     d_tag;
+    uint64_t    d_val;
+} Elf64_Dyn;
+
+/*
+ * Fichier ELF projeté une seule fois en mémoire (lecture seule).
+ * Tous les pointeurs sont des vues dans la projection, validées par
+ * elf_open() : aucune copie, aucune allocation (sauf pour un conteneur
+ * compressé, cf. isosz.h).
+ */
+typedef struct {
+    int fd;
+    const uint8_t* data;
+    size_t size;
+
+    const elf_header* hdr;
+    const elf_phdr* phdrs;
+    size_t phnum;
+    const Elf64_Shdr* shdrs;
+    size_t shnum;
+    const char* shstrtab;
+    size_t shstrtab_size;
+    const Elf64_Dyn* dynamic;
+    size_t dyn_count;
+    const Elf64_Sym* dynsym;
+    size_t dynsym_count;
+    const char* dynstr;
+    size_t dynstr_size;
+
+    // Conteneur compressé (.isosz) : data est alors la vue décompressée
+    struct isosz* compressed;
+} elf_file;
+
+// Itérateur générique sur les tables d'un elf_file
+typedef struct {
+    const elf_file* elf;
+    size_t index;
+} elf_iter;
+
+#define ELF_BUILD_ID_MAX 64
+
+// Identité d'un fichier ELF, pour reconnaître les fichiers annexes périmés
+typedef struct {
+    uint64_t dev;
+    uint64_t ino;
+    uint64_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint32_t build_id_len;
+    uint8_t build_id[ELF_BUILD_ID_MAX];
+} elf_identity;
+
+int elf_open(const char* filename, elf_file* elf);
+int elf_open_fd(int fd, elf_file* elf);
+void elf_close(elf_file* elf);
+int elf_validate(elf_file* elf);
+const void* elf_view(const elf_file* elf, uint64_t offset, uint64_t size);
+const char* elf_string(const char* table, size_t table_size, uint64_t offset);
+int elf_build_id(const elf_file* elf, const uint8_t** id, size_t* len);
+void elf_identity_fill(const elf_file* elf, elf_identity* identity);
+int elf_identity_match(const elf_identity* a, const elf_identity* b);
+int elf_sym_exported(const Elf64_Sym* sym);
+
+void elf_iter_init(elf_iter* it, const elf_file* elf);
+const elf_phdr* elf_next_phdr(elf_iter* it);
+const Elf64_Shdr* elf_next_shdr(elf_iter* it, const char** name);
+const Elf64_Dyn* elf_next_dyn(elf_iter* it);
+const Elf64_Sym* elf_next_dynsym(elf_iter* it, const char** name);
+
 
 int read_elf_header(const char* filename, elf_header* hdr);
 int read_program_headers(int fd, elf_header* hdr, elf_phdr** phdrs);
-int check_valid_lib(elf_header* hdr);
-void print_header(elf_header* hdr);
-void print_phdr(elf_phdr* phdr, int idx);
+int check_valid_lib(const elf_header* hdr);
+void print_header(const elf_header* hdr);
+void print_phdr(const elf_phdr* phdr, int idx);
+
+// Options de load_library_ex() : LOAD_* (isosloader.h)
+#define HUGE_PAGE_SIZE      (2u << 20)
+
+struct isosprof;
+struct isosz;
+
+typedef struct {
+    int flags;              // LOAD_*
+    void* reservation;      // plage PROT_NONE fournie (pack), NULL sinon
+    const struct isosprof* profile;     // pages à précharger (LOAD_PROFILE)
+    // PLT standard (DT_JMPREL) : GOT[1] et GOT[2], NULL pour ne pas la lier
+    void* plt_handle;
+    void* plt_resolver;
+    // Image compressée : segments décompressés depuis ce conteneur au lieu
+    // d'être projetés depuis fd
+    const struct isosz* compressed;
+    // LOAD_VERIFY : CRC32C attendu de chaque segment, indexé comme phdrs
+    const uint32_t* crc32c;
+} load_options_t;
+
+// Type de pages (LOAD_TEXT_PAGES_*) et bilan d'un chargement (load_stats_t) : isosloader.h
+
+int load_extent(const elf_phdr* phdrs, int phnum, size_t page_size, uint64_t* base_offset,
+                size_t* total_size);
+int load_library(int fd, const elf_header* hdr, const elf_phdr* phdrs, void** out_base_addr);
+int load_library_ex(int fd, const elf_header* hdr, const elf_phdr* phdrs,
+                    const load_options_t* opts, load_stats_t* stats, void** out_base_addr);
+void unload_library(void* base_addr, const elf_phdr* phdrs, int phnum);
+int perform_relocations(void* base_addr, const elf_header* hdr, const elf_phdr* phdrs);
+int relocations_writable(void* base_addr, const elf_header* hdr, const elf_phdr* phdrs);
+int perform_ifunc_relocations(void* base_addr, const elf_header* hdr, const elf_phdr* phdrs,
+                              int lazy_plt);
+
+// Tables dynamiques d'une image chargée (pointeurs dans l'image)
+typedef struct {
+    Elf64_Rela* rela;
+    int rela_count;
+    Elf64_Rela* jmprel;
+    int jmprel_count;
+    Elf64_Sym* symtab;
+    const char* strtab;
+    uint64_t* pltgot;
+    int has_relr;
+    // Segments de l'image : chaque table tient dans un PT_LOAD lisible
+    const elf_phdr* phdrs;
+    int phnum;
+    // Symboles adressables avant la fin de leur segment, taille de strtab
+    size_t sym_count;
+    size_t strsz;
+    // Constructeurs et destructeurs (DT_INIT*, DT_FINI*), liaison immédiate
+    uint64_t init;
+    const uint64_t* init_array;
+    int init_array_count;
+    uint64_t fini;
+    const uint64_t* fini_array;
+    int fini_array_count;
+    int bind_now;
+} dyn_tables;
+
+// Constructeur ou destructeur d'une image, appelé comme par ld.so
+typedef void (*elf_init_fn)(int argc, char** argv, char** envp);
 
-int load_library(int fd, elf_header* hdr, elf_phdr* phdrs, void** out_base_addr);
-int perform_relocations(void* base_addr, elf_header* hdr, elf_phdr* phdrs);
+int find_dyn_tables(void* base_addr, const elf_header* hdr, const elf_phdr* phdrs,
+                    dyn_tables* tables);
+int dyn_init_functions(void* base_addr, const dyn_tables* tables, int fini, elf_init_fn* out);
+int is_lazy_jump_slot(const Elf64_Rela* rela, const Elf64_Sym* symtab);
+int setup_lazy_plt(void* base_addr, const elf_header* hdr, const elf_phdr* phdrs,
+                   void* plt_handle, void* plt_resolver);
 int find_dynamic_symbol(void* base_addr, elf_header* hdr, elf_phdr* phdrs, 
                     const char* name, void** symbol_addr);
 #endif
\ No newline at end of file
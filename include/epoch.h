@@ -0,0 +1,23 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+// Nombre maximal de threads enregistrés en même temps
+#define EPOCH_MAX_THREADS 128
+
+/*
+ * Récupération différée par époques (EBR).
+ *
+ * Un thread qui appelle du code d'une bibliothèque rechargeable le fait
+ * entre epoch_enter() et epoch_leave(). Un objet retiré par epoch_retire()
+ * n'est libéré qu'une fois sortis tous les threads entrés avant son
+ * retrait. Les lecteurs ne prennent aucun verrou et ne bloquent jamais.
+ */
+typedef void (*epoch_free_fn)(void* arg);
+
+int epoch_enter(void);
+void epoch_leave(void);
+int epoch_retire(epoch_free_fn free_fn, void* arg, const void* owner);
+int epoch_reclaim(void);
+void epoch_flush(const void* owner);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+// Histogramme log-linéaire façon HDR : 2^(HIST_SUB_BITS-1) sous-intervalles
+// par puissance de deux, soit une précision relative d'environ 6%.
+#define HIST_SUB_BITS    5
+#define HIST_SUB_COUNT   (1 << (HIST_SUB_BITS - 1))
+#define HIST_BUCKETS     ((64 - HIST_SUB_BITS + 2) * HIST_SUB_COUNT)
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+} histogram_t;
+
+void hist_init(histogram_t* hist);
+void hist_record(histogram_t* hist, uint64_t value);
+uint64_t hist_percentile(const histogram_t* hist, double percentile);
+double hist_mean(const histogram_t* hist);
+void hist_merge(histogram_t* dst, const histogram_t* src);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef INTEGRITY_H
+#define INTEGRITY_H
+
+#include <stdint.h>
+#include "elf_parser.h"
+
+/*
+ * Vérification d'intégrité au chargement (LOAD_VERIFY). La section
+ * .note.isos.crc32c, ajoutée par "isos_loader --checksum", donne le
+ * CRC32C de chaque segment PT_LOAD tel qu'il est dans le fichier. C'est
+ * une section non allouée, hors de tout segment : elle ne se couvre pas
+ * elle-même.
+ *
+ * Le CRC est calculé sur l'image juste après la projection des
+ * segments, avant les relocations : ce sont ces lectures qui amènent les
+ * pages en mémoire, sans seconde passe sur le fichier. Les segments sont
+ * coupés en tranches de INTEGRITY_CHUNK réparties entre threads, puis
+ * les CRC des tranches sont recombinés (crc32c_combine()).
+ *
+ * Note : namesz, descsz, type (NT_ISOS_CRC32C), nom "ISOS", puis un
+ * integrity_entry par segment PT_LOAD non vide.
+ */
+
+// Nom de la section (INTEGRITY_SECTION) : isosloader.h
+#define INTEGRITY_NOTE_NAME     "ISOS"
+#define NT_ISOS_CRC32C          0x43524332u
+#define INTEGRITY_CHUNK         (1u << 20)
+#define INTEGRITY_MAX_THREADS   8
+
+typedef struct {
+    uint32_t phdr_index;
+    uint32_t crc;
+} integrity_entry;
+
+int integrity_note_find(const elf_file* elf, uint32_t* crcs);
+int integrity_verify(uint64_t base_address, const elf_phdr* phdrs, int phnum,
+                     const uint32_t* crcs, size_t* verified);
+int integrity_write(const char* library_path);
+
+#endif
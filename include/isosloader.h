@@ -0,0 +1,191 @@
+#ifndef ISOSLOADER_H
+#define ISOSLOADER_H
+
+/*
+ * API publique de libisosloader (libisosloader.a, libisosloader.so).
+ *
+ * Seul en-tête à inclure pour charger des bibliothèques dans le
+ * processus : les handles sont opaques, les structures ci-dessous ne
+ * font que croître par la fin. La bibliothèque partagée n'exporte que
+ * ces fonctions (isosloader.map, version ISOSLOADER_1).
+ *
+ * Les imports d'une PLT standard (DT_JMPREL) que ne fournit aucune
+ * bibliothèque chargée sont cherchés dans le processus hôte : lier
+ * l'exécutable avec -rdynamic pour leur exposer ses symboles.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ISOSLOADER_VERSION_MAJOR 1
+#define ISOSLOADER_VERSION_MINOR 0
+
+// Options de chargement (my_dlopen_flags(), my_dlopen_async())
+#define LOAD_HUGE_TEXT      0x1     // texte exécutable en pages de 2 Mo si possible
+// Politiques de résidence (aucune : pages chargées à la demande, au premier appel)
+#define LOAD_READAHEAD      0x2     // lecture anticipée des segments (WILLNEED)
+#define LOAD_POPULATE       0x4     // toutes les pages présentes au retour
+#define LOAD_LOCK           0x8     // segments verrouillés en mémoire (mlock)
+#define LOAD_PROFILE        0x10    // seules les pages du profil .isosprof
+// Segments en lecture seule projetés depuis le fichier, jamais inscriptibles
+// (pages du cache partagées entre instances ; relocations hors texte exigées)
+#define LOAD_SHARED_TEXT    0x20
+// Segments vérifiés contre la note .note.isos.crc32c avant les relocations
+#define LOAD_VERIFY         0x40
+// Appels d'imports comptés par un stub, cf. my_dlstats()
+#define LOAD_CALLSTATS      0x80
+
+// Type de pages obtenu pour le texte exécutable
+#define LOAD_TEXT_PAGES_SMALL    0
+#define LOAD_TEXT_PAGES_THP      1
+#define LOAD_TEXT_PAGES_HUGETLB  2
+
+// Bilan d'un chargement
+typedef struct {
+    size_t image_size;      // étendue réservée pour les segments
+    size_t text_size;       // segments exécutables
+    size_t text_huge_size;  // dont octets en pages de 2 Mo
+    int text_pages;         // LOAD_TEXT_PAGES_*
+    size_t populated_size;  // octets préchargés (LOAD_POPULATE, LOAD_PROFILE)
+    size_t locked_size;     // octets verrouillés (LOAD_LOCK)
+    size_t verified_size;   // octets vérifiés par CRC32C (LOAD_VERIFY)
+} load_stats_t;
+
+// Mémoire d'une plage, en octets
+typedef struct {
+    void* start;
+    size_t size;
+    int segment;
+    int flags;
+    size_t resident;        // pages présentes ou en cache (mincore)
+    size_t rss;             // /proc/self/smaps, comme les champs suivants
+    size_t pss;
+    size_t shared;          // Shared_Clean + Shared_Dirty
+    size_t private_dirty;
+    size_t swap;
+} segment_meminfo_t;
+
+#define MEMINFO_MAX_SEGMENTS 16
+
+/*
+ * Bilan mémoire d'une image : une entrée par segment PT_LOAD (les
+ * suivants, au-delà de MEMINFO_MAX_SEGMENTS, ne comptent que dans total).
+ */
+typedef struct {
+    int count;
+    segment_meminfo_t segments[MEMINFO_MAX_SEGMENTS];
+    segment_meminfo_t total;
+} lib_meminfo_t;
+
+// Chargement, recherche de symboles, déchargement
+void* my_dlopen(const char* library_path);
+void* my_dlopen_flags(const char* library_path, int flags);
+void* my_dlopen_fd(int fd);
+void* my_dlopen_mem(const void* buf, size_t len);
+void* my_dlsym(void* handle, const char* symbol_name);
+void* my_dlsym_global(const char* symbol_name, void** owner);
+int my_dlclose(void* handle);
+
+// Imports de loader_info : table { nom, adresse } terminée par { NULL, NULL }
+int my_set_plt_resolve(void* handle, void* resolve_table);
+int my_dlprebind(void* handle);
+// Nom de l'import id de loader_info, NULL au-delà du dernier
+const char* my_dlimport_name(void* handle, int id);
+
+#if defined(__x86_64__)
+/*
+ * Rejoue l'entrée PLT de l'import sym_id (push id ; push handle ; jmp
+ * vers le trampoline) avec a..f et x pour arguments, et rend ce que
+ * l'import retourne : mesure depuis l'hôte du coût d'un appel d'import.
+ */
+void* my_dlplt_call(long a, long b, long c, long d, long e, long f, double x, void* handle,
+                    long sym_id);
+#endif
+
+const load_stats_t* my_dlloadstats(void* handle);
+int my_dlmeminfo(void* handle, lib_meminfo_t* info);
+
+/*
+ * Profil des appels d'imports d'une image chargée avec LOAD_CALLSTATS :
+ * nombre d'appels, et latence d'un appel sur period (my_dlstats_sample(),
+ * 128 par défaut, 0 pour ne rien chronométrer). Un appel chronométré
+ * revient par le loader : il ne doit pas être traversé par une
+ * exception C++.
+ */
+typedef struct {
+    const char* name;
+    uint64_t calls;
+    uint64_t samples;       // appels chronométrés
+    uint64_t total_ns;      // leur durée cumulée
+    uint64_t min_ns;
+    uint64_t max_ns;
+} import_stats_t;
+
+int my_dlstats(void* handle, import_stats_t* stats, int max);
+void my_dlstats_sample(unsigned period);
+
+// Chargement groupé de petites bibliothèques dans une même réservation
+void* my_dlpack_create(size_t reserve);
+void* my_dlopen_packed(void* pack, const char* library_path);
+int my_dlpack_destroy(void* pack);
+
+// Chargement asynchrone (thread du loader, io_uring)
+void* my_dlopen_async(const char* library_path, int flags);
+int my_dlasync_poll(void* req);
+int my_dlasync_fd(void* req);
+void* my_dlasync_wait(void* req);
+
+// Espaces de noms isolés : une instance privée par espace, texte partagé
+void* my_dlns_create(void);
+void* my_dlmopen(void* ns, const char* library_path);
+void* my_dlsym_ns(void* ns, const char* symbol_name, void** owner);
+int my_dlns_destroy(void* ns);
+
+/*
+ * Rechargement à chaud : les appels passent ensuite par la nouvelle
+ * version. Les adresses obtenues avant le rechargement ne restent
+ * valides que pour un thread entré par my_dlepoch_enter() avant celui-ci,
+ * jusqu'à son my_dlepoch_leave().
+ */
+int my_dlreload(void* handle, const char* new_path);
+int my_dlepoch_enter(void);
+void my_dlepoch_leave(void);
+
+// Liaison groupée : un descripteur par pointeur de fonction d'une structure
+typedef struct {
+    const char* name;
+    size_t offset;
+} my_dlbind_desc;
+
+#define MY_DLBIND_ENTRY(type, field) { #field, offsetof(type, field) }
+
+int my_dlbind(void* handle, const char* const names[], void* out[], size_t n);
+int my_dlbind_struct(void* handle, const my_dlbind_desc* desc, size_t n,
+                     void* out_struct);
+
+// Fichiers annexes d'une bibliothèque (index, profil, conteneur, note CRC32C)
+#define ISOSIDX_SUFFIX      ".isosidx"
+#define ISOSPROF_SUFFIX     ".isosprof"
+#define ISOSZ_SUFFIX        ".isosz"
+#define INTEGRITY_SECTION   ".note.isos.crc32c"
+
+int isosidx_write(const char* library_path, void* handle);
+int isosprof_write(const char* library_path, void* handle);
+int isosz_write(const char* library_path, const char* out_path);
+int my_dlintegrity_write(const char* library_path);
+
+int my_dlcheck_elf(const char* library_path);
+
+// Traces du loader sur stdout, de 0 (aucune, pas même l'en-tête ELF de
+// chaque chargement) à 5 (très verbeux) ; 1 (erreurs) par défaut
+void my_dldebug_init(int level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
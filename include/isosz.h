@@ -0,0 +1,61 @@
+#ifndef ISOSZ_H
+#define ISOSZ_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "elf_parser.h"
+
+/*
+ * Conteneur compressé (.isosz) autour d'une image ELF, écrit par
+ * "isos_loader --compress". Le fichier ELF est découpé en blocs LZ4
+ * indépendants ; les coupures tombent sur les bornes de chaque PT_LOAD
+ * dans le fichier, si bien qu'un bloc appartient en entier à un segment
+ * ou à aucun.
+ *
+ * À l'ouverture, les blocs hors texte (en-têtes, sections, segments non
+ * exécutables : .dynsym, .dynamic...) sont décompressés dans une vue
+ * anonyme aux offsets du fichier, que le reste du loader lit comme un
+ * fichier projeté. Les blocs des segments exécutables ne sont
+ * décompressés qu'au chargement, directement à leur place dans l'image,
+ * en parallèle (isosz_fill()).
+ *
+ * Format : isosz_header, block_count isosz_block, puis les données.
+ */
+
+#define ISOSZ_MAGIC         "ISOSZ\0\0\1"
+#define ISOSZ_VERSION       1
+// Suffixe du fichier (ISOSZ_SUFFIX) : isosloader.h
+// Taille maximale d'un bloc (décompressé), unité du parallélisme
+#define ISOSZ_BLOCK_SIZE    (256u << 10)
+#define ISOSZ_MAX_THREADS   8
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_count;
+    uint64_t image_size;        // taille du fichier ELF d'origine
+} isosz_header;
+
+typedef struct {
+    uint64_t image_offset;      // position dans le fichier ELF
+    uint64_t data_offset;       // position dans le conteneur
+    uint32_t raw_size;
+    uint32_t data_size;         // == raw_size : bloc stocké tel quel
+} isosz_block;
+
+typedef struct isosz {
+    const uint8_t* map;         // conteneur projeté
+    size_t map_size;
+    const isosz_header* hdr;
+    const isosz_block* blocks;
+    uint8_t* view;              // image du fichier ELF, texte absent
+    size_t image_size;
+} isosz_t;
+
+int isosz_is_container(const void* data, size_t size);
+int isosz_write(const char* library_path, const char* out_path);
+int isosz_open(elf_file* elf);
+int isosz_fill(const isosz_t* z, uint64_t base_address, const elf_phdr* phdrs, int phnum);
+void isosz_close(isosz_t* z);
+
+#endif
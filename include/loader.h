@@ -23,4 +23,8 @@ typedef struct {
 int init_library(void* handle, void* plt_table);
 const char* get_symbol_name_by_id(const char** imported_symbols, int sym_id) ;
 void* find_function_by_name(symbol_entry* exported_symbols, const char* name) ;
+void* loader_plt_bind(void* handle, int sym_id);
+void* loader_plt_resolver(void* handle, int sym_id);
+void* loader_jmprel_bind(void* handle, long reloc_index);
+void* loader_jmprel_resolver(void* handle, long reloc_index);
 #endif
\ No newline at end of file
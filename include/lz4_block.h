@@ -0,0 +1,26 @@
+#ifndef LZ4_BLOCK_H
+#define LZ4_BLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Codec LZ4, format bloc (séquences jeton / littéraux / distance sur 16
+ * bits / longueur de correspondance), sans dépendance externe. Le
+ * compresseur est glouton (une table de hachage sur 4 octets) ; le
+ * décompresseur vérifie toutes les bornes : un bloc corrompu est refusé,
+ * jamais lu ou écrit hors des tampons.
+ */
+
+#define LZ4_MIN_MATCH       4
+#define LZ4_MAX_DISTANCE    65535
+// Les 5 derniers octets d'un bloc sont toujours des littéraux, et la
+// dernière correspondance commence au moins 12 octets avant la fin
+#define LZ4_LAST_LITERALS   5
+#define LZ4_MFLIMIT         12
+
+size_t lz4_compress_bound(size_t size);
+size_t lz4_compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+int lz4_decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t out_size);
+
+#endif
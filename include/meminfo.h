@@ -0,0 +1,21 @@
+#ifndef MEMINFO_H
+#define MEMINFO_H
+
+#include <stddef.h>
+#include "elf_parser.h"
+
+// Plage projetée pour un segment PT_LOAD (alignée sur la page, .bss compris)
+typedef struct {
+    void* start;
+    size_t size;
+    int segment;            // indice dans la table des program headers
+    int flags;              // PF_R, PF_W, PF_X
+} mapped_range_t;
+
+// Bilan par segment (segment_meminfo_t, lib_meminfo_t) : isosloader.h
+
+int meminfo_ranges(void* base_addr, const elf_phdr* phdrs, int phnum, size_t page_size,
+                   mapped_range_t* ranges);
+int meminfo_collect(const mapped_range_t* ranges, int count, lib_meminfo_t* info);
+
+#endif
@@ -12,10 +12,17 @@ const char* hidden_func();
 // Fonctions qui importent depuis le loader
 const char* bar_imported(); 
 const char* foo_imported();
+const char* args_imported();
+
+// Noyau dont la variante (scalar/avx2/avx512) est choisie au chargement
+const char* kernel_dispatch();
+const char* kernel_caller();
 
 // Fonctions importées du loader
 extern const char* new_foo();
 extern const char* new_bar();
+extern const char* new_args(long a, long b, long c, long d, long e, long f,
+                            double x);
 
 
 //chall7 
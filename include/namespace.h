@@ -0,0 +1,47 @@
+#ifndef NAMESPACE_H
+#define NAMESPACE_H
+
+#include <pthread.h>
+#include "arena.h"
+#include "bloom.h"
+#include "elf_parser.h"
+#include "loader.h"
+
+struct lib_handle;
+
+/*
+ * Espace de noms (à la dlmopen) : liste des handles qu'il contient, dans
+ * l'ordre de chargement, pour la recherche globale et la liaison des
+ * imports. L'espace de base regroupe tout ce qu'ouvre my_dlopen() ; un
+ * espace créé par my_dlns_create() reçoit ses propres instances, avec
+ * données et BSS privées, invisibles des autres espaces.
+ */
+typedef struct lib_namespace {
+    struct lib_handle* head;
+    struct lib_handle* tail;
+    pthread_rwlock_t lock;
+} lib_namespace_t;
+
+/*
+ * Table d'export d'une bibliothèque ordinaire construite une seule fois
+ * par fichier et partagée par toutes ses instances : adresses relatives
+ * à la base, noms copiés dans l'arène, filtre de Bloom, index trié de
+ * my_dlbind(). Le texte étant lui-même partagé (LOAD_SHARED_TEXT), une
+ * instance de plus ne coûte guère que ses segments inscriptibles.
+ */
+typedef struct shared_exports {
+    elf_identity identity;
+    arena_t* arena;
+    symbol_entry* exports;
+    symbol_entry* sorted;
+    int count;
+    bloom_t bloom;
+    int refs;
+    struct shared_exports* next;
+} shared_exports_t;
+
+symbol_entry* exports_sort(arena_t* arena, const symbol_entry* exports, int* count);
+shared_exports_t* shared_exports_get(const elf_file* elf);
+void shared_exports_put(shared_exports_t* shared);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <stddef.h>
+#include "arena.h"
+#include "elf_parser.h"
+
+// Réservation par défaut d'un pack : de quoi loger des centaines de petites images
+#define PACK_DEFAULT_RESERVE (64u << 20)
+
+/*
+ * Pack : une seule réservation d'adresses dans laquelle les images de
+ * nombreuses petites bibliothèques sont posées bout à bout, page après
+ * page, plus une arène commune pour leurs métadonnées. Le code des
+ * bibliothèques reste groupé au lieu d'être dispersé dans l'espace
+ * d'adressage, et aucune projection par bibliothèque ne s'intercale.
+ */
+typedef struct lib_pack {
+    unsigned char* base;
+    size_t size;
+    size_t used;
+    arena_t* arena;
+    int count;
+} lib_pack_t;
+
+lib_pack_t* pack_create(size_t reserve);
+void* pack_reserve(lib_pack_t* pack, size_t size);
+void pack_release(lib_pack_t* pack, void* base_addr, const elf_phdr* phdrs, int phnum);
+void pack_destroy(lib_pack_t* pack);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef PAGE_PROFILE_H
+#define PAGE_PROFILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "elf_parser.h"
+
+/*
+ * Profil d'accès aux pages (.isosprof), écrit à côté de la bibliothèque
+ * après une exécution d'échauffement ("isos_loader --record-profile").
+ * Il liste, segment par segment, les pages présentes dans le processus à
+ * la fin de l'échauffement. Un chargement avec LOAD_PROFILE précharge
+ * exactement ces pages, en une passe groupée.
+ *
+ * Format : isosprof_header puis run_count isosprof_run.
+ */
+
+#define ISOSPROF_MAGIC    "ISOSPRF1"
+#define ISOSPROF_VERSION  1
+// Suffixe du fichier (ISOSPROF_SUFFIX) : isosloader.h
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t run_count;
+    uint32_t page_size;
+    uint32_t reserved;
+    // Identité de la bibliothèque profilée
+    elf_identity identity;
+} isosprof_header;
+
+// Suite de pages consécutives d'un segment PT_LOAD
+typedef struct {
+    uint32_t segment;       // indice dans la table des program headers
+    uint32_t first_page;    // depuis le début (aligné) du segment
+    uint32_t page_count;
+} isosprof_run;
+
+typedef struct isosprof {
+    const void* map;
+    size_t size;
+    const isosprof_header* hdr;
+    const isosprof_run* runs;
+} isosprof_t;
+
+int isosprof_write(const char* library_path, void* handle);
+int isosprof_open(const char* library_path, const elf_file* elf, isosprof_t* prof);
+void isosprof_close(isosprof_t* prof);
+size_t isosprof_resident_bytes(void* handle);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef SYMBOL_INDEX_H
+#define SYMBOL_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "elf_parser.h"
+
+/*
+ * Index de symboles précalculé (.isosidx), écrit à côté de la
+ * bibliothèque par "isos_loader --index". Le fichier est projeté en
+ * lecture seule par my_dlopen() : le cache de pages le partage entre
+ * tous les processus et la recherche ne demande aucune préparation.
+ *
+ * Format : isosidx_header, puis bucket_count isosidx_slot (table de
+ * hachage à adressage ouvert), puis la table des noms.
+ */
+
+#define ISOSIDX_MAGIC     "ISOSIDX1"
+#define ISOSIDX_VERSION   1
+// Suffixe du fichier (ISOSIDX_SUFFIX) : isosloader.h
+#define ISOSIDX_EMPTY     UINT32_MAX
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t bucket_count;      // puissance de deux
+    uint32_t entry_count;
+    uint32_t strtab_size;
+    // Identité de la bibliothèque indexée
+    elf_identity identity;
+} isosidx_header;
+
+typedef struct {
+    uint32_t hash;
+    uint32_t name_off;          // ISOSIDX_EMPTY si le slot est libre
+    uint64_t offset;            // adresse du symbole relative à la base
+} isosidx_slot;
+
+typedef struct {
+    const void* map;
+    size_t size;
+    const isosidx_header* hdr;
+    const isosidx_slot* slots;
+    const char* strtab;
+    // Étendue des PT_LOAD : un offset hors de [image_start, image_end) est refusé
+    uint64_t image_start;
+    uint64_t image_end;
+} isosidx_t;
+
+uint32_t isosidx_hash(const char* name);
+int isosidx_write(const char* library_path, void* handle);
+int isosidx_open(const char* library_path, const elf_file* elf, isosidx_t* idx);
+void isosidx_close(isosidx_t* idx);
+const isosidx_slot* isosidx_probe(const isosidx_t* idx, const char* name, uint32_t hash);
+
+#endif
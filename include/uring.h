@@ -0,0 +1,47 @@
+#ifndef URING_H
+#define URING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <linux/io_uring.h>
+
+/*
+ * Anneau io_uring minimal, sans liburing : appels système bruts et un
+ * seul producteur (le thread qui possède l'anneau prépare, soumet et
+ * consomme les complétions).
+ */
+// Opérations décrites par IORING_REGISTER_PROBE
+#define URING_PROBE_OPS 256
+
+typedef struct {
+    int fd;
+    // File de soumission (partagée avec le noyau)
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned sq_entries;
+    struct io_uring_sqe* sqes;
+    unsigned sqe_tail;      // SQE préparées, publiées au prochain uring_submit()
+    // File de complétion
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    // Projections
+    void* sq_map;
+    size_t sq_map_size;
+    void* cq_map;
+    size_t cq_map_size;
+    size_t sqes_size;
+} uring_t;
+
+int uring_init(uring_t* ring, unsigned entries);
+void uring_destroy(uring_t* ring);
+int uring_probe(uring_t* ring, const uint8_t* ops, int count);
+struct io_uring_sqe* uring_get_sqe(uring_t* ring);
+int uring_submit_and_wait(uring_t* ring, unsigned wait_nr);
+struct io_uring_cqe* uring_peek_cqe(uring_t* ring);
+void uring_cqe_seen(uring_t* ring);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef ZYGOTE_H
+#define ZYGOTE_H
+
+#include <stddef.h>
+
+/*
+ * Mode serveur (zygote) : les bibliothèques sont chargées et liées une
+ * seule fois, puis chaque requête reçue sur la socket UNIX est traitée
+ * par un fils issu de fork(), qui hérite des images déjà relogées en
+ * copie sur écriture.
+ *
+ * Protocole (une requête par connexion) :
+ *   client -> "LIBRARY_PATH FUNCTION_NAME\n"
+ *   serveur -> "<résultat de l'appel>\n" ou "ERR <message>\n"
+ */
+
+#define ZYGOTE_MAX_REQUEST 4096
+
+int zygote_serve(const char* socket_path, char** lib_paths, void** handles, int count);
+int zygote_request(const char* socket_path, const char* lib_path, const char* func_name,
+                   char* reply, size_t reply_size);
+
+#endif
@@ -0,0 +1,123 @@
+#include "arena.h"
+#include "debug.h"
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+static size_t align_up(size_t value, size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief Crée une arène : une seule projection, dont l'en-tête arena_t
+ *        occupe le début.
+ *
+ * @param reserve : taille réservée (arrondie à la page).
+ * @return l'arène, ou NULL si mmap échoue.
+ */
+arena_t *arena_create(size_t reserve) {
+    size_t size = align_up(reserve < 4096 ? 4096 : reserve, 4096);
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (map == MAP_FAILED) {
+        debug_error("mmap de l'arène a échoué");
+        return NULL;
+    }
+
+    arena_t *arena = map;
+    arena->base = map;
+    arena->size = size;
+    arena->used = align_up(sizeof(arena_t), ARENA_ALIGN);
+    arena->next = NULL;
+    return arena;
+}
+
+/**
+ * @return un bloc aligné sur ARENA_ALIGN et mis à zéro, NULL si la
+ *         mémoire manque. Le bloc vit jusqu'à arena_destroy().
+ */
+void *arena_alloc(arena_t *arena, size_t size) {
+    if (!arena) {
+        return NULL;
+    }
+    size = align_up(size ? size : 1, ARENA_ALIGN);
+
+    // Cherche de la place dans la dernière projection de la chaîne
+    arena_t *chunk = arena;
+    while (chunk->next) {
+        chunk = chunk->next;
+    }
+    if (size > chunk->size - chunk->used) {
+        size_t header = align_up(sizeof(arena_t), ARENA_ALIGN);
+        size_t reserve = arena->size > size + header ? arena->size : size + header;
+        arena_t *next = arena_create(reserve);
+        if (!next) {
+            return NULL;
+        }
+        chunk->next = next;
+        chunk = next;
+    }
+
+    void *ptr = chunk->base + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+void *arena_calloc(arena_t *arena, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    // Les pages anonymes neuves sont déjà à zéro
+    return arena_alloc(arena, count * size);
+}
+
+void *arena_memdup(arena_t *arena, const void *src, size_t size) {
+    void *dst = arena_alloc(arena, size);
+    if (dst && size > 0) {
+        memcpy(dst, src, size);
+    }
+    return dst;
+}
+
+size_t arena_used(const arena_t *arena) {
+    size_t used = 0;
+    for (; arena; arena = arena->next) {
+        used += arena->used;
+    }
+    return used;
+}
+
+arena_mark_t arena_mark(arena_t *arena) {
+    arena_mark_t mark = {arena, 0};
+    while (mark.chunk && mark.chunk->next) {
+        mark.chunk = mark.chunk->next;
+    }
+    mark.used = mark.chunk ? mark.chunk->used : 0;
+    return mark;
+}
+
+/**
+ * @brief Rend tous les blocs alloués depuis arena_mark() : une arène
+ *        partagée (pack) ne garde rien d'un chargement abandonné. Les
+ *        blocs rendus sont remis à zéro pour les allocations suivantes.
+ *
+ * Aucun bloc alloué après la marque ne doit rester utilisé.
+ */
+void arena_rewind(arena_t *arena, arena_mark_t mark) {
+    if (!arena || !mark.chunk) {
+        return;
+    }
+    arena_destroy(mark.chunk->next);
+    mark.chunk->next = NULL;
+    memset(mark.chunk->base + mark.used, 0, mark.chunk->used - mark.used);
+    mark.chunk->used = mark.used;
+}
+
+// Libère toutes les projections : chaque bloc alloué devient invalide
+void arena_destroy(arena_t *arena) {
+    while (arena) {
+        arena_t *next = arena->next;
+        munmap(arena->base, arena->size);
+        arena = next;
+    }
+}
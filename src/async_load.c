@@ -0,0 +1,455 @@
+#define _GNU_SOURCE
+#include "async_load.h"
+#include "elf_parser.h"
+#include "isosz.h"
+#include "uring.h"
+#include "debug.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Étapes d'une requête sur le thread du loader
+enum {
+    ASYNC_QUEUED,
+    ASYNC_OPENING,
+    ASYNC_READING_HEADER,
+    ASYNC_READAHEAD,
+};
+
+// user_data de la lecture de wake_fd (les requêtes utilisent leur adresse)
+#define ASYNC_WAKE_TAG 0
+
+static pthread_once_t worker_once = PTHREAD_ONCE_INIT;
+static int worker_ok;
+static int wake_fd = -1;
+static uring_t ring;
+static int ring_ok;
+// errno du premier io_uring_enter en échec : l'anneau est abandonné
+static int ring_error;
+// Requêtes soumises à l'anneau et pas encore terminées (thread du loader)
+static dl_async_t *inflight;
+
+// Opérations utilisées par les requêtes (et le réveil sur wake_fd)
+static const uint8_t ring_ops[] = {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_FADVISE};
+
+// Requêtes soumises, pas encore prises par le thread du loader
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static dl_async_t *queue_head;
+static dl_async_t *queue_tail;
+
+static dl_async_t *take_queue(void) {
+    pthread_mutex_lock(&queue_lock);
+    dl_async_t *list = queue_head;
+    queue_head = NULL;
+    queue_tail = NULL;
+    pthread_mutex_unlock(&queue_lock);
+    return list;
+}
+
+static void untrack(dl_async_t *req) {
+    for (dl_async_t **p = &inflight; *p; p = &(*p)->inflight_next) {
+        if (*p == req) {
+            *p = req->inflight_next;
+            return;
+        }
+    }
+}
+
+// Le résultat est publié en dernier : l'appelant peut libérer req aussitôt
+static void complete(dl_async_t *req, void *handle) {
+    uint64_t one = 1;
+    untrack(req);
+    req->handle = handle;
+    if (write(req->done_fd, &one, sizeof(one)) != sizeof(one)) {
+        debug_warn("Signalement de fin de chargement perdu");
+    }
+    __atomic_store_n(&req->done, 1, __ATOMIC_RELEASE);
+}
+
+static void fail(dl_async_t *req, int err, const char *what) {
+    if (what) {
+        errno = err;
+        perror(what);
+    }
+    if (req->fd >= 0) {
+        close(req->fd);
+        req->fd = -1;
+    }
+    complete(req, NULL);
+}
+
+// Projection et relocations : le descripteur est cédé à finish
+static void finish_request(dl_async_t *req) {
+    int fd = req->fd;
+    req->fd = -1;
+    complete(req, req->finish(fd, req->path, req->flags));
+}
+
+/**
+ * @brief Vérifie l'en-tête lu et en déduit les plages à lire d'avance :
+ *        contenu des segments PT_LOAD et table des sections (validation).
+ *
+ * @return 0 en cas de succès, -1 si le fichier n'est pas une bibliothèque.
+ */
+static int plan_readahead(dl_async_t *req, size_t bytes) {
+    const elf_header *hdr = (const elf_header *) req->header;
+    // Conteneur compressé : il sera lu en entier à la décompression
+    if (isosz_is_container(req->header, bytes)) {
+        req->readahead[0].offset = 0;
+        req->readahead[0].len = 0;
+        req->readahead_count = 1;
+        return 0;
+    }
+    if (bytes < sizeof(elf_header)) {
+        printf("Not an ELF file\n");
+        return -1;
+    }
+    if (check_valid_lib(hdr) != 0) {
+        return -1;
+    }
+
+    req->readahead_count = 0;
+    uint64_t ph_end = hdr->e_phoff + (uint64_t) hdr->e_phnum * sizeof(elf_phdr);
+    if (hdr->e_phoff % 8 == 0 && ph_end <= bytes) {
+        const elf_phdr *phdrs = (const elf_phdr *) (req->header + hdr->e_phoff);
+        for (int i = 0; i < hdr->e_phnum && req->readahead_count < ASYNC_MAX_READAHEAD - 1; i++) {
+            if (phdrs[i].p_type == PT_LOAD && phdrs[i].p_filesz > 0) {
+                req->readahead[req->readahead_count].offset = phdrs[i].p_offset;
+                req->readahead[req->readahead_count].len = phdrs[i].p_filesz;
+                req->readahead_count++;
+            }
+        }
+    }
+    if (hdr->e_shoff && hdr->e_shnum) {
+        req->readahead[req->readahead_count].offset = hdr->e_shoff;
+        req->readahead[req->readahead_count].len = (uint64_t) hdr->e_shnum * hdr->e_shentsize;
+        req->readahead_count++;
+    }
+    return 0;
+}
+
+/*
+ * SQE libre ; si la file est pleine, on soumet ce qui est déjà préparé.
+ * NULL si io_uring_enter échoue : la requête reste dans inflight et
+ * échouera avec les autres quand ring_worker abandonnera l'anneau.
+ */
+static struct io_uring_sqe *next_sqe(void) {
+    while (!ring_error) {
+        struct io_uring_sqe *sqe = uring_get_sqe(&ring);
+        if (sqe) {
+            return sqe;
+        }
+        if (uring_submit_and_wait(&ring, 0) != 0) {
+            ring_error = errno;
+        }
+    }
+    return NULL;
+}
+
+static void arm_wake(uint64_t *wake_value) {
+    struct io_uring_sqe *sqe = next_sqe();
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wake_fd;
+    sqe->addr = (uintptr_t) wake_value;
+    sqe->len = sizeof(*wake_value);
+    sqe->user_data = ASYNC_WAKE_TAG;
+}
+
+static void submit_open(dl_async_t *req) {
+    req->inflight_next = inflight;
+    inflight = req;
+    req->state = ASYNC_OPENING;
+    struct io_uring_sqe *sqe = next_sqe();
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uintptr_t) req->path;
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    sqe->user_data = (uintptr_t) req;
+}
+
+static void submit_header_read(dl_async_t *req) {
+    req->state = ASYNC_READING_HEADER;
+    struct io_uring_sqe *sqe = next_sqe();
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = req->fd;
+    sqe->addr = (uintptr_t) req->header;
+    sqe->len = ASYNC_HEADER_SIZE;
+    sqe->off = 0;
+    sqe->user_data = (uintptr_t) req;
+}
+
+static void submit_readahead(dl_async_t *req) {
+    // Au moins une complétion attendue : la requête reste dans inflight
+    req->pending = 0;
+    req->state = ASYNC_READAHEAD;
+    for (int i = 0; i < req->readahead_count; i++) {
+        struct io_uring_sqe *sqe = next_sqe();
+        if (!sqe) {
+            req->pending++;
+            return;
+        }
+        sqe->opcode = IORING_OP_FADVISE;
+        sqe->fd = req->fd;
+        sqe->off = req->readahead[i].offset;
+        // 0 : jusqu'à la fin du fichier
+        sqe->len = req->readahead[i].len > UINT32_MAX ? 0 : (uint32_t) req->readahead[i].len;
+        sqe->fadvise_advice = POSIX_FADV_WILLNEED;
+        sqe->user_data = (uintptr_t) req;
+        req->pending++;
+    }
+}
+
+// Fait avancer req d'une étape ; les requêtes prêtes à projeter vont dans *ready
+static void on_completion(dl_async_t *req, int res, dl_async_t **ready) {
+    switch (req->state) {
+        case ASYNC_OPENING:
+            if (res < 0) {
+                fail(req, -res, "open failed");
+                return;
+            }
+            req->fd = res;
+            submit_header_read(req);
+            return;
+
+        case ASYNC_READING_HEADER:
+            if (res < 0) {
+                fail(req, -res, "read failed");
+                return;
+            }
+            if (plan_readahead(req, (size_t) res) != 0) {
+                fail(req, 0, NULL);
+                return;
+            }
+            submit_readahead(req);
+            if (req->pending > 0) {
+                return;
+            }
+            break;
+
+        case ASYNC_READAHEAD:
+            // Simple conseil : un échec ne compromet pas le chargement
+            if (--req->pending > 0) {
+                return;
+            }
+            break;
+
+        default:
+            debug_error("Complétion inattendue");
+            return;
+    }
+    req->next = *ready;
+    *ready = req;
+}
+
+static void *sync_worker(void *arg);
+
+/*
+ * io_uring_enter refuse de servir l'anneau (EINTR et file pleine sont
+ * traités par uring_submit_and_wait) : les requêtes en vol échouent, les
+ * suivantes passent par les E/S synchrones.
+ */
+static void *abandon_ring(void) {
+    errno = ring_error;
+    perror("io_uring_enter failed");
+    debug_warn("Anneau io_uring abandonné : E/S synchrones sur le thread du loader");
+    uring_destroy(&ring);
+    while (inflight) {
+        fail(inflight, ring_error, NULL);
+    }
+    return sync_worker(NULL);
+}
+
+static void *ring_worker(void *arg) {
+    (void) arg;
+    uint64_t wake_value;
+    arm_wake(&wake_value);
+    for (;;) {
+        if (!ring_error && uring_submit_and_wait(&ring, 1) != 0) {
+            ring_error = errno;
+        }
+        if (ring_error) {
+            return abandon_ring();
+        }
+
+        dl_async_t *ready = NULL;
+        struct io_uring_cqe *cqe;
+        while ((cqe = uring_peek_cqe(&ring)) != NULL) {
+            uint64_t tag = cqe->user_data;
+            int res = cqe->res;
+            uring_cqe_seen(&ring);
+            if (tag == ASYNC_WAKE_TAG) {
+                arm_wake(&wake_value);
+                for (dl_async_t *req = take_queue(), *next; req; req = next) {
+                    next = req->next;
+                    submit_open(req);
+                }
+                continue;
+            }
+            on_completion((dl_async_t *) (uintptr_t) tag, res, &ready);
+        }
+
+        // Les E/S des autres requêtes continuent pendant les projections
+        while (ready) {
+            dl_async_t *next = ready->next;
+            finish_request(ready);
+            ready = next;
+        }
+    }
+    return NULL;
+}
+
+// Sans io_uring : mêmes étapes, synchrones, sur le thread du loader
+static void run_sync(dl_async_t *req) {
+    req->fd = open(req->path, O_RDONLY | O_CLOEXEC);
+    if (req->fd < 0) {
+        fail(req, errno, "open failed");
+        return;
+    }
+    ssize_t n = pread(req->fd, req->header, ASYNC_HEADER_SIZE, 0);
+    if (n < 0) {
+        fail(req, errno, "read failed");
+        return;
+    }
+    if (plan_readahead(req, (size_t) n) != 0) {
+        fail(req, 0, NULL);
+        return;
+    }
+    for (int i = 0; i < req->readahead_count; i++) {
+        posix_fadvise(req->fd, req->readahead[i].offset, req->readahead[i].len,
+                      POSIX_FADV_WILLNEED);
+    }
+    finish_request(req);
+}
+
+// La file est vidée avant d'attendre : ring_worker a pu y laisser des requêtes
+static void *sync_worker(void *arg) {
+    (void) arg;
+    for (;;) {
+        for (dl_async_t *req = take_queue(), *next; req; req = next) {
+            next = req->next;
+            run_sync(req);
+        }
+        uint64_t value;
+        if (read(wake_fd, &value, sizeof(value)) < 0 && errno != EINTR) {
+            perror("read failed");
+        }
+    }
+    return NULL;
+}
+
+static void worker_start(void) {
+    wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        perror("eventfd failed");
+        return;
+    }
+    ring_ok = uring_init(&ring, ASYNC_RING_ENTRIES) == 0;
+    if (ring_ok && uring_probe(&ring, ring_ops, sizeof(ring_ops)) != 0) {
+        uring_destroy(&ring);
+        ring_ok = 0;
+    }
+    if (!ring_ok) {
+        debug_warn("io_uring indisponible : E/S synchrones sur le thread du loader");
+    }
+
+    // Les signaux restent pour les threads de l'application
+    sigset_t all, saved;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &saved);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_t thread;
+    worker_ok = pthread_create(&thread, &attr, ring_ok ? ring_worker : sync_worker, NULL) == 0;
+    pthread_attr_destroy(&attr);
+    pthread_sigmask(SIG_SETMASK, &saved, NULL);
+    if (!worker_ok) {
+        debug_error("Impossible de démarrer le thread du loader");
+    }
+}
+
+/**
+ * @brief Confie le chargement de path au thread du loader.
+ *
+ * @return la requête, ou NULL si elle n'a pas pu être soumise.
+ */
+dl_async_t *async_load_start(const char *path, int flags, async_finish_fn finish) {
+    pthread_once(&worker_once, worker_start);
+    if (!worker_ok) {
+        return NULL;
+    }
+
+    dl_async_t *req = calloc(1, sizeof(dl_async_t));
+    if (!req) {
+        perror("calloc failed");
+        return NULL;
+    }
+    req->path = strdup(path);
+    req->done_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (!req->path || req->done_fd < 0) {
+        perror("async request setup failed");
+        free(req->path);
+        if (req->done_fd >= 0) {
+            close(req->done_fd);
+        }
+        free(req);
+        return NULL;
+    }
+    req->flags = flags;
+    req->finish = finish;
+    req->fd = -1;
+    req->state = ASYNC_QUEUED;
+
+    pthread_mutex_lock(&queue_lock);
+    if (queue_tail) {
+        queue_tail->next = req;
+    } else {
+        queue_head = req;
+    }
+    queue_tail = req;
+    pthread_mutex_unlock(&queue_lock);
+
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) != sizeof(one)) {
+        perror("write failed");
+    }
+    return req;
+}
+
+int async_load_done(dl_async_t *req) {
+    return __atomic_load_n(&req->done, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Attend la fin de req, la libère et retourne son handle.
+ */
+void *async_load_wait(dl_async_t *req) {
+    struct pollfd pfd = {.fd = req->done_fd, .events = POLLIN};
+    // done_fd devient lisible juste avant la publication de done
+    while (!async_load_done(req)) {
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) {
+            perror("poll failed");
+        }
+    }
+    void *handle = req->handle;
+    close(req->done_fd);
+    free(req->path);
+    free(req);
+    return handle;
+}
@@ -0,0 +1,33 @@
+#include "bloom.h"
+
+// Second bit tiré au-dessus des bits qui choisissent le mot
+#define BLOOM_SHIFT 20
+
+/**
+ * @brief Alloue dans l'arène un filtre vide pour count symboles.
+ *
+ * @return 0 en cas de succès, -1 si l'allocation échoue.
+ */
+int bloom_init(bloom_t *bloom, arena_t *arena, size_t count) {
+    size_t words = 1;
+    while (words * 64 < count * BLOOM_BITS_PER_SYMBOL) {
+        words <<= 1;
+    }
+    bloom->words = arena_calloc(arena, words, sizeof(uint64_t));
+    bloom->mask = bloom->words ? words - 1 : 0;
+    return bloom->words ? 0 : -1;
+}
+
+void bloom_add(bloom_t *bloom, uint32_t hash) {
+    bloom->words[(hash >> 6) & bloom->mask] |=
+            (1ull << (hash & 63)) | (1ull << ((hash >> BLOOM_SHIFT) & 63));
+}
+
+// 0 : le nom n'est sûrement pas exporté ; 1 : il l'est peut-être
+int bloom_maybe(const bloom_t *bloom, uint32_t hash) {
+    if (!bloom->words) {
+        return 1;
+    }
+    uint64_t bits = (1ull << (hash & 63)) | (1ull << ((hash >> BLOOM_SHIFT) & 63));
+    return (bloom->words[(hash >> 6) & bloom->mask] & bits) == bits;
+}
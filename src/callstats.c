@@ -0,0 +1,388 @@
+#define _GNU_SOURCE
+#include "callstats.h"
+#include "debug.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(callstats_line) == 64, "one cache line per import and thread");
+_Static_assert(offsetof(callstats_line, calls) == CALLSTATS_CALLS_OFF,
+               "isos_call_count depends on the calls offset");
+_Static_assert(offsetof(callstats_line, countdown) == CALLSTATS_COUNTDOWN_OFF,
+               "isos_call_count depends on the countdown offset");
+_Static_assert(offsetof(callstats_entry, target) == CALLSTATS_TARGET_OFF &&
+                       offsetof(callstats_entry, line_offset) == CALLSTATS_LINE_OFF,
+               "isos_call_count depends on the callstats_entry layout");
+
+#if defined(__x86_64__)
+// Définis en asm dans utils.c
+void isos_call_count(void);
+void isos_call_return(void);
+#endif
+
+// Appel chronométré en cours : où remettre l'adresse de retour déviée
+typedef struct {
+    void **return_slot;
+    void *return_addr;
+    callstats_line *line;
+    uint64_t start_ns;
+} callstats_frame;
+
+/*
+ * Bloc d'un thread. Les blocs ne sont jamais libérés : à la sortie d'un
+ * thread le sien est repris par le suivant, ses compteurs continuent
+ * donc de compter dans les totaux.
+ */
+typedef struct callstats_thread {
+    callstats_line *lines;
+    struct callstats_thread *next;
+    int in_use;
+    int depth;
+    callstats_frame frames[CALLSTATS_MAX_DEPTH];
+} callstats_thread;
+
+// Lu par isos_call_count : modèle initial-exec, un seul accès %fs
+__thread callstats_line *isos_callstats_lines __attribute__((tls_model("initial-exec")));
+static __thread callstats_thread *callstats_self;
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static callstats_thread *threads;
+static unsigned char slot_used[CALLSTATS_MAX_SLOTS];
+static pthread_key_t thread_key;
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;
+static uint32_t callstats_period = CALLSTATS_DEFAULT_PERIOD;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+// Sortie d'un thread : son bloc redevient disponible
+static void thread_exit(void *arg) {
+    callstats_thread *t = arg;
+    // Un appel chronométré encore ouvert reviendra par ce bloc
+    if (t->depth > 0) {
+        return;
+    }
+    isos_callstats_lines = NULL;
+    callstats_self = NULL;
+    __atomic_store_n(&t->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void thread_key_init(void) {
+    if (pthread_key_create(&thread_key, thread_exit) != 0) {
+        debug_error("pthread_key_create failed");
+    }
+}
+
+// Premier appel profilé du thread : bloc libre ou nouveau bloc
+static callstats_thread *thread_attach(void) {
+    pthread_once(&thread_key_once, thread_key_init);
+    pthread_mutex_lock(&registry_lock);
+    callstats_thread *t = threads;
+    while (t && __atomic_load_n(&t->in_use, __ATOMIC_ACQUIRE)) {
+        t = t->next;
+    }
+    if (!t) {
+        t = calloc(1, sizeof(callstats_thread));
+        void *lines = t ? mmap(NULL, CALLSTATS_MAX_SLOTS * sizeof(callstats_line),
+                               PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                               -1, 0)
+                        : MAP_FAILED;
+        if (lines == MAP_FAILED) {
+            perror("callstats block allocation failed");
+            free(t);
+            pthread_mutex_unlock(&registry_lock);
+            return NULL;
+        }
+        t->lines = lines;
+        t->next = threads;
+        threads = t;
+    }
+    t->in_use = 1;
+    t->depth = 0;
+    pthread_mutex_unlock(&registry_lock);
+
+    pthread_setspecific(thread_key, t);
+    callstats_self = t;
+    isos_callstats_lines = t->lines;
+    return t;
+}
+
+/**
+ * @brief Chemin lent d'un stub : premier appel profilé du thread, ou
+ *        décompte épuisé. Dans ce dernier cas l'appel est chronométré :
+ *        *return_slot (adresse de retour de l'appelant) est remplacée par
+ *        isos_call_return.
+ *
+ * @return la cible vers laquelle le stub saute.
+ */
+void *callstats_slow(callstats_entry *entry, void **return_slot) {
+    void *target = __atomic_load_n(&entry->target, __ATOMIC_ACQUIRE);
+    callstats_thread *t = callstats_self;
+    callstats_line *line;
+    if (!t) {
+        t = thread_attach();
+        if (!t) {
+            return target;
+        }
+        // isos_call_count n'a pas encore compté cet appel
+        line = (callstats_line *) ((char *) t->lines + entry->line_offset);
+        line->calls++;
+    } else {
+        line = (callstats_line *) ((char *) t->lines + entry->line_offset);
+    }
+
+    // Ligne neuve (décompte passé sous zéro) : premier appel, chronométré aussi
+    uint32_t period = __atomic_load_n(&callstats_period, __ATOMIC_RELAXED);
+    int expired = line->countdown == 0 || line->countdown == UINT32_MAX;
+    line->countdown = period ? period : CALLSTATS_IDLE_PERIOD;
+    if (!expired || period == 0 || entry->count_only || t->depth == CALLSTATS_MAX_DEPTH) {
+        return target;
+    }
+
+#if defined(__x86_64__)
+    callstats_frame *frame = &t->frames[t->depth++];
+    frame->return_slot = return_slot;
+    frame->return_addr = *return_slot;
+    frame->line = line;
+    *return_slot = (void *) isos_call_return;
+    frame->start_ns = now_ns();
+#else
+    (void) return_slot;
+#endif
+    return target;
+}
+
+/**
+ * @brief Fin d'un appel chronométré.
+ *
+ * @param return_slot : mot de pile qui contenait l'adresse de retour
+ *        déviée. Les cadres plus profonds encore ouverts ont été quittés
+ *        sans revenir (longjmp) et sont abandonnés.
+ * @return la vraie adresse de retour.
+ */
+void *callstats_return(void **return_slot) {
+    uint64_t end = now_ns();
+    callstats_thread *t = callstats_self;
+    while (t && t->depth > 0 && t->frames[t->depth - 1].return_slot < return_slot) {
+        t->depth--;
+    }
+    if (!t || t->depth == 0 || t->frames[t->depth - 1].return_slot != return_slot) {
+        fprintf(stderr, "isos_loader: callstats: lost return address\n");
+        abort();
+    }
+    callstats_frame *frame = &t->frames[--t->depth];
+    callstats_line *line = frame->line;
+    uint64_t elapsed = end - frame->start_ns;
+    if (line->samples == 0 || elapsed < line->min_ns) {
+        line->min_ns = elapsed;
+    }
+    if (elapsed > line->max_ns) {
+        line->max_ns = elapsed;
+    }
+    line->total_ns += elapsed;
+    line->samples++;
+    return frame->return_addr;
+}
+
+// Première plage libre de count lignes, sous registry_lock ; -1 si aucune
+static long slots_alloc(int count) {
+    int run = 0;
+    for (int i = 0; i < CALLSTATS_MAX_SLOTS; i++) {
+        run = slot_used[i] ? 0 : run + 1;
+        if (run == count) {
+            memset(&slot_used[i - count + 1], 1, count);
+            return i - count + 1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Profil d'une image : count lignes par thread et un stub par
+ *        import, dans une page exécutable propre à l'image.
+ *
+ * @return le profil, ou NULL (plus de lignes libres, architecture sans
+ *         stubs) : l'image est alors chargée sans profil.
+ */
+callstats_t *callstats_create(int count) {
+#if defined(__x86_64__)
+    if (count <= 0 || count > CALLSTATS_MAX_SLOTS) {
+        return NULL;
+    }
+    callstats_t *cs = calloc(1, sizeof(callstats_t));
+    callstats_entry *entries = calloc(count, sizeof(callstats_entry));
+    if (!cs || !entries) {
+        perror("callstats allocation failed");
+        free(cs);
+        free(entries);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&registry_lock);
+    long first = slots_alloc(count);
+    pthread_mutex_unlock(&registry_lock);
+    if (first < 0) {
+        debug_warn("callstats: plus de compteurs libres");
+        free(cs);
+        free(entries);
+        return NULL;
+    }
+
+    size_t page_size = getpagesize();
+    size_t size = (count * CALLSTATS_STUB_SIZE + page_size - 1) & ~(page_size - 1);
+    unsigned char *stubs = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (stubs == MAP_FAILED) {
+        perror("callstats stubs mmap failed");
+        cs->first_slot = first;
+        cs->count = count;
+        cs->entries = entries;
+        callstats_destroy(cs);
+        return NULL;
+    }
+    memset(stubs, 0xcc, size);
+
+    // movabs $entrée, %r11 ; movabs $isos_call_count, %r10 ; jmp *%r10
+    uint64_t counter = (uint64_t) isos_call_count;
+    for (int id = 0; id < count; id++) {
+        unsigned char *stub = stubs + id * CALLSTATS_STUB_SIZE;
+        uint64_t entry = (uint64_t) &entries[id];
+        entries[id].line_offset = (first + id) * sizeof(callstats_line);
+        stub[0] = 0x49;
+        stub[1] = 0xbb;
+        memcpy(stub + 2, &entry, 8);
+        stub[10] = 0x49;
+        stub[11] = 0xba;
+        memcpy(stub + 12, &counter, 8);
+        stub[20] = 0x41;
+        stub[21] = 0xff;
+        stub[22] = 0xe2;
+    }
+    if (mprotect(stubs, size, PROT_READ | PROT_EXEC) != 0) {
+        perror("callstats stubs mprotect failed");
+        munmap(stubs, size);
+        stubs = NULL;
+    }
+
+    cs->count = count;
+    cs->first_slot = first;
+    cs->entries = entries;
+    cs->stubs = stubs;
+    cs->stubs_size = size;
+    if (!stubs) {
+        callstats_destroy(cs);
+        return NULL;
+    }
+    return cs;
+#else
+    (void) count;
+    debug_warn("callstats: stubs non disponibles sur cette architecture");
+    return NULL;
+#endif
+}
+
+/**
+ * @brief Liaison de l'import id à target.
+ *
+ * @return l'adresse à écrire dans le slot (plt_bound, GOT) : le stub de
+ *         l'import, ou target elle-même sans profil.
+ */
+void *callstats_bind(callstats_t *cs, int id, void *target) {
+    if (!cs || !target || id < 0 || id >= cs->count) {
+        return target;
+    }
+    __atomic_store_n(&cs->entries[id].target, target, __ATOMIC_RELEASE);
+    return cs->stubs + id * CALLSTATS_STUB_SIZE;
+}
+
+/**
+ * @brief L'import id n'est plus que compté : son adresse de retour n'est
+ *        jamais déviée.
+ */
+void callstats_set_count_only(callstats_t *cs, int id) {
+    if (cs && id >= 0 && id < cs->count) {
+        cs->entries[id].count_only = 1;
+    }
+}
+
+/**
+ * @brief Vrai pour les fonctions qui peuvent revenir deux fois par la
+ *        même adresse de retour. Chronométrées, leur second retour
+ *        trouverait le cadre déjà dépilé par le premier.
+ */
+int callstats_returns_twice(const char *name) {
+    static const char *const names[] = {
+        "setjmp", "_setjmp", "__setjmp", "sigsetjmp", "__sigsetjmp", "savectx",
+        "vfork", "__vfork", "getcontext", "swapcontext",
+    };
+    for (size_t i = 0; name && i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Cumule les lignes de l'import id sur tous les threads (name
+ *        n'est pas rempli).
+ *
+ * @return 0, -1 si id est hors du profil.
+ */
+int callstats_collect(const callstats_t *cs, int id, import_stats_t *out) {
+    if (!cs || id < 0 || id >= cs->count) {
+        return -1;
+    }
+    memset(out, 0, sizeof(*out));
+    pthread_mutex_lock(&registry_lock);
+    for (callstats_thread *t = threads; t; t = t->next) {
+        const callstats_line *line = &t->lines[cs->first_slot + id];
+        uint64_t samples = __atomic_load_n(&line->samples, __ATOMIC_RELAXED);
+        out->calls += __atomic_load_n(&line->calls, __ATOMIC_RELAXED);
+        if (samples == 0) {
+            continue;
+        }
+        uint64_t min_ns = __atomic_load_n(&line->min_ns, __ATOMIC_RELAXED);
+        uint64_t max_ns = __atomic_load_n(&line->max_ns, __ATOMIC_RELAXED);
+        if (out->samples == 0 || min_ns < out->min_ns) {
+            out->min_ns = min_ns;
+        }
+        if (max_ns > out->max_ns) {
+            out->max_ns = max_ns;
+        }
+        out->samples += samples;
+        out->total_ns += __atomic_load_n(&line->total_ns, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&registry_lock);
+    return 0;
+}
+
+// Lignes remises à zéro dans tous les blocs avant d'être rendues
+void callstats_destroy(callstats_t *cs) {
+    if (!cs) {
+        return;
+    }
+    pthread_mutex_lock(&registry_lock);
+    for (callstats_thread *t = threads; t; t = t->next) {
+        memset(&t->lines[cs->first_slot], 0, cs->count * sizeof(callstats_line));
+    }
+    memset(&slot_used[cs->first_slot], 0, cs->count);
+    pthread_mutex_unlock(&registry_lock);
+    if (cs->stubs) {
+        munmap(cs->stubs, cs->stubs_size);
+    }
+    free(cs->entries);
+    free(cs);
+}
+
+// Un appel chronométré tous les period appels d'un import et d'un thread (0 : aucun)
+void callstats_set_period(uint32_t period) {
+    __atomic_store_n(&callstats_period, period, __ATOMIC_RELAXED);
+}
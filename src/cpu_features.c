@@ -0,0 +1,60 @@
+#include "cpu_features.h"
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+// Détectées une seule fois, puis partagées par tous les chargements
+static isos_cpu_features_t g_cpu_features;
+static int g_cpu_features_ready = 0;
+
+/**
+ * @brief Retourne les capacités du CPU courant, détectées au premier appel.
+ *
+ * @return Pointeur vers une structure statique (jamais NULL).
+ */
+const isos_cpu_features_t *isos_cpu_features(void) {
+    if (__atomic_load_n(&g_cpu_features_ready, __ATOMIC_ACQUIRE)) {
+        return &g_cpu_features;
+    }
+
+    uint32_t flags = 0;
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))   flags |= ISOS_CPU_SSE42;
+    if (__builtin_cpu_supports("avx"))      flags |= ISOS_CPU_AVX;
+    if (__builtin_cpu_supports("avx2"))     flags |= ISOS_CPU_AVX2;
+    if (__builtin_cpu_supports("fma"))      flags |= ISOS_CPU_FMA;
+    if (__builtin_cpu_supports("bmi2"))     flags |= ISOS_CPU_BMI2;
+    if (__builtin_cpu_supports("avx512f"))  flags |= ISOS_CPU_AVX512F;
+    if (__builtin_cpu_supports("avx512bw")) flags |= ISOS_CPU_AVX512BW;
+    if (__builtin_cpu_supports("avx512vl")) flags |= ISOS_CPU_AVX512VL;
+#endif
+
+    g_cpu_features.size = sizeof(isos_cpu_features_t);
+    g_cpu_features.flags = flags;
+    __atomic_store_n(&g_cpu_features_ready, 1, __ATOMIC_RELEASE);
+    return &g_cpu_features;
+}
+
+uint32_t isos_xsave_size;
+
+/*
+ * Zone de sauvegarde des trampolines : SSE, AVX (moitiés hautes des ymm)
+ * et AVX-512 (k0-7, moitiés hautes des zmm, zmm16-31), comme
+ * _dl_runtime_resolve_xsave. Sans XSAVE activé par le noyau, les
+ * trampolines se contentent de FXSAVE (xmm0-15).
+ */
+__attribute__((constructor)) static void xsave_size_init(void) {
+#if defined(__x86_64__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) ||
+        __get_cpuid_max(0, 0) < 0xd) {
+        return;
+    }
+    // EBX : taille requise par les composantes activées dans XCR0
+    __cpuid_count(0xd, 0, eax, ebx, ecx, edx);
+    if (ebx >= ISOS_FXSAVE_SIZE + 64) {
+        isos_xsave_size = (ebx + 63) & ~63u;
+    }
+#endif
+}
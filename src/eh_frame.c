@@ -0,0 +1,163 @@
+#define _GNU_SOURCE
+#include "eh_frame.h"
+#include "debug.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Encodages DW_EH_PE_* utilisés par l'en-tête .eh_frame_hdr
+#define DW_EH_PE_absptr  0x00
+#define DW_EH_PE_udata4  0x03
+#define DW_EH_PE_udata8  0x04
+#define DW_EH_PE_sdata4  0x0b
+#define DW_EH_PE_sdata8  0x0c
+#define DW_EH_PE_pcrel   0x10
+#define DW_EH_PE_datarel 0x30
+
+#define EH_FRAME_HDR_VERSION 1
+// version, eh_frame_ptr_enc, fde_count_enc, table_enc
+#define EH_FRAME_HDR_SIZE    4
+
+typedef void (*register_frame_fn)(const void *, void *, void *, void *);
+typedef void *(*deregister_frame_fn)(const void *);
+
+/**
+ * @brief Lit une valeur encodée de .eh_frame_hdr et avance *p.
+ *
+ * @return 0, ou -1 pour un encodage non géré.
+ */
+static int read_encoded(uint8_t encoding, const uint8_t **p, const uint8_t *hdr,
+                        uintptr_t *out) {
+    const uint8_t *pos = *p;
+    uintptr_t value;
+    switch (encoding & 0x0f) {
+        case DW_EH_PE_absptr:
+        case DW_EH_PE_udata8:
+        case DW_EH_PE_sdata8: {
+            uint64_t v;
+            memcpy(&v, pos, sizeof(v));
+            value = v;
+            *p += sizeof(v);
+            break;
+        }
+        case DW_EH_PE_udata4: {
+            uint32_t v;
+            memcpy(&v, pos, sizeof(v));
+            value = v;
+            *p += sizeof(v);
+            break;
+        }
+        case DW_EH_PE_sdata4: {
+            int32_t v;
+            memcpy(&v, pos, sizeof(v));
+            value = (uintptr_t) (intptr_t) v;
+            *p += sizeof(v);
+            break;
+        }
+        default:
+            return -1;
+    }
+    switch (encoding & 0x70) {
+        case DW_EH_PE_absptr:
+            break;
+        case DW_EH_PE_pcrel:
+            value += (uintptr_t) pos;
+            break;
+        case DW_EH_PE_datarel:
+            value += (uintptr_t) hdr;
+            break;
+        default:
+            return -1;
+    }
+    *out = value;
+    return 0;
+}
+
+// .eh_frame confié à libgcc, qui le triera au premier lancer qui le traverse
+static int register_frames(eh_frame_reg_t *reg) {
+    register_frame_fn register_frame =
+        (register_frame_fn) dlsym(RTLD_DEFAULT, "__register_frame_info_bases");
+    if (!register_frame) {
+        debug_info("Pas d'unwinder chargé : tables de déroulement ignorées");
+        return 0;
+    }
+
+    const uint8_t *p = reg->eh_frame_hdr + EH_FRAME_HDR_SIZE;
+    uintptr_t eh_frame;
+    if (read_encoded(reg->eh_frame_hdr[1], &p, reg->eh_frame_hdr, &eh_frame) != 0 ||
+        eh_frame < reg->start || eh_frame >= reg->end) {
+        debug_warn("Pointeur .eh_frame illisible : tables de déroulement ignorées");
+        return -1;
+    }
+
+    reg->object = calloc(1, EH_FRAME_OBJECT_SIZE);
+    if (!reg->object) {
+        perror("Failed to allocate the unwinder object");
+        return -1;
+    }
+    reg->eh_frame = (const void *) eh_frame;
+    register_frame(reg->eh_frame, reg->object, NULL, NULL);
+    return 0;
+}
+
+/**
+ * @brief Rend les tables de déroulement d'une image chargée visibles de
+ *        l'unwinder. Une image sans PT_GNU_EH_FRAME n'a rien à faire.
+ *
+ * @param base_addr : adresse de chargement (p_vaddr 0).
+ * @return 0 (enregistrée, ou rien à enregistrer), -1 si la table est
+ *         invalide ; l'image reste utilisable sans exceptions.
+ */
+int eh_frame_register(eh_frame_reg_t *reg, void *base_addr, const elf_phdr *phdrs, int phnum) {
+    memset(reg, 0, sizeof(*reg));
+
+    const elf_phdr *eh = NULL;
+    for (int i = 0; i < phnum; i++) {
+        if (phdrs[i].p_type == PT_GNU_EH_FRAME) {
+            eh = &phdrs[i];
+        }
+    }
+    if (!eh) {
+        return 0;
+    }
+
+    // .eh_frame_hdr et .eh_frame sont dans le segment lisible qui contient
+    // l'en-tête (les trous entre segments ne sont pas projetés)
+    const elf_phdr *seg = NULL;
+    for (int i = 0; i < phnum && !seg; i++) {
+        if (phdrs[i].p_type == PT_LOAD && (phdrs[i].p_flags & PF_R) &&
+            eh->p_vaddr >= phdrs[i].p_vaddr &&
+            eh->p_vaddr - phdrs[i].p_vaddr < phdrs[i].p_memsz) {
+            seg = &phdrs[i];
+        }
+    }
+    uintptr_t start = seg ? (uintptr_t) base_addr + seg->p_vaddr : 0;
+    uintptr_t end = seg ? start + seg->p_memsz : 0;
+    const uint8_t *hdr = (const uint8_t *) base_addr + eh->p_vaddr;
+    if (!seg || eh->p_memsz < EH_FRAME_HDR_SIZE || eh->p_memsz > end - (uintptr_t) hdr ||
+        hdr[0] != EH_FRAME_HDR_VERSION) {
+        debug_warn("PT_GNU_EH_FRAME invalide : tables de déroulement ignorées");
+        return -1;
+    }
+    reg->start = start;
+    reg->end = end;
+    reg->eh_frame_hdr = hdr;
+    return register_frames(reg);
+}
+
+/**
+ * @brief Retire les tables d'une image avant son démontage.
+ */
+void eh_frame_deregister(eh_frame_reg_t *reg) {
+    if (!reg->object) {
+        return;
+    }
+    deregister_frame_fn deregister_frame =
+        (deregister_frame_fn) dlsym(RTLD_DEFAULT, "__deregister_frame_info_bases");
+    if (deregister_frame) {
+        deregister_frame(reg->eh_frame);
+    }
+    free(reg->object);
+    reg->object = NULL;
+}
@@ -1,9 +1,14 @@
 #include "elf_parser.h"
+#include "isosz.h"
+#include "debug.h"
 #include <stdio.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 int read_elf_header(const char *filename, elf_header *hdr) {
     int fd = open(filename, O_RDONLY);
@@ -56,7 +61,477 @@ int read_program_headers(int fd, elf_header *hdr, elf_phdr **phdrs) {
     return 0;
 }
 
-int check_valid_lib(elf_header *hdr) {
+/**
+ * @brief Vue bornée dans le fichier projeté.
+ *
+ * @return un pointeur sur [offset, offset + size) ou NULL si la zone
+ *         déborde du fichier (débordements arithmétiques compris).
+ */
+const void *elf_view(const elf_file *elf, uint64_t offset, uint64_t size) {
+    if (!elf->data || offset > elf->size || size > elf->size - offset) {
+        return NULL;
+    }
+    return elf->data + offset;
+}
+
+/**
+ * @brief Chaîne d'une table de chaînes, garantie terminée par '\0' à
+ *        l'intérieur de la table.
+ */
+const char *elf_string(const char *table, size_t table_size, uint64_t offset) {
+    if (!table || offset >= table_size) {
+        return NULL;
+    }
+    if (!memchr(table + offset, '\0', table_size - offset)) {
+        return NULL;
+    }
+    return table + offset;
+}
+
+/**
+ * @brief Cherche la note NT_GNU_BUILD_ID dans les segments PT_NOTE.
+ *
+ * @return 0 si trouvée (id pointe dans la projection), -1 sinon.
+ */
+int elf_build_id(const elf_file *elf, const uint8_t **id, size_t *len) {
+    for (size_t i = 0; i < elf->phnum; i++) {
+        const elf_phdr *ph = &elf->phdrs[i];
+        if (ph->p_type != PT_NOTE) {
+            continue;
+        }
+        const uint8_t *note = elf_view(elf, ph->p_offset, ph->p_filesz);
+        uint64_t pos = 0;
+        while (note && pos + 12 <= ph->p_filesz) {
+            uint32_t namesz, descsz, type;
+            memcpy(&namesz, note + pos, 4);
+            memcpy(&descsz, note + pos + 4, 4);
+            memcpy(&type, note + pos + 8, 4);
+            uint64_t name_pos = pos + 12;
+            uint64_t desc_pos = name_pos + ((namesz + 3ull) & ~3ull);
+            uint64_t next = desc_pos + ((descsz + 3ull) & ~3ull);
+            if (next > ph->p_filesz) {
+                break;
+            }
+            if (type == NT_GNU_BUILD_ID && namesz == 4 &&
+                memcmp(note + name_pos, "GNU", 4) == 0) {
+                *id = note + desc_pos;
+                *len = descsz;
+                return 0;
+            }
+            pos = next;
+        }
+    }
+    return -1;
+}
+
+// Remplit l'identité du fichier (stat + build-id)
+void elf_identity_fill(const elf_file *elf, elf_identity *identity) {
+    memset(identity, 0, sizeof(*identity));
+    struct stat st;
+    if (fstat(elf->fd, &st) == 0) {
+        identity->dev = st.st_dev;
+        identity->ino = st.st_ino;
+        identity->size = st.st_size;
+        identity->mtime_sec = st.st_mtim.tv_sec;
+        identity->mtime_nsec = st.st_mtim.tv_nsec;
+    }
+
+    const uint8_t *id;
+    size_t len;
+    if (elf_build_id(elf, &id, &len) == 0 && len <= ELF_BUILD_ID_MAX) {
+        identity->build_id_len = len;
+        memcpy(identity->build_id, id, len);
+    }
+}
+
+/**
+ * @return 1 si les deux identités désignent le même fichier : même
+ *         build-id s'il existe des deux côtés, sinon même périphérique,
+ *         inode, taille et date de modification.
+ */
+int elf_identity_match(const elf_identity *a, const elf_identity *b) {
+    if (a->build_id_len > ELF_BUILD_ID_MAX || b->build_id_len > ELF_BUILD_ID_MAX) {
+        return 0;
+    }
+    if (a->build_id_len > 0 && b->build_id_len > 0) {
+        return a->build_id_len == b->build_id_len &&
+               memcmp(a->build_id, b->build_id, a->build_id_len) == 0;
+    }
+    return a->dev == b->dev && a->ino == b->ino && a->size == b->size &&
+           a->mtime_sec == b->mtime_sec && a->mtime_nsec == b->mtime_nsec;
+}
+
+/*
+ * Symbole de .dynsym exporté au sens du loader : fonction ou objet
+ * global ou faible, défini et visible. Les IFUNC en sont exclus (leur
+ * résolveur peut dépendre de ld.so).
+ */
+int elf_sym_exported(const Elf64_Sym *sym) {
+    int type = ELF64_ST_TYPE(sym->st_info);
+    int bind = ELF64_ST_BIND(sym->st_info);
+    return sym->st_shndx != SHN_UNDEF && (type == STT_FUNC || type == STT_OBJECT) &&
+           (bind == STB_GLOBAL || bind == STB_WEAK) &&
+           ELF64_ST_VISIBILITY(sym->st_other) != STV_HIDDEN;
+}
+
+// Vue sur un tableau de count éléments de taille entsize
+static const void *elf_array(const elf_file *elf, uint64_t offset, uint64_t count,
+                             uint64_t entsize) {
+    if (entsize != 0 && count > UINT64_MAX / entsize) {
+        return NULL;
+    }
+    const void *view = elf_view(elf, offset, count * entsize);
+    // Les structures sont lues en place : l'alignement doit être respecté
+    if (view && ((uintptr_t) view % 8) != 0) {
+        return NULL;
+    }
+    return view;
+}
+
+/*
+ * Segments PT_LOAD, vérifiés au fil du même passage sur les phdrs :
+ * adresses croissantes, sans chevauchement, au moins un segment, et l'un
+ * d'eux couvre les program headers.
+ */
+typedef struct {
+    const elf_phdr *prev;
+    size_t count;
+    int phdrs_covered;
+} load_check;
+
+static int check_load_segment(load_check *check, const elf_header *hdr, const elf_phdr *ph) {
+    if (ph->p_filesz > ph->p_memsz) {
+        debug_error("PT_LOAD file size larger than memory size");
+        return -1;
+    }
+    // Fin de segment calculée partout (étendue, BSS, bornes des tables)
+    if (ph->p_vaddr > UINT64_MAX - HUGE_PAGE_SIZE ||
+        ph->p_memsz > UINT64_MAX - HUGE_PAGE_SIZE - ph->p_vaddr) {
+        debug_error("PT_LOAD memory range overflows");
+        return -1;
+    }
+    if (check->prev && ph->p_vaddr < check->prev->p_vaddr) {
+        printf("Error: PT_LOAD segments not in ascending order\n");
+        return -1;
+    }
+    if (check->prev && ph->p_vaddr < check->prev->p_vaddr + check->prev->p_memsz) {
+        printf("Error: PT_LOAD segments overlap in memory\n");
+        return -1;
+    }
+    // mmap() du segment : même décalage dans la page côté fichier et mémoire
+    if ((ph->p_vaddr - ph->p_offset) % (uint64_t) getpagesize() != 0) {
+        debug_error("PT_LOAD offset and address not congruent modulo the page size");
+        return -1;
+    }
+    uint64_t phdr_end = hdr->e_phoff + (uint64_t) hdr->e_phnum * hdr->e_phentsize;
+    if (ph->p_offset <= hdr->e_phoff && ph->p_offset + ph->p_filesz >= phdr_end) {
+        check->phdrs_covered = 1;
+    }
+    check->prev = ph;
+    check->count++;
+    return 0;
+}
+
+/**
+ * @brief Passe unique d'analyse du fichier projeté.
+ *
+ * Remplit les vues de elf (phdrs, shdrs, PT_DYNAMIC, .dynsym, .dynstr).
+ * Sauf si trusted, vérifie en même temps l'en-tête, que chaque table tient
+ * dans le fichier et la disposition des segments PT_LOAD : une image
+ * incohérente est rejetée avant toute projection de segment. trusted ne
+ * sert que pour un fichier déjà validé (cf. elf_open_fd()).
+ *
+ * @return 0 si le fichier est valide, -1 sinon.
+ */
+static int elf_parse(elf_file *elf, int trusted) {
+    static const unsigned char magic[4] = {ELF_MAGIC0, ELF_MAGIC1, ELF_MAGIC2, ELF_MAGIC3};
+
+    if (!trusted) {
+        if (elf->size < sizeof(magic) || memcmp(elf->data, magic, sizeof(magic)) != 0) {
+            printf("Not an ELF file\n");
+            return -1;
+        }
+        if (elf->size < sizeof(elf_header)) {
+            debug_error("Truncated ELF header");
+            return -1;
+        }
+    }
+    elf->hdr = (const elf_header *) elf->data;
+    if (!trusted && check_valid_lib(elf->hdr) != 0) {
+        return -1;
+    }
+
+    // Program headers
+    if (elf->hdr->e_phentsize != sizeof(elf_phdr)) {
+        debug_error("Program header size mismatch");
+        return -1;
+    }
+    elf->phnum = elf->hdr->e_phnum;
+    elf->phdrs = elf_array(elf, elf->hdr->e_phoff, elf->phnum, sizeof(elf_phdr));
+    if (!elf->phdrs) {
+        debug_error("Program headers out of file bounds");
+        return -1;
+    }
+    load_check load = {0};
+    for (size_t i = 0; i < elf->phnum; i++) {
+        const elf_phdr *ph = &elf->phdrs[i];
+        if (!trusted) {
+            if (ph->p_type == PT_LOAD && check_load_segment(&load, elf->hdr, ph) != 0) {
+                return -1;
+            }
+            if ((ph->p_type == PT_LOAD || ph->p_type == PT_DYNAMIC) &&
+                !elf_view(elf, ph->p_offset, ph->p_filesz)) {
+                debug_error("Segment out of file bounds");
+                return -1;
+            }
+        }
+        if (ph->p_type == PT_DYNAMIC) {
+            elf->dyn_count = ph->p_filesz / sizeof(Elf64_Dyn);
+            elf->dynamic = elf_array(elf, ph->p_offset, elf->dyn_count, sizeof(Elf64_Dyn));
+            if (!elf->dynamic) {
+                elf->dyn_count = 0;
+            }
+        }
+    }
+    if (!trusted && load.count == 0) {
+        printf("Error: No PT_LOAD segments found in library\n");
+        return -1;
+    }
+    if (!trusted && !load.phdrs_covered) {
+        printf("Error: No PT_LOAD segment spans all program headers\n");
+        return -1;
+    }
+
+    // Section headers (facultatifs pour le chargement)
+    if (elf->hdr->e_shnum == 0) {
+        return 0;
+    }
+    if (elf->hdr->e_shentsize != sizeof(Elf64_Shdr)) {
+        debug_error("Section header size mismatch");
+        return -1;
+    }
+    elf->shnum = elf->hdr->e_shnum;
+    elf->shdrs = elf_array(elf, elf->hdr->e_shoff, elf->shnum, sizeof(Elf64_Shdr));
+    if (!elf->shdrs) {
+        debug_error("Section headers out of file bounds");
+        return -1;
+    }
+    for (size_t i = 0; !trusted && i < elf->shnum; i++) {
+        const Elf64_Shdr *sh = &elf->shdrs[i];
+        if (sh->sh_type != SHT_NOBITS && !elf_view(elf, sh->sh_offset, sh->sh_size)) {
+            debug_error("Section out of file bounds");
+            return -1;
+        }
+    }
+    if (elf->hdr->e_shstrndx < elf->shnum) {
+        const Elf64_Shdr *sh = &elf->shdrs[elf->hdr->e_shstrndx];
+        elf->shstrtab = elf_view(elf, sh->sh_offset, sh->sh_size);
+        elf->shstrtab_size = elf->shstrtab ? sh->sh_size : 0;
+    }
+
+    // .dynsym et sa table de chaînes (sh_link)
+    for (size_t i = 0; i < elf->shnum; i++) {
+        const Elf64_Shdr *sh = &elf->shdrs[i];
+        if (sh->sh_type != SHT_DYNSYM) {
+            continue;
+        }
+        if (sh->sh_entsize != sizeof(Elf64_Sym) || sh->sh_link >= elf->shnum) {
+            debug_error("Invalid .dynsym section");
+            return -1;
+        }
+        const Elf64_Shdr *str = &elf->shdrs[sh->sh_link];
+        elf->dynsym_count = sh->sh_size / sizeof(Elf64_Sym);
+        elf->dynsym = elf_array(elf, sh->sh_offset, elf->dynsym_count, sizeof(Elf64_Sym));
+        elf->dynstr = elf_view(elf, str->sh_offset, str->sh_size);
+        elf->dynstr_size = str->sh_size;
+        if (!elf->dynsym || !elf->dynstr) {
+            debug_error("Invalid .dynsym section");
+            return -1;
+        }
+        break;
+    }
+    return 0;
+}
+
+int elf_validate(elf_file *elf) {
+    return elf_parse(elf, 0);
+}
+
+/*
+ * Verdicts de validation déjà rendus, par identité de fichier. ctime en
+ * fait partie : toute écriture la met à jour, et elle ne peut pas être
+ * remise en arrière comme mtime. Seuls les verdicts favorables sont gardés.
+ */
+#define VERDICT_CACHE_SIZE 64
+
+typedef struct {
+    uint64_t dev;
+    uint64_t ino;
+    uint64_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    int64_t ctime_sec;
+    int64_t ctime_nsec;
+} verdict_key;
+
+static verdict_key verdict_cache[VERDICT_CACHE_SIZE];
+static size_t verdict_count;
+static size_t verdict_next;
+static pthread_mutex_t verdict_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void verdict_key_fill(const struct stat *st, verdict_key *key) {
+    memset(key, 0, sizeof(*key));
+    key->dev = st->st_dev;
+    key->ino = st->st_ino;
+    key->size = st->st_size;
+    key->mtime_sec = st->st_mtim.tv_sec;
+    key->mtime_nsec = st->st_mtim.tv_nsec;
+    key->ctime_sec = st->st_ctim.tv_sec;
+    key->ctime_nsec = st->st_ctim.tv_nsec;
+}
+
+static int verdict_lookup(const verdict_key *key) {
+    int found = 0;
+    pthread_mutex_lock(&verdict_lock);
+    for (size_t i = 0; i < verdict_count && !found; i++) {
+        found = memcmp(&verdict_cache[i], key, sizeof(*key)) == 0;
+    }
+    pthread_mutex_unlock(&verdict_lock);
+    return found;
+}
+
+// Remplacement circulaire une fois le cache plein
+static void verdict_store(const verdict_key *key) {
+    pthread_mutex_lock(&verdict_lock);
+    verdict_cache[verdict_next] = *key;
+    verdict_next = (verdict_next + 1) % VERDICT_CACHE_SIZE;
+    if (verdict_count < VERDICT_CACHE_SIZE) {
+        verdict_count++;
+    }
+    pthread_mutex_unlock(&verdict_lock);
+}
+
+/**
+ * @brief Projette le fichier ouvert fd et le valide.
+ *
+ * Un fichier déjà validé et inchangé depuis (même identité) n'est
+ * qu'analysé, sans nouvelle validation.
+ * Le descripteur reste la propriété de elf (fermé par elf_close()) :
+ * load_library() s'en sert pour projeter les segments.
+ */
+int elf_open_fd(int fd, elf_file *elf) {
+    memset(elf, 0, sizeof(*elf));
+    elf->fd = fd;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror("fstat failed");
+        return -1;
+    }
+    elf->size = (size_t) st.st_size;
+    if (elf->size == 0) {
+        printf("Not an ELF file\n");
+        return -1;
+    }
+
+    void *data = mmap(NULL, elf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        perror("mmap failed");
+        return -1;
+    }
+    elf->data = data;
+    if (isosz_is_container(data, elf->size)) {
+        return isosz_open(elf);
+    }
+
+    verdict_key key;
+    verdict_key_fill(&st, &key);
+    if (verdict_lookup(&key)) {
+        debug_info("Validation ELF en cache");
+        return elf_parse(elf, 1);
+    }
+    if (elf_parse(elf, 0) != 0) {
+        return -1;
+    }
+    verdict_store(&key);
+    return 0;
+}
+
+int elf_open(const char *filename, elf_file *elf) {
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        memset(elf, 0, sizeof(*elf));
+        elf->fd = -1;
+        perror("open failed");
+        return -1;
+    }
+    if (elf_open_fd(fd, elf) != 0) {
+        elf_close(elf);
+        return -1;
+    }
+    return 0;
+}
+
+void elf_close(elf_file *elf) {
+    if (elf->data) {
+        munmap((void *) elf->data, elf->size);
+    }
+    isosz_close(elf->compressed);
+    if (elf->fd >= 0) {
+        close(elf->fd);
+    }
+    memset(elf, 0, sizeof(*elf));
+    elf->fd = -1;
+}
+
+void elf_iter_init(elf_iter *it, const elf_file *elf) {
+    it->elf = elf;
+    it->index = 0;
+}
+
+const elf_phdr *elf_next_phdr(elf_iter *it) {
+    if (it->index >= it->elf->phnum) {
+        return NULL;
+    }
+    return &it->elf->phdrs[it->index++];
+}
+
+// name reçoit le nom de la section, ou NULL s'il est invalide
+const Elf64_Shdr *elf_next_shdr(elf_iter *it, const char **name) {
+    if (it->index >= it->elf->shnum) {
+        return NULL;
+    }
+    const Elf64_Shdr *sh = &it->elf->shdrs[it->index++];
+    if (name) {
+        *name = elf_string(it->elf->shstrtab, it->elf->shstrtab_size, sh->sh_name);
+    }
+    return sh;
+}
+
+// S'arrête au premier DT_NULL
+const Elf64_Dyn *elf_next_dyn(elf_iter *it) {
+    if (it->index >= it->elf->dyn_count || it->elf->dynamic[it->index].d_tag == DT_NULL) {
+        return NULL;
+    }
+    return &it->elf->dynamic[it->index++];
+}
+
+// Le symbole nul (index 0) est sauté
+const Elf64_Sym *elf_next_dynsym(elf_iter *it, const char **name) {
+    if (it->index == 0) {
+        it->index = 1;
+    }
+    if (it->index >= it->elf->dynsym_count) {
+        return NULL;
+    }
+    const Elf64_Sym *sym = &it->elf->dynsym[it->index++];
+    if (name) {
+        *name = elf_string(it->elf->dynstr, it->elf->dynstr_size, sym->st_name);
+    }
+    return sym;
+}
+
+int check_valid_lib(const elf_header *hdr) {
     if (hdr->e_ident[0] != ELF_MAGIC0 ||
         hdr->e_ident[1] != ELF_MAGIC1 ||
         hdr->e_ident[2] != ELF_MAGIC2 ||
@@ -88,7 +563,7 @@ int check_valid_lib(elf_header *hdr) {
     return 0;
 }
 
-void print_header(elf_header *hdr) {
+void print_header(const elf_header *hdr) {
     printf("ELF Header:\n");
 
     printf("  Magic:   ");
@@ -136,7 +611,7 @@ void print_header(elf_header *hdr) {
     printf("  Number of section headers:         %d\n", hdr->e_shnum);
 }
 
-void print_phdr(elf_phdr *phdr, int idx) {
+void print_phdr(const elf_phdr *phdr, int idx) {
     printf("  Program Header #%d:\n", idx);
 
     printf("    Type:              ");
@@ -0,0 +1,168 @@
+#include "epoch.h"
+#include "debug.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Une ligne de cache par thread : les lecteurs n'écrivent que la leur
+typedef struct {
+    uint64_t epoch;     // 0 : hors section critique
+    int used;
+} __attribute__((aligned(64))) epoch_slot;
+
+typedef struct retired {
+    uint64_t epoch;
+    epoch_free_fn free_fn;
+    void *arg;
+    const void *owner;
+    struct retired *next;
+} retired;
+
+static uint64_t global_epoch = 1;
+static epoch_slot slots[EPOCH_MAX_THREADS];
+
+// Liste des objets retirés, partagée par les écrivains uniquement
+static pthread_mutex_t retired_lock = PTHREAD_MUTEX_INITIALIZER;
+static retired *retired_list = NULL;
+
+static __thread int thread_slot = -1;
+static __thread int thread_nesting = 0;
+
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t slot_key;
+
+// Rend le slot du thread à sa terminaison
+static void release_slot(void *arg) {
+    epoch_slot *slot = arg;
+    __atomic_store_n(&slot->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot->used, 0, __ATOMIC_RELEASE);
+}
+
+static void create_key(void) {
+    pthread_key_create(&slot_key, release_slot);
+}
+
+static int claim_slot(void) {
+    pthread_once(&key_once, create_key);
+    for (int i = 0; i < EPOCH_MAX_THREADS; i++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&slots[i].used, &expected, 1, 0, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED)) {
+            thread_slot = i;
+            pthread_setspecific(slot_key, &slots[i]);
+            return 0;
+        }
+    }
+    debug_error("Trop de threads enregistrés");
+    return -1;
+}
+
+/**
+ * @brief Entre en section critique : jusqu'à epoch_leave(), rien de ce
+ *        que le thread a pu atteindre n'est libéré. Les appels s'imbriquent.
+ *
+ * @return 0 en cas de succès, -1 si aucun slot n'est disponible.
+ */
+int epoch_enter(void) {
+    if (thread_nesting++ > 0) {
+        return 0;
+    }
+    if (thread_slot < 0 && claim_slot() != 0) {
+        thread_nesting = 0;
+        return -1;
+    }
+    // seq_cst : l'annonce doit être visible avant toute lecture de pointeur
+    uint64_t epoch = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&slots[thread_slot].epoch, epoch, __ATOMIC_SEQ_CST);
+    return 0;
+}
+
+void epoch_leave(void) {
+    if (thread_nesting <= 0 || --thread_nesting > 0) {
+        return;
+    }
+    __atomic_store_n(&slots[thread_slot].epoch, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Programme la libération d'un objet déjà dépublié.
+ *
+ * @param free_fn : appelée avec arg après la période de grâce.
+ * @param owner   : regroupe les objets libérés par epoch_flush().
+ * @return 0 en cas de succès, -1 si l'entrée n'a pu être allouée
+ *         (l'objet n'est alors jamais libéré).
+ */
+int epoch_retire(epoch_free_fn free_fn, void *arg, const void *owner) {
+    retired *entry = malloc(sizeof(retired));
+    if (!entry) {
+        perror("malloc failed");
+        return -1;
+    }
+    entry->free_fn = free_fn;
+    entry->arg = arg;
+    entry->owner = owner;
+
+    pthread_mutex_lock(&retired_lock);
+    entry->epoch = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+    entry->next = retired_list;
+    retired_list = entry;
+    pthread_mutex_unlock(&retired_lock);
+    return 0;
+}
+
+/**
+ * @brief Avance l'époque et libère les objets dont la période de grâce
+ *        est écoulée. N'attend jamais les lecteurs.
+ *
+ * @return le nombre d'objets encore en attente.
+ */
+int epoch_reclaim(void) {
+    pthread_mutex_lock(&retired_lock);
+
+    // Tout lecteur qui voit la nouvelle époque a vu les pointeurs à jour
+    uint64_t safe = __atomic_add_fetch(&global_epoch, 1, __ATOMIC_SEQ_CST);
+    for (int i = 0; i < EPOCH_MAX_THREADS; i++) {
+        uint64_t epoch = __atomic_load_n(&slots[i].epoch, __ATOMIC_SEQ_CST);
+        if (epoch != 0 && epoch < safe) {
+            safe = epoch;
+        }
+    }
+
+    int pending = 0;
+    retired **link = &retired_list;
+    while (*link) {
+        retired *entry = *link;
+        if (entry->epoch < safe) {
+            *link = entry->next;
+            entry->free_fn(entry->arg);
+            free(entry);
+        } else {
+            link = &entry->next;
+            pending++;
+        }
+    }
+
+    pthread_mutex_unlock(&retired_lock);
+    return pending;
+}
+
+/**
+ * @brief Libère sans attendre tous les objets retirés pour owner.
+ *        L'appelant garantit qu'aucun thread ne les utilise plus.
+ */
+void epoch_flush(const void *owner) {
+    pthread_mutex_lock(&retired_lock);
+    retired **link = &retired_list;
+    while (*link) {
+        retired *entry = *link;
+        if (entry->owner == owner) {
+            *link = entry->next;
+            entry->free_fn(entry->arg);
+            free(entry);
+        } else {
+            link = &entry->next;
+        }
+    }
+    pthread_mutex_unlock(&retired_lock);
+}
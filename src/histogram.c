@@ -0,0 +1,74 @@
+#include "histogram.h"
+#include <string.h>
+
+// Les petites valeurs ont chacune leur propre case ; au-delà on garde
+// HIST_SUB_BITS bits significatifs.
+static int hist_index(uint64_t value) {
+    if (value < (1u << HIST_SUB_BITS)) {
+        return (int) value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - (HIST_SUB_BITS - 1);
+    return shift * HIST_SUB_COUNT + (int) (value >> shift);
+}
+
+// Borne inférieure des valeurs rangées dans la case index
+static uint64_t hist_value(int index) {
+    if (index < (1 << HIST_SUB_BITS)) {
+        return (uint64_t) index;
+    }
+    int shift = index / HIST_SUB_COUNT - 1;
+    uint64_t top = (uint64_t) (index % HIST_SUB_COUNT + HIST_SUB_COUNT);
+    return top << shift;
+}
+
+void hist_init(histogram_t *hist) {
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT64_MAX;
+}
+
+void hist_record(histogram_t *hist, uint64_t value) {
+    hist->counts[hist_index(value)]++;
+    hist->total++;
+    hist->sum += (double) value;
+    if (value < hist->min) hist->min = value;
+    if (value > hist->max) hist->max = value;
+}
+
+/**
+ * @param percentile : entre 0 et 100 (par exemple 99.9).
+ * @return la valeur sous laquelle se trouvent percentile % des mesures.
+ */
+uint64_t hist_percentile(const histogram_t *hist, double percentile) {
+    if (hist->total == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t) (percentile / 100.0 * (double) hist->total + 0.5);
+    if (rank == 0) rank = 1;
+    if (rank > hist->total) rank = hist->total;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            uint64_t value = hist_value(i);
+            return value < hist->min ? hist->min : (value > hist->max ? hist->max : value);
+        }
+    }
+    return hist->max;
+}
+
+double hist_mean(const histogram_t *hist) {
+    return hist->total ? hist->sum / (double) hist->total : 0.0;
+}
+
+// Ajoute les mesures de src à dst (histogrammes par thread)
+void hist_merge(histogram_t *dst, const histogram_t *src) {
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    dst->total += src->total;
+    dst->sum += src->sum;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+}
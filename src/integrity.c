@@ -0,0 +1,330 @@
+#include "integrity.h"
+#include "crc32c.h"
+#include "debug.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+
+// Nom de la note, complété à 4 octets
+#define NOTE_NAME_SIZE  8
+#define NOTE_HEADER     (12 + NOTE_NAME_SIZE)
+
+// Section de la note dans un fichier ouvert, NULL s'il n'y en a pas
+static const Elf64_Shdr *find_section(const elf_file *elf) {
+    for (size_t i = 0; i < elf->shnum; i++) {
+        const Elf64_Shdr *sh = &elf->shdrs[i];
+        const char *name = elf_string(elf->shstrtab, elf->shstrtab_size, sh->sh_name);
+        if (sh->sh_type == SHT_NOTE && name && strcmp(name, INTEGRITY_SECTION) == 0) {
+            return sh;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Lit la note de CRC32C d'un fichier ouvert.
+ *
+ * @param crcs : reçoit le CRC attendu de chaque program header (phnum
+ *        entrées, seules celles des PT_LOAD non vides ont un sens).
+ * @return 0 si chaque segment PT_LOAD non vide a son CRC, -1 sinon.
+ */
+int integrity_note_find(const elf_file *elf, uint32_t *crcs) {
+    const Elf64_Shdr *sh = find_section(elf);
+    const uint8_t *note = sh ? elf_view(elf, sh->sh_offset, sh->sh_size) : NULL;
+    if (!note) {
+        debug_error("Pas de note " INTEGRITY_SECTION " : intégrité invérifiable");
+        return -1;
+    }
+
+    uint32_t namesz, descsz, type;
+    if (sh->sh_size < NOTE_HEADER) {
+        debug_error("Note " INTEGRITY_SECTION " invalide");
+        return -1;
+    }
+    memcpy(&namesz, note, 4);
+    memcpy(&descsz, note + 4, 4);
+    memcpy(&type, note + 8, 4);
+    if (namesz != sizeof(INTEGRITY_NOTE_NAME) || type != NT_ISOS_CRC32C ||
+        memcmp(note + 12, INTEGRITY_NOTE_NAME, sizeof(INTEGRITY_NOTE_NAME)) != 0 ||
+        descsz % sizeof(integrity_entry) != 0 || descsz > sh->sh_size - NOTE_HEADER) {
+        debug_error("Note " INTEGRITY_SECTION " invalide");
+        return -1;
+    }
+
+    uint8_t *seen = calloc(elf->phnum ? elf->phnum : 1, 1);
+    if (!seen) {
+        perror("calloc failed");
+        return -1;
+    }
+    int status = 0;
+    for (uint32_t i = 0; i < descsz / sizeof(integrity_entry); i++) {
+        integrity_entry e;
+        memcpy(&e, note + NOTE_HEADER + i * sizeof(e), sizeof(e));
+        if (e.phdr_index >= elf->phnum || elf->phdrs[e.phdr_index].p_type != PT_LOAD) {
+            status = -1;
+            break;
+        }
+        crcs[e.phdr_index] = e.crc;
+        seen[e.phdr_index] = 1;
+    }
+    for (size_t i = 0; status == 0 && i < elf->phnum; i++) {
+        if (elf->phdrs[i].p_type == PT_LOAD && elf->phdrs[i].p_filesz > 0 && !seen[i]) {
+            status = -1;
+        }
+    }
+    free(seen);
+    if (status != 0) {
+        debug_error("Note " INTEGRITY_SECTION " incomplète");
+    }
+    return status;
+}
+
+// Tranche d'un segment, CRC calculé par un thread
+typedef struct {
+    const uint8_t *start;
+    size_t len;
+    int segment;
+    uint32_t crc;
+} crc_task;
+
+typedef struct {
+    crc_task *tasks;
+    size_t count;
+    size_t next;
+} crc_job;
+
+static void *crc_worker(void *arg) {
+    crc_job *job = arg;
+    size_t page_size = getpagesize();
+    for (;;) {
+        size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (i >= job->count) {
+            return NULL;
+        }
+        crc_task *t = &job->tasks[i];
+        // Pages de la tranche amenées par lots plutôt qu'une faute par page
+        uintptr_t page = (uintptr_t) t->start & ~(page_size - 1);
+        madvise((void *) page, (uintptr_t) t->start + t->len - page, MADV_POPULATE_READ);
+        t->crc = crc32c(0, t->start, t->len);
+    }
+}
+
+/**
+ * @brief Compare le CRC32C de la partie fichier de chaque segment PT_LOAD
+ *        de l'image (projetée, pas encore relogée) à celui de la note.
+ *
+ * @param verified : reçoit le nombre d'octets vérifiés (peut être NULL).
+ * @return 0 si tous les segments sont intacts, -1 sinon.
+ */
+int integrity_verify(uint64_t base_address, const elf_phdr *phdrs, int phnum,
+                     const uint32_t *crcs, size_t *verified) {
+    size_t count = 0;
+    for (int i = 0; i < phnum; i++) {
+        if (phdrs[i].p_type == PT_LOAD) {
+            count += (phdrs[i].p_filesz + INTEGRITY_CHUNK - 1) / INTEGRITY_CHUNK;
+        }
+    }
+    crc_task *tasks = calloc(count ? count : 1, sizeof(crc_task));
+    if (!tasks) {
+        perror("calloc failed");
+        return -1;
+    }
+    size_t n = 0;
+    for (int i = 0; i < phnum; i++) {
+        if (phdrs[i].p_type != PT_LOAD) {
+            continue;
+        }
+        const uint8_t *seg = (const uint8_t *) (base_address + phdrs[i].p_vaddr);
+        for (uint64_t off = 0; off < phdrs[i].p_filesz; off += INTEGRITY_CHUNK) {
+            uint64_t left = phdrs[i].p_filesz - off;
+            tasks[n].start = seg + off;
+            tasks[n].len = left < INTEGRITY_CHUNK ? left : INTEGRITY_CHUNK;
+            tasks[n].segment = i;
+            n++;
+        }
+    }
+
+    crc_job job = {.tasks = tasks, .count = count, .next = 0};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = cpus > 1 ? (size_t) cpus : 1;
+    threads = threads < INTEGRITY_MAX_THREADS ? threads : INTEGRITY_MAX_THREADS;
+    threads = threads < count ? threads : count;
+    pthread_t helpers[INTEGRITY_MAX_THREADS];
+    size_t started = 0;
+    for (; started + 1 < threads; started++) {
+        if (pthread_create(&helpers[started], NULL, crc_worker, &job) != 0) {
+            break;
+        }
+    }
+    crc_worker(&job);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(helpers[i], NULL);
+    }
+
+    // Recombinaison des tranches, segment par segment, dans l'ordre
+    int status = 0;
+    size_t total = 0;
+    for (size_t t = 0; t < count;) {
+        int seg = tasks[t].segment;
+        uint32_t crc = tasks[t].crc;
+        total += tasks[t].len;
+        for (t++; t < count && tasks[t].segment == seg; t++) {
+            crc = crc32c_combine(crc, tasks[t].crc, tasks[t].len);
+            total += tasks[t].len;
+        }
+        if (crc != crcs[seg]) {
+            debug_printf(DBG_ERROR, "Segment PT_LOAD %d altéré : CRC32C %08x, attendu %08x",
+                         seg, crc, crcs[seg]);
+            status = -1;
+        }
+    }
+    free(tasks);
+    if (verified) {
+        *verified = total;
+    }
+    return status;
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Ajoute (ou met à jour) la note .note.isos.crc32c d'une
+ *        bibliothèque, en place.
+ *
+ * Les segments ne bougent pas : la note, une copie étendue de .shstrtab
+ * et la nouvelle table des sections sont ajoutées en fin de fichier, et
+ * l'en-tête ELF pointe sur cette table. Comme l'en-tête fait partie du
+ * premier segment, les CRC sont calculés après sa mise à jour. Écriture
+ * sous un nom temporaire puis renommage.
+ *
+ * @return le nombre de segments couverts, -1 en cas d'erreur.
+ */
+int integrity_write(const char *library_path) {
+    elf_file elf;
+    if (elf_open(library_path, &elf) != 0) {
+        return -1;
+    }
+    if (elf.compressed || !elf.shdrs || !elf.shstrtab) {
+        printf("%s: pas de table des sections modifiable (conteneur compressé ?)\n",
+               library_path);
+        elf_close(&elf);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(elf.fd, &st) != 0) {
+        perror("fstat failed");
+        elf_close(&elf);
+        return -1;
+    }
+
+    uint32_t entries = 0;
+    for (size_t i = 0; i < elf.phnum; i++) {
+        entries += elf.phdrs[i].p_type == PT_LOAD && elf.phdrs[i].p_filesz > 0;
+    }
+    size_t desc_size = entries * sizeof(integrity_entry);
+    const Elf64_Shdr *existing = find_section(&elf);
+
+    // Nouvelle image : le fichier, puis (si besoin) note, .shstrtab, sections
+    size_t name_size = sizeof(INTEGRITY_SECTION);
+    size_t note_off = (elf.size + 7) & ~(size_t) 7;
+    size_t strtab_off = note_off + NOTE_HEADER + desc_size;
+    size_t strtab_size = elf.shstrtab_size + name_size;
+    size_t shdrs_off = (strtab_off + strtab_size + 7) & ~(size_t) 7;
+    size_t size = shdrs_off + (elf.shnum + 1) * sizeof(Elf64_Shdr);
+    if (existing && existing->sh_size == NOTE_HEADER + desc_size) {
+        note_off = existing->sh_offset;
+        size = elf.size;
+    }
+    uint8_t *image = calloc(1, size);
+    if (!image) {
+        perror("calloc failed");
+        elf_close(&elf);
+        return -1;
+    }
+    memcpy(image, elf.data, elf.size);
+
+    if (size != elf.size) {
+        memcpy(image + strtab_off, elf.shstrtab, elf.shstrtab_size);
+        memcpy(image + strtab_off + elf.shstrtab_size, INTEGRITY_SECTION, name_size);
+        Elf64_Shdr *shdrs = (Elf64_Shdr *) (image + shdrs_off);
+        memcpy(shdrs, elf.shdrs, elf.shnum * sizeof(Elf64_Shdr));
+        shdrs[elf.hdr->e_shstrndx].sh_offset = strtab_off;
+        shdrs[elf.hdr->e_shstrndx].sh_size = strtab_size;
+        Elf64_Shdr *note_sh = &shdrs[elf.shnum];
+        memset(note_sh, 0, sizeof(*note_sh));
+        note_sh->sh_name = (uint32_t) elf.shstrtab_size;
+        note_sh->sh_type = SHT_NOTE;
+        note_sh->sh_offset = note_off;
+        note_sh->sh_size = NOTE_HEADER + desc_size;
+        note_sh->sh_addralign = 4;
+        // Ancienne note de taille différente : rendue inerte
+        if (existing) {
+            shdrs[existing - elf.shdrs].sh_type = SHT_NOBITS;
+        }
+        elf_header *hdr = (elf_header *) image;
+        hdr->e_shoff = shdrs_off;
+        hdr->e_shnum++;
+    }
+
+    // CRC des segments de la nouvelle image
+    uint8_t *note = image + note_off;
+    uint32_t namesz = sizeof(INTEGRITY_NOTE_NAME);
+    uint32_t descsz = (uint32_t) desc_size;
+    uint32_t type = NT_ISOS_CRC32C;
+    memcpy(note, &namesz, 4);
+    memcpy(note + 4, &descsz, 4);
+    memcpy(note + 8, &type, 4);
+    memset(note + 12, 0, NOTE_NAME_SIZE);
+    memcpy(note + 12, INTEGRITY_NOTE_NAME, sizeof(INTEGRITY_NOTE_NAME));
+    uint32_t n = 0;
+    for (size_t i = 0; i < elf.phnum; i++) {
+        const elf_phdr *ph = &elf.phdrs[i];
+        if (ph->p_type == PT_LOAD && ph->p_filesz > 0) {
+            integrity_entry e = {(uint32_t) i, crc32c(0, image + ph->p_offset, ph->p_filesz)};
+            memcpy(note + NOTE_HEADER + n * sizeof(e), &e, sizeof(e));
+            n++;
+        }
+    }
+    elf_close(&elf);
+
+    char tmp_path[4096 + 16];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d", library_path, (int) getpid());
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 07777);
+    if (fd < 0) {
+        perror("open failed");
+        free(image);
+        return -1;
+    }
+    int status = write_all(fd, image, size);
+    free(image);
+    if (close(fd) != 0 || status != 0 || rename(tmp_path, library_path) != 0) {
+        perror("write checksum note failed");
+        unlink(tmp_path);
+        return -1;
+    }
+    return (int) n;
+}
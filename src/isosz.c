@@ -0,0 +1,422 @@
+#include "isosz.h"
+#include "lz4_block.h"
+#include "debug.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+int isosz_is_container(const void *data, size_t size) {
+    return size >= sizeof(isosz_header) && memcmp(data, ISOSZ_MAGIC, 8) == 0;
+}
+
+static int decompress_block(const isosz_t *z, const isosz_block *b, uint8_t *dst) {
+    const uint8_t *src = z->map + b->data_offset;
+    if (b->data_size == b->raw_size) {
+        memcpy(dst, src, b->raw_size);
+        return 0;
+    }
+    return lz4_decompress(src, b->data_size, dst, b->raw_size);
+}
+
+/*
+ * Blocs contigus couvrant exactement [0, image_size), données dans le
+ * conteneur : rien ne sera lu ni écrit hors des projections.
+ */
+static int check_table(const isosz_t *z) {
+    const isosz_header *hdr = z->hdr;
+    if (hdr->version != ISOSZ_VERSION || hdr->image_size == 0 || hdr->block_count == 0) {
+        debug_error("Conteneur compressé : version ou en-tête invalide");
+        return -1;
+    }
+    if (hdr->block_count > (z->map_size - sizeof(isosz_header)) / sizeof(isosz_block)) {
+        debug_error("Conteneur compressé tronqué");
+        return -1;
+    }
+    uint64_t next = 0;
+    for (uint32_t i = 0; i < hdr->block_count; i++) {
+        const isosz_block *b = &z->blocks[i];
+        if (b->image_offset != next || b->raw_size == 0 || b->raw_size > ISOSZ_BLOCK_SIZE ||
+            b->data_size > b->raw_size || b->data_offset > z->map_size ||
+            b->data_size > z->map_size - b->data_offset) {
+            debug_error("Conteneur compressé : table des blocs invalide");
+            return -1;
+        }
+        next += b->raw_size;
+    }
+    if (next != hdr->image_size) {
+        debug_error("Conteneur compressé : table des blocs invalide");
+        return -1;
+    }
+    return 0;
+}
+
+// Décompresse dans la vue les blocs qui recoupent [start, end)
+static int view_range(isosz_t *z, uint8_t *done, uint64_t start, uint64_t end) {
+    for (uint32_t i = 0; i < z->hdr->block_count; i++) {
+        const isosz_block *b = &z->blocks[i];
+        if (done[i] || b->image_offset >= end || b->image_offset + b->raw_size <= start) {
+            continue;
+        }
+        if (decompress_block(z, b, z->view + b->image_offset) != 0) {
+            debug_error("Conteneur compressé corrompu");
+            return -1;
+        }
+        done[i] = 1;
+    }
+    return 0;
+}
+
+/*
+ * Un bloc va dans la vue sauf s'il n'appartient qu'à des segments
+ * exécutables : le texte n'est décompressé qu'au chargement.
+ */
+static int block_in_view(const isosz_block *b, const elf_phdr *phdrs, size_t phnum) {
+    int text = 0;
+    for (size_t i = 0; i < phnum; i++) {
+        const elf_phdr *ph = &phdrs[i];
+        if (ph->p_type != PT_LOAD || b->image_offset < ph->p_offset ||
+            b->image_offset + b->raw_size > ph->p_offset + ph->p_filesz) {
+            continue;
+        }
+        if (!(ph->p_flags & PF_X)) {
+            return 1;
+        }
+        text = 1;
+    }
+    return !text;
+}
+
+/**
+ * @brief Ouvre le conteneur projeté dans elf->data : vue décompressée
+ *        (sans le texte) à la place du conteneur, puis validation ELF.
+ *
+ * elf_close() libère le conteneur et la vue, y compris en cas d'échec.
+ *
+ * @return 0 en cas de succès, -1 sinon.
+ */
+int isosz_open(elf_file *elf) {
+    isosz_t *z = calloc(1, sizeof(isosz_t));
+    if (!z) {
+        perror("calloc failed");
+        return -1;
+    }
+    z->map = elf->data;
+    z->map_size = elf->size;
+    z->hdr = (const isosz_header *) z->map;
+    z->blocks = (const isosz_block *) (z->map + sizeof(isosz_header));
+    elf->compressed = z;
+    elf->data = NULL;
+    elf->size = 0;
+    if (check_table(z) != 0) {
+        return -1;
+    }
+
+    // Vue creuse : seules les pages écrites occupent de la mémoire
+    z->image_size = z->hdr->image_size;
+    z->view = mmap(NULL, z->image_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (z->view == MAP_FAILED) {
+        z->view = NULL;
+        perror("mmap failed");
+        return -1;
+    }
+    elf->data = z->view;
+    elf->size = z->image_size;
+
+    uint8_t *done = calloc(z->hdr->block_count, 1);
+    if (!done) {
+        perror("calloc failed");
+        return -1;
+    }
+    // En-tête et program headers d'abord : ils disent où est le texte
+    int status = view_range(z, done, 0, sizeof(elf_header));
+    const elf_header *hdr = (const elf_header *) z->view;
+    uint64_t ph_end = hdr->e_phoff + (uint64_t) hdr->e_phnum * sizeof(elf_phdr);
+    if (status == 0 && sizeof(elf_header) <= z->image_size && hdr->e_phoff <= z->image_size &&
+        ph_end <= z->image_size && hdr->e_phoff % 8 == 0) {
+        status = view_range(z, done, hdr->e_phoff, ph_end);
+        const elf_phdr *phdrs = (const elf_phdr *) (z->view + hdr->e_phoff);
+        for (uint32_t i = 0; status == 0 && i < z->hdr->block_count; i++) {
+            const isosz_block *b = &z->blocks[i];
+            if (!done[i] && block_in_view(b, phdrs, hdr->e_phnum)) {
+                status = view_range(z, done, b->image_offset, b->image_offset + b->raw_size);
+            }
+        }
+    }
+    free(done);
+    if (status != 0) {
+        return -1;
+    }
+    debug_info("Conteneur compressé : métadonnées décompressées");
+    return elf_validate(elf);
+}
+
+void isosz_close(isosz_t *z) {
+    if (!z) {
+        return;
+    }
+    if (z->map) {
+        munmap((void *) z->map, z->map_size);
+    }
+    free(z);
+}
+
+// Morceau de segment à remplir : intersection d'un bloc et d'un segment
+typedef struct {
+    const isosz_block *block;
+    uint64_t start;             // offset dans le fichier ELF
+    uint64_t len;
+    uint8_t *dst;
+} fill_task;
+
+typedef struct {
+    const isosz_t *z;
+    fill_task *tasks;
+    size_t count;
+    size_t next;
+    int failed;
+} fill_job;
+
+static int run_task(const isosz_t *z, const fill_task *t) {
+    const isosz_block *b = t->block;
+    // Bloc entier : décompressé directement à sa place dans l'image
+    if (t->start == b->image_offset && t->len == b->raw_size) {
+        return decompress_block(z, b, t->dst);
+    }
+    // Bloc à cheval sur une borne de segment (conteneur non produit par
+    // isosz_write()) : copie partielle depuis un tampon
+    uint8_t *tmp = malloc(b->raw_size);
+    if (!tmp) {
+        return -1;
+    }
+    int status = decompress_block(z, b, tmp);
+    if (status == 0) {
+        memcpy(t->dst, tmp + (t->start - b->image_offset), t->len);
+    }
+    free(tmp);
+    return status;
+}
+
+static void *fill_worker(void *arg) {
+    fill_job *job = arg;
+    for (;;) {
+        size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (i >= job->count || __atomic_load_n(&job->failed, __ATOMIC_RELAXED)) {
+            return NULL;
+        }
+        if (run_task(job->z, &job->tasks[i]) != 0) {
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * @brief Remplit la partie fichier des segments PT_LOAD d'une image
+ *        réservée en lecture/écriture à base_address.
+ *
+ * Texte : blocs décompressés à leur place, répartis entre au plus
+ * ISOSZ_MAX_THREADS threads. Autres segments : copiés depuis la vue.
+ *
+ * @return 0 en cas de succès, -1 si un bloc est corrompu.
+ */
+int isosz_fill(const isosz_t *z, uint64_t base_address, const elf_phdr *phdrs, int phnum) {
+    size_t max_tasks = 0;
+    for (int i = 0; i < phnum; i++) {
+        if (phdrs[i].p_type == PT_LOAD) {
+            max_tasks += z->hdr->block_count;
+        }
+    }
+    fill_task *tasks = calloc(max_tasks ? max_tasks : 1, sizeof(fill_task));
+    if (!tasks) {
+        perror("calloc failed");
+        return -1;
+    }
+
+    size_t count = 0;
+    for (int i = 0; i < phnum; i++) {
+        const elf_phdr *ph = &phdrs[i];
+        if (ph->p_type != PT_LOAD || ph->p_filesz == 0) {
+            continue;
+        }
+        uint8_t *seg = (uint8_t *) (base_address + ph->p_vaddr);
+        if (!(ph->p_flags & PF_X)) {
+            memcpy(seg, z->view + ph->p_offset, ph->p_filesz);
+            continue;
+        }
+        uint64_t seg_end = ph->p_offset + ph->p_filesz;
+        for (uint32_t j = 0; j < z->hdr->block_count; j++) {
+            const isosz_block *b = &z->blocks[j];
+            uint64_t lo = b->image_offset > ph->p_offset ? b->image_offset : ph->p_offset;
+            uint64_t hi = b->image_offset + b->raw_size;
+            hi = hi < seg_end ? hi : seg_end;
+            if (lo < hi) {
+                tasks[count].block = b;
+                tasks[count].start = lo;
+                tasks[count].len = hi - lo;
+                tasks[count].dst = seg + (lo - ph->p_offset);
+                count++;
+            }
+        }
+    }
+
+    fill_job job = {.z = z, .tasks = tasks, .count = count, .next = 0, .failed = 0};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = cpus > 1 ? (size_t) cpus : 1;
+    threads = threads < ISOSZ_MAX_THREADS ? threads : ISOSZ_MAX_THREADS;
+    threads = threads < count ? threads : count;
+
+    // Le thread appelant prend sa part
+    pthread_t helpers[ISOSZ_MAX_THREADS];
+    size_t started = 0;
+    for (; started + 1 < threads; started++) {
+        if (pthread_create(&helpers[started], NULL, fill_worker, &job) != 0) {
+            break;
+        }
+    }
+    fill_worker(&job);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(helpers[i], NULL);
+    }
+    free(tasks);
+
+    if (job.failed) {
+        debug_error("Conteneur compressé corrompu");
+        return -1;
+    }
+    debug_info("Conteneur compressé : texte décompressé dans l'image");
+    return 0;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return x < y ? -1 : x > y;
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Écrit le conteneur compressé de library_path dans out_path.
+ *
+ * Comme pour .isosidx, le fichier est écrit sous un nom temporaire puis
+ * renommé.
+ *
+ * @return le nombre de blocs écrits, -1 en cas d'erreur.
+ */
+int isosz_write(const char *library_path, const char *out_path) {
+    elf_file elf;
+    if (elf_open(library_path, &elf) != 0) {
+        return -1;
+    }
+    if (elf.compressed) {
+        printf("%s: déjà compressé\n", library_path);
+        elf_close(&elf);
+        return -1;
+    }
+
+    // Coupures : début et fin du fichier, bornes de chaque PT_LOAD
+    uint64_t *cuts = malloc((2 + 2 * elf.phnum) * sizeof(uint64_t));
+    if (!cuts) {
+        perror("malloc failed");
+        elf_close(&elf);
+        return -1;
+    }
+    size_t ncuts = 0;
+    cuts[ncuts++] = 0;
+    cuts[ncuts++] = elf.size;
+    for (size_t i = 0; i < elf.phnum; i++) {
+        if (elf.phdrs[i].p_type == PT_LOAD && elf.phdrs[i].p_filesz > 0) {
+            cuts[ncuts++] = elf.phdrs[i].p_offset;
+            cuts[ncuts++] = elf.phdrs[i].p_offset + elf.phdrs[i].p_filesz;
+        }
+    }
+    qsort(cuts, ncuts, sizeof(uint64_t), cmp_u64);
+
+    uint32_t count = 0;
+    for (size_t i = 0; i + 1 < ncuts; i++) {
+        count += (cuts[i + 1] - cuts[i] + ISOSZ_BLOCK_SIZE - 1) / ISOSZ_BLOCK_SIZE;
+    }
+    isosz_block *blocks = calloc(count, sizeof(isosz_block));
+    uint8_t *buf = malloc(lz4_compress_bound(ISOSZ_BLOCK_SIZE));
+    if (!blocks || !buf) {
+        perror("malloc failed");
+        free(cuts);
+        free(blocks);
+        free(buf);
+        elf_close(&elf);
+        return -1;
+    }
+
+    char tmp_path[4096 + 16];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d", out_path, (int) getpid());
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror("open failed");
+        free(cuts);
+        free(blocks);
+        free(buf);
+        elf_close(&elf);
+        return -1;
+    }
+
+    // Données d'abord, derrière la place de l'en-tête et de la table
+    isosz_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, ISOSZ_MAGIC, sizeof(hdr.magic));
+    hdr.version = ISOSZ_VERSION;
+    hdr.block_count = count;
+    hdr.image_size = elf.size;
+    uint64_t pos = sizeof(hdr) + (uint64_t) count * sizeof(isosz_block);
+    int status = lseek(fd, (off_t) pos, SEEK_SET) < 0 ? -1 : 0;
+    uint32_t n = 0;
+    for (size_t i = 0; status == 0 && i + 1 < ncuts; i++) {
+        for (uint64_t off = cuts[i]; status == 0 && off < cuts[i + 1]; off += ISOSZ_BLOCK_SIZE) {
+            uint64_t left = cuts[i + 1] - off;
+            uint32_t raw = left < ISOSZ_BLOCK_SIZE ? (uint32_t) left : ISOSZ_BLOCK_SIZE;
+            size_t csize = lz4_compress(elf.data + off, raw, buf, lz4_compress_bound(raw));
+            // Bloc incompressible : stocké tel quel
+            const uint8_t *data = csize > 0 && csize < raw ? buf : elf.data + off;
+            uint32_t size = csize > 0 && csize < raw ? (uint32_t) csize : raw;
+            blocks[n].image_offset = off;
+            blocks[n].data_offset = pos;
+            blocks[n].raw_size = raw;
+            blocks[n].data_size = size;
+            status = write_all(fd, data, size);
+            pos += size;
+            n++;
+        }
+    }
+    if (status == 0) {
+        status = lseek(fd, 0, SEEK_SET) < 0 || write_all(fd, &hdr, sizeof(hdr)) != 0 ||
+                 write_all(fd, blocks, count * sizeof(isosz_block)) != 0 ? -1 : 0;
+    }
+    if (close(fd) != 0 || status != 0 || rename(tmp_path, out_path) != 0) {
+        perror("write container failed");
+        unlink(tmp_path);
+        status = -1;
+    }
+
+    free(cuts);
+    free(blocks);
+    free(buf);
+    elf_close(&elf);
+    return status == 0 ? (int) count : -1;
+}
@@ -1,5 +1,8 @@
 #include "elf_parser.h"
 #include "debug.h"
+#include "page_profile.h"
+#include "isosz.h"
+#include "integrity.h"
 #include <stdio.h>
 #define __STDC_WANT_LIB_EXT1__ 1
 #include <string.h> /* memset */
@@ -10,83 +13,343 @@
 #include <string.h>
 
 
+/**
+ * @brief Calcule l'étendue (alignée sur la page) des segments PT_LOAD.
+ *
+ * @return 0 en cas de succès, -1 s'il n'y a aucun segment PT_LOAD.
+ */
+int load_extent(const elf_phdr *phdrs, int phnum, size_t page_size,
+                uint64_t *base_offset, size_t *total_size) {
+    uint64_t min_addr = UINT64_MAX;
+    uint64_t max_addr = 0;
 
-static void* memcpy_safe(void *dest, const void *src, size_t n) {
-    if (dest == NULL || src == NULL) {
-        return NULL;
-    }
-    
-    unsigned char *d = (unsigned char*)dest;
-    const unsigned char *s = (const unsigned char*)src;
-    
-    // Vérifier le chevauchement (overlap) des zones mémoire
-    if ((d <= s && d + n > s) || (s <= d && s + n > d)) {
-        // Chevauchement détecté, on copie de droite à gauche
-        for (size_t i = n; i > 0; i--) {
-            d[i-1] = s[i-1];
+    for (int i = 0; i < phnum; i++) {
+        if (phdrs[i].p_type == PT_LOAD) {
+            if (phdrs[i].p_vaddr < min_addr)
+                min_addr = phdrs[i].p_vaddr;
+
+            uint64_t seg_end = phdrs[i].p_vaddr + phdrs[i].p_memsz;
+            if (seg_end > max_addr)
+                max_addr = seg_end;
         }
+    }
+    if (min_addr == UINT64_MAX) {
+        return -1;
+    }
+
+    *base_offset = min_addr & ~(page_size - 1);
+    *total_size = (max_addr - *base_offset + page_size - 1) & ~(page_size - 1);
+    return 0;
+}
+
+/**
+ * @brief Libère en une fois l'image chargée par load_library().
+ */
+void unload_library(void *base_addr, const elf_phdr *phdrs, int phnum) {
+    size_t page_size = getpagesize();
+    uint64_t base_offset;
+    size_t total_size;
+
+    if (!base_addr || load_extent(phdrs, phnum, page_size, &base_offset, &total_size) != 0) {
+        return;
+    }
+    munmap((char *) base_addr + base_offset, total_size);
+}
+
+// Rend une plage de l'image : démontée, ou remise en PROT_NONE si elle
+// appartient à une réservation partagée (pack) qui reste en place
+static void release_range(void *addr, size_t size, int shared) {
+    if (shared) {
+        mmap(addr, size, PROT_NONE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+             -1, 0);
     } else {
-        // Pas de chevauchement, on copie de gauche à droite
-        for (size_t i = 0; i < n; i++) {
-            d[i] = s[i];
+        munmap(addr, size);
+    }
+}
+
+#ifndef MADV_COLLAPSE
+#define MADV_COLLAPSE 25
+#endif
+
+// Octets de pages anonymes de 2 Mo effectivement en place sur [addr, addr+len)
+static size_t anon_huge_bytes(void *addr, size_t len) {
+    FILE *smaps = fopen("/proc/self/smaps", "r");
+    if (!smaps) {
+        return 0;
+    }
+    uintptr_t lo = (uintptr_t) addr;
+    uintptr_t hi = lo + len;
+    int inside = 0;
+    size_t total = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), smaps)) {
+        uintptr_t start, end;
+        size_t kb;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            inside = start < hi && end > lo;
+        } else if (inside && sscanf(line, "AnonHugePages: %zu kB", &kb) == 1) {
+            total += kb * 1024;
+        }
+    }
+    fclose(smaps);
+    return total < len ? total : len;
+}
+
+/**
+ * @brief Remplace une plage de texte (alignée sur 2 Mo) par une copie en
+ *        grandes pages : réserve hugetlbfs si elle existe, sinon pages
+ *        anonymes marquées MADV_HUGEPAGE (THP). La plage reste PROT_READ |
+ *        PROT_WRITE jusqu'au mprotect final.
+ *
+ * @return LOAD_TEXT_PAGES_*, ou -1 si la plage n'a pas pu être restaurée.
+ */
+static int remap_text_huge(void *addr, size_t len, size_t *huge_bytes) {
+    *huge_bytes = 0;
+    void *copy = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (copy == MAP_FAILED) {
+        debug_warn("Pas de mémoire pour la copie du texte");
+        return LOAD_TEXT_PAGES_SMALL;
+    }
+    memcpy(copy, addr, len);
+
+    int pages = LOAD_TEXT_PAGES_HUGETLB;
+    void *text = mmap(addr, len, PROT_READ | PROT_WRITE,
+                      MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (text == MAP_FAILED) {
+        // Pas de réserve hugetlbfs : pages transparentes
+        pages = LOAD_TEXT_PAGES_THP;
+        text = mmap(addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS,
+                    -1, 0);
+        if (text == MAP_FAILED) {
+            debug_error("Impossible de reprojeter le texte");
+            munmap(copy, len);
+            return -1;
         }
+        madvise(addr, len, MADV_HUGEPAGE);
+    }
+    memcpy(addr, copy, len);
+    munmap(copy, len);
+
+    if (pages == LOAD_TEXT_PAGES_HUGETLB) {
+        *huge_bytes = len;
+        return pages;
     }
-    
-    return dest;
+    // Regroupement immédiat si le noyau le permet (Linux >= 6.1)
+    madvise(addr, len, MADV_COLLAPSE);
+    *huge_bytes = anon_huge_bytes(addr, len);
+    return *huge_bytes ? LOAD_TEXT_PAGES_THP : LOAD_TEXT_PAGES_SMALL;
 }
 
-// Variables globales pour stocker l'état de la bibliothèque chargée
-void *g_base_addr = NULL;
-elf_header g_hdr;
-elf_phdr *g_phdrs = NULL;
+// Début (aligné sur la page) du premier segment exécutable, 0 s'il n'y en a pas
+static uint64_t first_text_vaddr(const elf_phdr *phdrs, int phnum, size_t page_size) {
+    for (int i = 0; i < phnum; i++) {
+        if (phdrs[i].p_type == PT_LOAD && (phdrs[i].p_flags & PF_X)) {
+            return phdrs[i].p_vaddr & ~(page_size - 1);
+        }
+    }
+    return 0;
+}
 
-int load_library(int fd, elf_header *hdr, elf_phdr *phdrs, void **out_base_addr) {
-    size_t page_size = getpagesize();
+/**
+ * @brief Réserve l'image de sorte que le premier segment exécutable
+ *        commence sur une frontière de 2 Mo.
+ */
+static void *reserve_huge_aligned(size_t total_size, uint64_t base_offset, uint64_t text_vaddr) {
+    size_t span = total_size + HUGE_PAGE_SIZE;
+    char *map = mmap(NULL, span, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+    uintptr_t text = (uintptr_t) map + (text_vaddr - base_offset);
+    uintptr_t aligned = (text + HUGE_PAGE_SIZE - 1) & ~((uintptr_t) HUGE_PAGE_SIZE - 1);
+    char *base = map + (aligned - text);
 
-    // Trouver l'étendue des segments de chargement
-    uint64_t min_addr = UINT64_MAX;
-    uint64_t max_addr = 0;
-    int load_segments = 0;
+    // On rend ce qui dépasse de part et d'autre
+    if (base > map) {
+        munmap(map, base - map);
+    }
+    if (map + span > base + total_size) {
+        munmap(base + total_size, map + span - (base + total_size));
+    }
+    return base;
+}
+
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ  22
+#define MADV_POPULATE_WRITE 23
+#endif
 
+// Rend toutes les pages de la plage présentes, sans attendre le premier accès
+static void populate_range(void *addr, size_t len, int writable, size_t page_size) {
+    if (madvise(addr, len, writable ? MADV_POPULATE_WRITE : MADV_POPULATE_READ) == 0) {
+        return;
+    }
+    // Noyau antérieur à 5.14 : un accès en lecture par page
+    for (size_t off = 0; off < len; off += page_size) {
+        (void) *(volatile const char *) ((const char *) addr + off);
+    }
+}
+
+/**
+ * @brief Applique les politiques de résidence (LOAD_READAHEAD,
+ *        LOAD_POPULATE, LOAD_LOCK) à l'image prête à l'emploi.
+ */
+static void apply_residency(uint64_t base_address, const elf_header *hdr, const elf_phdr *phdrs,
+                            int flags, load_stats_t *stats, size_t page_size) {
     for (int i = 0; i < hdr->e_phnum; i++) {
-        if (phdrs[i].p_type == PT_LOAD) {
-            load_segments++;
+        if (phdrs[i].p_type != PT_LOAD || !(phdrs[i].p_flags & PF_R)) {
+            continue;
+        }
+        uint64_t aligned_vaddr = phdrs[i].p_vaddr & ~(page_size - 1);
+        void *addr = (void *) (base_address + aligned_vaddr);
+        size_t len = (phdrs[i].p_vaddr + phdrs[i].p_memsz - aligned_vaddr + page_size - 1) &
+                     ~(page_size - 1);
 
-            if (phdrs[i].p_vaddr < min_addr)
-                min_addr = phdrs[i].p_vaddr;
+        if (flags & LOAD_READAHEAD) {
+            madvise(addr, len, MADV_WILLNEED);
+        }
+        if (flags & LOAD_POPULATE) {
+            populate_range(addr, len, phdrs[i].p_flags & PF_W, page_size);
+            stats->populated_size += len;
+        }
+        if (flags & LOAD_LOCK) {
+            if (mlock(addr, len) == 0) {
+                stats->locked_size += len;
+            } else {
+                debug_warn("mlock a échoué (RLIMIT_MEMLOCK ?)");
+            }
+        }
+    }
+}
 
-            uint64_t seg_end = phdrs[i].p_vaddr + phdrs[i].p_memsz;
-            if (seg_end > max_addr)
-                max_addr = seg_end;
+/**
+ * @brief Précharge exactement les pages du profil : une lecture anticipée
+ *        groupée dans le fichier, puis un MADV_POPULATE par suite de pages.
+ */
+static void apply_profile(uint64_t base_address, const elf_phdr *phdrs,
+                          const isosprof_t *prof, load_stats_t *stats, size_t page_size) {
+    for (uint32_t i = 0; i < prof->hdr->run_count; i++) {
+        const isosprof_run *run = &prof->runs[i];
+        const elf_phdr *ph = &phdrs[run->segment];
+        uint64_t start = (ph->p_vaddr & ~(page_size - 1)) + (uint64_t) run->first_page * page_size;
+        size_t len = (size_t) run->page_count * page_size;
+        populate_range((void *) (base_address + start), len, ph->p_flags & PF_W, page_size);
+        stats->populated_size += len;
+    }
+}
+
+// Lecture anticipée des parties du fichier couvertes par le profil
+static void readahead_profile(int fd, const elf_phdr *phdrs, const isosprof_t *prof,
+                              size_t page_size) {
+    for (uint32_t i = 0; i < prof->hdr->run_count; i++) {
+        const isosprof_run *run = &prof->runs[i];
+        const elf_phdr *ph = &phdrs[run->segment];
+        uint64_t file_start = (ph->p_offset & ~(page_size - 1)) +
+                              (uint64_t) run->first_page * page_size;
+        uint64_t file_end = ph->p_offset + ph->p_filesz;
+        if (file_start < file_end) {
+            uint64_t len = (uint64_t) run->page_count * page_size;
+            posix_fadvise(fd, file_start, len < file_end - file_start ? len : file_end - file_start,
+                          POSIX_FADV_WILLNEED);
         }
     }
+}
+
+// Permissions finales d'un segment PT_LOAD
+static int segment_prot(const elf_phdr *ph) {
+    int prot = 0;
+    if (ph->p_flags & PF_R) prot |= PROT_READ;
+    if (ph->p_flags & PF_W) prot |= PROT_WRITE;
+    if (ph->p_flags & PF_X) prot |= PROT_EXEC;
+    return prot;
+}
 
-    if (load_segments == 0) {
+int load_library(int fd, const elf_header *hdr, const elf_phdr *phdrs, void **out_base_addr) {
+    return load_library_ex(fd, hdr, phdrs, NULL, NULL, out_base_addr);
+}
+
+/**
+ * @brief Comme load_library(), avec options et bilan.
+ *
+ * @param opts  : options (NULL : aucune). Une réservation fournie doit
+ *        faire au moins la taille donnée par load_extent() ; en cas
+ *        d'échec elle reste réservée.
+ * @param stats : reçoit le bilan du chargement (peut être NULL).
+ */
+int load_library_ex(int fd, const elf_header *hdr, const elf_phdr *phdrs,
+                    const load_options_t *opts, load_stats_t *stats, void **out_base_addr) {
+    size_t page_size = getpagesize();
+    int flags = opts ? opts->flags : 0;
+    load_stats_t local_stats;
+    if (!stats) {
+        stats = &local_stats;
+    }
+    memset(stats, 0, sizeof(*stats));
+
+    // Trouver l'étendue des segments de chargement, alignée sur la page
+    uint64_t base_offset;
+    size_t total_size;
+    if (load_extent(phdrs, hdr->e_phnum, page_size, &base_offset, &total_size) != 0) {
         debug_error("Pas de segments PT_LOAD trouvés");
         return -1;
     }
-
-    // Aligner sur la taille de page
-    uint64_t base_offset = min_addr & ~(page_size - 1);
-
-    size_t total_size = max_addr - base_offset;
-    total_size = (total_size + page_size - 1) & ~(page_size - 1);
+    stats->image_size = total_size;
 
     // Réserver la mémoire (non accessible initialement)
-    void *base_addr = mmap(
-        NULL,
-        total_size,
-        PROT_NONE,
-        MAP_PRIVATE | MAP_ANONYMOUS,
-        -1,
-        0
-    );
+    void *reservation = opts ? opts->reservation : NULL;
+    int shared = reservation != NULL;
+    void *base_addr = reservation;
+    uint64_t text_vaddr = first_text_vaddr(phdrs, hdr->e_phnum, page_size);
+    if (shared && (flags & LOAD_HUGE_TEXT)) {
+        debug_warn("Réservation imposée : texte en pages normales");
+        flags &= ~LOAD_HUGE_TEXT;
+    }
+    // Recopié en grandes pages, le texte deviendrait privé à l'instance
+    if ((flags & LOAD_SHARED_TEXT) && (flags & LOAD_HUGE_TEXT)) {
+        debug_warn("Texte partagé : pages normales");
+        flags &= ~LOAD_HUGE_TEXT;
+    }
+    // Image compressée : segments anonymes, aucune page du fichier à partager
+    // ni à lire d'avance (le conteneur est lu en entier à la décompression)
+    const isosz_t *compressed = opts ? opts->compressed : NULL;
+    if (compressed && (flags & (LOAD_SHARED_TEXT | LOAD_READAHEAD | LOAD_PROFILE))) {
+        debug_info("Image compressée : segments privés, sans lecture anticipée");
+        flags &= ~(LOAD_SHARED_TEXT | LOAD_READAHEAD | LOAD_PROFILE);
+    }
+    if (!shared && (flags & LOAD_HUGE_TEXT) && text_vaddr) {
+        base_addr = reserve_huge_aligned(total_size, base_offset, text_vaddr);
+    } else if (!shared) {
+        base_addr = mmap(
+            NULL,
+            total_size,
+            PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0
+        );
+    }
 
     if (base_addr == MAP_FAILED) {
         debug_error("mmap initial a échoué");
         return -1;
     }
 
+    const isosprof_t *profile = opts && (flags & LOAD_PROFILE) ? opts->profile : NULL;
+
+    // Lecture anticipée du fichier pendant qu'on projette les segments
+    if (profile) {
+        readahead_profile(fd, phdrs, profile, page_size);
+    }
+    // La vérification lit toute la partie fichier des segments : lecture
+    // anticipée d'emblée plutôt que page par page au fil du CRC
+    if ((flags & LOAD_READAHEAD) || ((flags & LOAD_VERIFY) && !compressed)) {
+        for (int i = 0; i < hdr->e_phnum; i++) {
+            if (phdrs[i].p_type == PT_LOAD && phdrs[i].p_filesz > 0) {
+                posix_fadvise(fd, phdrs[i].p_offset, phdrs[i].p_filesz, POSIX_FADV_WILLNEED);
+            }
+        }
+    }
+
     // Calculer l'adresse de base virtuelle
     uint64_t base_address = (uint64_t) base_addr - base_offset;
     debug_info("Adresse de base pour chargement");
@@ -102,7 +365,7 @@ int load_library(int fd, elf_header *hdr, elf_phdr *phdrs, void **out_base_addr)
 
             if ((uint64_t) load_addr % page_size != 0) {
                 debug_error("Adresse pas alignée sur une page");
-                munmap(base_addr, total_size);
+                release_range(base_addr, total_size, shared);
                 return -1;
             }
 
@@ -114,12 +377,35 @@ int load_library(int fd, elf_header *hdr, elf_phdr *phdrs, void **out_base_addr)
 
             debug_detail("Chargement segment PT_LOAD");
 
+            // Segment en lecture seule partagé : protections finales d'emblée.
+            // Jamais inscriptible, il n'est ni copié ni compté dans l'engagement
+            // mémoire : toutes les instances lisent les pages du cache.
+            int prot = PROT_READ | PROT_WRITE;
+            if ((flags & LOAD_SHARED_TEXT) && !(phdrs[i].p_flags & PF_W) &&
+                mem_size == file_size) {
+                prot = segment_prot(&phdrs[i]);
+            }
+
+            // Image compressée : segment anonyme, rempli par isosz_fill().
+            // Toutes ses pages seront écrites : allouées d'un coup plutôt
+            // qu'une faute de page à la fois pendant la décompression
+            if (compressed) {
+                if (mmap(load_addr, aligned_size, PROT_READ | PROT_WRITE,
+                         MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1,
+                         0) == MAP_FAILED) {
+                    debug_error("mmap segment a échoué");
+                    release_range(base_addr, total_size, shared);
+                    return -1;
+                }
+                continue;
+            }
+
             // Mapper la partie du fichier en mémoire
             if (file_size > 0) {
                 void *segment_addr = mmap(
                     load_addr,
                     file_size + offset_in_page,
-                    PROT_READ | PROT_WRITE,
+                    prot,
                     MAP_FIXED | MAP_PRIVATE,
                     fd,
                     phdrs[i].p_offset & ~(page_size - 1)
@@ -127,7 +413,7 @@ int load_library(int fd, elf_header *hdr, elf_phdr *phdrs, void **out_base_addr)
 
                 if (segment_addr == MAP_FAILED) {
                     debug_error("mmap segment a échoué");
-                    munmap(base_addr, total_size);
+                    release_range(base_addr, total_size, shared);
                     return -1;
                 }
             }
@@ -142,7 +428,7 @@ int load_library(int fd, elf_header *hdr, elf_phdr *phdrs, void **out_base_addr)
                 // S'assurer qu'on peut écrire dans cette zone mémoire
                 if (mprotect(load_addr, aligned_size, PROT_READ | PROT_WRITE) != 0) {
                     debug_error("mprotect pour BSS a échoué");
-                    munmap(base_addr, total_size);
+                    release_range(base_addr, total_size, shared);
                     return -1;
                 }
 
@@ -152,14 +438,64 @@ int load_library(int fd, elf_header *hdr, elf_phdr *phdrs, void **out_base_addr)
         }
     }
 
+    if (compressed && isosz_fill(compressed, base_address, phdrs, hdr->e_phnum) != 0) {
+        release_range(base_addr, total_size, shared);
+        return -1;
+    }
+
+    // Intégrité : les lectures du CRC amènent les pages, une seule passe
+    if ((flags & LOAD_VERIFY) &&
+        (!opts->crc32c || integrity_verify(base_address, phdrs, hdr->e_phnum, opts->crc32c,
+                                           &stats->verified_size) != 0)) {
+        debug_error("Échec de la vérification d'intégrité");
+        release_range(base_addr, total_size, shared);
+        return -1;
+    }
+
     // Avant les relocations, tous les segments sont déjà PROT_READ | PROT_WRITE
+    // (sauf les segments partagés, qu'aucune relocation ne doit viser)
     debug_info("Exécution des relocations...");
+    if ((flags & LOAD_SHARED_TEXT) &&
+        relocations_writable((void *) base_address, hdr, phdrs) != 0) {
+        release_range(base_addr, total_size, shared);
+        return -1;
+    }
     if (perform_relocations((void *) base_address, hdr, phdrs) != 0) {
         debug_error("Échec des relocations");
-        munmap(base_addr, total_size);
+        release_range(base_addr, total_size, shared);
         return -1;
     }
 
+    // Texte en grandes pages : chaque tranche de 2 Mo entièrement comprise
+    // dans un segment exécutable est recopiée avant le mprotect final
+    for (int i = 0; i < hdr->e_phnum; i++) {
+        if (phdrs[i].p_type != PT_LOAD || !(phdrs[i].p_flags & PF_X)) {
+            continue;
+        }
+        stats->text_size += phdrs[i].p_memsz;
+        if (!(flags & LOAD_HUGE_TEXT)) {
+            continue;
+        }
+        uint64_t start = (base_address + phdrs[i].p_vaddr + HUGE_PAGE_SIZE - 1) &
+                         ~((uint64_t) HUGE_PAGE_SIZE - 1);
+        uint64_t end = (base_address + phdrs[i].p_vaddr + phdrs[i].p_memsz) &
+                       ~((uint64_t) HUGE_PAGE_SIZE - 1);
+        if (end <= start) {
+            debug_info("Segment de texte plus petit qu'une grande page");
+            continue;
+        }
+        size_t huge_bytes;
+        int pages = remap_text_huge((void *) start, end - start, &huge_bytes);
+        if (pages < 0) {
+            release_range(base_addr, total_size, shared);
+            return -1;
+        }
+        stats->text_huge_size += huge_bytes;
+        if (pages > stats->text_pages) {
+            stats->text_pages = pages;
+        }
+    }
+
     // Après les relocations, appliquer les protections finales
     debug_info("Application des protections finales...");
     for (int i = 0; i < hdr->e_phnum; i++) {
@@ -172,39 +508,43 @@ int load_library(int fd, elf_header *hdr, elf_phdr *phdrs, void **out_base_addr)
             size_t raw_size = phdrs[i].p_memsz + offset_in_page;
             size_t aligned_size = (raw_size + page_size - 1) & ~(page_size - 1);
 
-            // Déterminer les permissions finales
-            int prot = 0;
-            if (phdrs[i].p_flags & PF_R) prot |= PROT_READ;
-            if (phdrs[i].p_flags & PF_W) prot |= PROT_WRITE;
-            if (phdrs[i].p_flags & PF_X) prot |= PROT_EXEC;
-
             debug_detail("Protection finale segment");
 
-            if (mprotect(load_addr, aligned_size, prot) != 0) {
+            if (mprotect(load_addr, aligned_size, segment_prot(&phdrs[i])) != 0) {
                 debug_error("mprotect final a échoué");
-                munmap(base_addr, total_size);
+                release_range(base_addr, total_size, shared);
                 return -1;
             }
         }
     }
 
-    // Enregistrer l'état global de la bibliothèque
-    g_base_addr = (void *) base_address;
-    memcpy_safe(&g_hdr, hdr, sizeof(elf_header));
-    // On libère l'ancien si nécessaire
-    if (g_phdrs) {
-        free(g_phdrs);
+    // PLT standard : les imports seront liés au premier appel
+    int lazy_plt = 0;
+    if (opts && opts->plt_resolver) {
+        lazy_plt = setup_lazy_plt((void *) base_address, hdr, phdrs, opts->plt_handle,
+                                  opts->plt_resolver);
+        if (lazy_plt < 0) {
+            release_range(base_addr, total_size, shared);
+            return -1;
+        }
     }
 
-    // On copie les headers de programme
-  if (hdr->e_phnum > 0) {
-    g_phdrs = malloc(hdr->e_phnum * sizeof(elf_phdr));
-    if (g_phdrs) {
-        memcpy_safe(g_phdrs, phdrs, hdr->e_phnum * sizeof(elf_phdr));
+    // Les résolveurs IFUNC sont du code de la bibliothèque : ils ne peuvent
+    // s'exécuter qu'une fois le segment de texte exécutable. Leurs cibles
+    // (GOT, données) sont dans des segments PF_W, encore inscriptibles.
+    if (perform_ifunc_relocations((void *) base_address, hdr, phdrs, lazy_plt > 0) != 0) {
+        debug_error("Échec des relocations IFUNC");
+        release_range(base_addr, total_size, shared);
+        return -1;
     }
-    } else {
-        g_phdrs = NULL;  // Pas de headers de programme à copier
+
+    if (flags & (LOAD_READAHEAD | LOAD_POPULATE | LOAD_LOCK)) {
+        apply_residency(base_address, hdr, phdrs, flags, stats, page_size);
+    }
+    if (profile && !(flags & LOAD_POPULATE)) {
+        apply_profile(base_address, phdrs, profile, stats, page_size);
     }
+
     *out_base_addr = (void *) base_address;
     return 0;
 }
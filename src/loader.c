@@ -1,30 +1,25 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <argp.h>
 #include <unistd.h>
 #include <stddef.h>
+#include <dlfcn.h>
 #include "loader.h"
 #include "dynloader.h"
 #include "debug.h"
 #include "isos-support.h"
 
-#define DT_NULL     0
-#define DT_STRTAB   5
-#define DT_SYMTAB   6
-
 /**
- * @brief The function loader_plt_resolver() is used to resolve symbols
+ * @brief The function loader_plt_bind() is used to resolve symbols
  * in the PLT (Procedure Linkage Table) section of a shared library.
  *
  * @param handle Pointer to the shared library handle.
  * @param sym_id The ID of the symbol to resolve.
  * @return Pointer to the function address if successful, NULL otherwise.
- * @brief The function isos_trampoline() is called by the PLT section
- * entry for each imported symbol inside the DL library.
-*/
-
-void *loader_plt_resolver(void *handle, int sym_id) {
+ */
+void *loader_plt_bind(void *handle, int sym_id) {
     if (!handle) {
         debug_error("Invalid handle in PLT resolver");
         return NULL;
@@ -33,6 +28,12 @@ void *loader_plt_resolver(void *handle, int sym_id) {
     // Cast handle to our loader_info structure
     lib_handle_t *loader_info = (lib_handle_t *) handle;
 
+    // Seuls les ids de la table des imports ont un nom (et un slot)
+    if (sym_id < 0 || sym_id >= loader_info->plt_bound_count) {
+        debug_error("Invalid symbol ID");
+        return NULL;
+    }
+
     // Step 1: Get symbol name from ID using the imported symbols table
     const char *sym_name = get_symbol_name_by_id(loader_info->imported_symbols, sym_id);
     if (!sym_name) {
@@ -49,9 +50,101 @@ void *loader_plt_resolver(void *handle, int sym_id) {
         return NULL;
     }
 
+    // Profil des appels : le slot mène au stub de comptage de l'import
+    func_addr = callstats_bind(loader_info->callstats, sym_id, func_addr);
+
+    // Step 3: Bind the slot so that the trampoline jumps directly next time
+    __atomic_store_n(&loader_info->plt_bound[sym_id], func_addr, __ATOMIC_RELEASE);
+
     return func_addr;
 }
 
+/**
+ * @brief The function loader_plt_resolver() is called by isos_trampoline
+ * on the first call of an import. The trampoline jumps to the returned
+ * address, so an import that cannot be resolved terminates the process
+ * like ld.so does (see loader_jmprel_resolver()).
+ */
+void *loader_plt_resolver(void *handle, int sym_id) {
+    void *addr = loader_plt_bind(handle, sym_id);
+    if (!addr) {
+        lib_handle_t *lib = (lib_handle_t *) handle;
+        const char *name = "?";
+        if (lib && lib->imported_symbols && sym_id >= 0 && sym_id < lib->plt_bound_count) {
+            name = lib->imported_symbols[sym_id];
+        }
+        fprintf(stderr, "isos_loader: symbol lookup error: undefined symbol: %s\n", name);
+        _exit(127);
+    }
+    return addr;
+}
+
+// Cherche name dans la table fournie par my_set_plt_resolve(), sans message
+static void *resolve_table_lookup(const symbol_entry *table, const char *name) {
+    for (int i = 0; table && table[i].name; i++) {
+        if (strcmp(table[i].name, name) == 0) {
+            return table[i].addr;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Lie le slot JUMP_SLOT n° reloc_index d'une PLT standard.
+ *
+ * Le symbole est cherché dans la table de my_set_plt_resolve(), puis
+ * dans les bibliothèques de l'espace du handle (ordre de chargement),
+ * puis dans le processus hôte (dlsym(RTLD_DEFAULT)). Le slot de la GOT
+ * est ensuite réécrit : les appels suivants sautent directement sur la
+ * cible.
+ *
+ * @return l'adresse liée, NULL si le symbole reste introuvable.
+ */
+void *loader_jmprel_bind(void *handle, long reloc_index) {
+    lib_handle_t *lib = (lib_handle_t *) handle;
+    if (!lib || !lib->jmprel || reloc_index < 0 || reloc_index >= lib->jmprel_count) {
+        debug_error("Invalid PLT relocation");
+        return NULL;
+    }
+    const Elf64_Rela *rela = &lib->jmprel[reloc_index];
+    const char *name = lib->dynstr + lib->dynsym[ELF64_R_SYM(rela->r_info)].st_name;
+
+    void *addr = resolve_table_lookup(lib->plt_resolve_table, name);
+    if (!addr) {
+        addr = my_dlsym_ns(lib->ns, name, NULL);
+    }
+    if (!addr) {
+        addr = dlsym(RTLD_DEFAULT, name);
+    }
+    if (!addr) {
+        return NULL;
+    }
+    addr = callstats_bind(lib->callstats, lib->plt_bound_count + (int) reloc_index, addr);
+    uint64_t *slot = (uint64_t *) ((char *) lib->base_addr + rela->r_offset);
+    __atomic_store_n(slot, (uint64_t) addr, __ATOMIC_RELEASE);
+    debug_detail("Slot JUMP_SLOT lié");
+    return addr;
+}
+
+/**
+ * @brief Équivalent de _dl_runtime_resolve, appelé par isos_dl_resolve
+ *        (GOT[2]) au premier appel d'un import. Comme ld.so, un symbole
+ *        introuvable termine le processus.
+ */
+void *loader_jmprel_resolver(void *handle, long reloc_index) {
+    void *addr = loader_jmprel_bind(handle, reloc_index);
+    if (!addr) {
+        lib_handle_t *lib = (lib_handle_t *) handle;
+        const char *name = "?";
+        if (lib && lib->jmprel && reloc_index >= 0 && reloc_index < lib->jmprel_count) {
+            name = lib->dynstr + lib->dynsym[ELF64_R_SYM(lib->jmprel[reloc_index].r_info)].st_name;
+        }
+        fprintf(stderr, "isos_loader: symbol lookup error: undefined symbol: %s\n", name);
+        _exit(127);
+    }
+    return addr;
+}
+
 /**
  * Initialise la bibliothèque en configurant les pointeurs loader_info
  *
@@ -0,0 +1,185 @@
+#include "lz4_block.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LZ4_HASH_LOG 16
+
+static uint32_t read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - LZ4_HASH_LOG);
+}
+
+// Longueur au-delà de 15 : suite d'octets 255 terminée par le reste
+static uint8_t *write_length(uint8_t *op, size_t len) {
+    for (; len >= 255; len -= 255) {
+        *op++ = 255;
+    }
+    *op++ = (uint8_t) len;
+    return op;
+}
+
+// Pire cas : aucune correspondance, un octet de longueur par 255 littéraux
+size_t lz4_compress_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+/*
+ * Séquence : littéraux [anchor, anchor + lit), puis correspondance de
+ * match_len octets à distance offset (match_len 0 : dernière séquence).
+ * Retourne NULL si dst est trop petit.
+ */
+static uint8_t *emit_sequence(uint8_t *op, const uint8_t *op_end, const uint8_t *anchor,
+                              size_t lit, size_t offset, size_t match_len) {
+    if ((size_t) (op_end - op) < 1 + lit + lit / 255 + 1 + 2 + match_len / 255 + 1) {
+        return NULL;
+    }
+    uint8_t *token = op++;
+    *token = (uint8_t) ((lit < 15 ? lit : 15) << 4);
+    if (lit >= 15) {
+        op = write_length(op, lit - 15);
+    }
+    memcpy(op, anchor, lit);
+    op += lit;
+    if (match_len == 0) {
+        return op;
+    }
+    *op++ = (uint8_t) offset;
+    *op++ = (uint8_t) (offset >> 8);
+    size_t ml = match_len - LZ4_MIN_MATCH;
+    *token |= (uint8_t) (ml < 15 ? ml : 15);
+    if (ml >= 15) {
+        op = write_length(op, ml - 15);
+    }
+    return op;
+}
+
+/**
+ * @brief Compresse src en un bloc LZ4.
+ *
+ * @return la taille du bloc, 0 s'il ne tient pas dans capacity (données
+ *         incompressibles : à stocker telles quelles) ou en cas d'échec.
+ */
+size_t lz4_compress(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity) {
+    uint32_t *table = calloc(1u << LZ4_HASH_LOG, sizeof(uint32_t));
+    if (!table) {
+        return 0;
+    }
+    uint8_t *op = dst;
+    const uint8_t *op_end = dst + capacity;
+    size_t anchor = 0;
+    size_t ip = 0;
+
+    while (op && ip + LZ4_MFLIMIT <= size) {
+        uint32_t seq = read32(src + ip);
+        uint32_t h = hash4(seq);
+        // Positions décalées de 1 : 0 marque une entrée vide
+        size_t ref = table[h];
+        table[h] = (uint32_t) (ip + 1);
+        if (ref == 0 || ip + 1 - ref > LZ4_MAX_DISTANCE || read32(src + ref - 1) != seq) {
+            // Accélération dans les zones sans correspondance
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+        ref--;
+
+        // Extension vers l'arrière, puis vers l'avant jusqu'aux derniers littéraux
+        while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+            ip--;
+            ref--;
+        }
+        size_t len = LZ4_MIN_MATCH;
+        size_t limit = size - LZ4_LAST_LITERALS;
+        while (ip + len < limit && src[ref + len] == src[ip + len]) {
+            len++;
+        }
+
+        op = emit_sequence(op, op_end, src + anchor, ip - anchor, ip - ref, len);
+        ip += len;
+        anchor = ip;
+        if (ip >= 2 && ip + LZ4_MFLIMIT <= size) {
+            table[hash4(read32(src + ip - 2))] = (uint32_t) (ip - 1);
+        }
+    }
+    if (op) {
+        op = emit_sequence(op, op_end, src + anchor, size - anchor, 0, 0);
+    }
+    free(table);
+    return op ? (size_t) (op - dst) : 0;
+}
+
+/**
+ * @brief Décompresse un bloc LZ4 qui doit produire exactement out_size
+ *        octets.
+ *
+ * @return 0 en cas de succès, -1 si le bloc est corrompu.
+ */
+int lz4_decompress(const uint8_t *src, size_t size, uint8_t *dst, size_t out_size) {
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < size) {
+        uint8_t token = src[ip++];
+
+        size_t lit = token >> 4;
+        if (lit == 15) {
+            uint8_t b;
+            do {
+                if (ip >= size) {
+                    return -1;
+                }
+                b = src[ip++];
+                lit += b;
+            } while (b == 255);
+        }
+        if (lit > size - ip || lit > out_size - op) {
+            return -1;
+        }
+        memcpy(dst + op, src + ip, lit);
+        ip += lit;
+        op += lit;
+        if (ip == size) {
+            break;      // dernière séquence : littéraux seuls
+        }
+
+        if (size - ip < 2) {
+            return -1;
+        }
+        size_t offset = src[ip] | ((size_t) src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            return -1;
+        }
+        size_t len = token & 15;
+        if (len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= size) {
+                    return -1;
+                }
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        len += LZ4_MIN_MATCH;
+        if (len > out_size - op) {
+            return -1;
+        }
+
+        // Recouvrement (distance courte) : le motif déjà écrit est recopié
+        // par tranches dont la taille double, toujours multiples de offset
+        size_t dist = offset;
+        while (len > 0) {
+            size_t chunk = len < dist ? len : dist;
+            memcpy(dst + op, dst + op - dist, chunk);
+            op += chunk;
+            len -= chunk;
+            dist += chunk;
+        }
+    }
+    return op == out_size ? 0 : -1;
+}
@@ -3,7 +3,13 @@
 #include <string.h>
 #include <argp.h>
 #include <unistd.h>
-#include "dynloader.h"
+#include <time.h>
+#include <elf.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include "isosloader.h"
+#include "histogram.h"
+#include "zygote.h"
 #include "debug.h"
 #include "loader.h"
 
@@ -13,12 +19,34 @@ const char *argp_program_bug_address = "<adnane.elogri@univ-rennes1.fr>";
 
 // Documentation
 static char doc[] = "ISOS Loader - charge et exécute des fonctions depuis des bibliothèques partagées";
-static char args_doc[] = "LIBRARY_PATH FUNCTION_NAME [FUNCTION_NAME...]";
+static char args_doc[] = "LIBRARY_PATH [FUNCTION_NAME...]";
 
 // Options de ligne de commande
 static struct argp_option options[] = {
     {"verbose", 'v', 0, 0, "Print more info", 0},
     {"debug", 'd', "LEVEL", 0, "Set debug level (0-5)", 0},
+    {"functions", 'f', "FILE", 0, "Read function names from FILE ('-' for stdin)", 0},
+    {"repeat", 'r', "N", 0, "Call each function N times and report ns/call", 0},
+    {"duration", 't', "SECONDS", 0, "Call each function for SECONDS and report ns/call", 0},
+    {"batch", 'b', "N", 0, "Calls per timed batch in repeat mode (default 64, 1 for per-call percentiles)", 0},
+    {"from-memory", 'm', 0, 0, "Read LIBRARY_PATH ('-' for stdin) into memory and load it with my_dlopen_mem", 0},
+    {"serve", 'S', "SOCKET", 0, "Load every LIBRARY_PATH argument once and serve calls on SOCKET", 0},
+    {"connect", 'c', "SOCKET", 0, "Run FUNCTION_NAMEs through the server listening on SOCKET", 0},
+    {"packed", 'p', 0, 0, "Load the libraries back to back in one shared reservation (my_dlopen_packed)", 0},
+    {"huge-text", 'H', 0, 0, "Back the library text with 2 MiB pages when possible and print the load stats", 0},
+    {"policy", 'P', "POLICY", 0, "Residency policy: lazy (default), readahead, populate, lock, profile; comma-separated", 0},
+    {"record-profile", 'W', 0, 0, "After the calls, write the pages they touched to LIBRARY_PATH" ISOSPROF_SUFFIX, 0},
+    {"faults", 'F', 0, 0, "Report the page faults taken by the first call of each function", 0},
+    {"meminfo", 'M', 0, 0, "After the calls, report resident, shared, private dirty and swap bytes per segment", 0},
+    {"global", 'G', "LIBRARIES", 0, "Also load LIBRARIES (comma-separated) and resolve the functions over all libraries in load order (my_dlsym_global)", 0},
+    {"namespaces", 'n', "N", 0, "Load N private instances of LIBRARY_PATH, one per namespace (my_dlmopen), and call the functions in each", 0},
+    {"async", 'A', 0, 0, "Load LIBRARY_PATH on the loader thread (my_dlopen_async, io_uring) and wait for it", 0},
+    {"reload", 'R', "NEW_LIBRARY", 0, "Call the functions, hot-reload NEW_LIBRARY with my_dlreload and call them again", 0},
+    {"checksum", 'C', 0, 0, "Embed the CRC32C of every PT_LOAD segment of LIBRARY_PATH in a " INTEGRITY_SECTION " note and exit", 0},
+    {"verify", 'V', 0, 0, "Check the segments against the " INTEGRITY_SECTION " note while loading (CRC32C) and refuse a damaged library", 0},
+    {"compress", 'z', "OUTPUT", 0, "Write LIBRARY_PATH as a compressed container (" ISOSZ_SUFFIX ") to OUTPUT and exit; containers load like libraries", 0},
+    {"stats", 's', "PERIOD", OPTION_ARG_OPTIONAL, "Count the calls of every import through a stub and time one call in PERIOD (default 128, 0: counts only); print them after the calls", 0},
+    {"index", 'i', 0, 0, "Write the LIBRARY_PATH" ISOSIDX_SUFFIX " symbol index and exit", 0},
     {0}
 };
 
@@ -27,10 +55,36 @@ struct arguments {
     char *lib_path;
     char **func_names;
     int func_count;
+    int func_capacity;
     int verbose;
     int debug_level;
+    const char *func_file;
+    long repeat;
+    double duration;
+    long batch;
+    int index;
+    int from_memory;
+    const char *serve_socket;
+    const char *connect_socket;
+    const char *reload_path;
+    const char *global_libs;
+    int packed;
+    int load_flags;
+    int faults;
+    int record_profile;
+    int meminfo;
+    int namespaces;
+    int async;
+    const char *compress_path;
+    int checksum;
+    long stats_period;
 };
 
+#define DEFAULT_BATCH 64
+
+// Pile touchée avant de compter les défauts des premiers appels
+#define PREFAULT_STACK_SIZE (32 * 1024)
+
 // Fonctions exportées pour les bibliothèques
 const char *new_bar() {
     return "Hello from new_bar()";
@@ -40,13 +94,121 @@ const char *new_foo() {
     return "Hello from new_foo()";
 }
 
+const char *new_args(long a, long b, long c, long d, long e, long f, double x) {
+    static char buf[128];
+    snprintf(buf, sizeof(buf), "Hello from new_args(%ld, %ld, %ld, %ld, %ld, %ld, %.1f)",
+             a, b, c, d, e, f, x);
+    return buf;
+}
+
 // Table des symboles exportés pour les bibliothèques
 symbol_entry imported_functions[] = {
     {"new_foo", (void *) new_foo},
     {"new_bar", (void *) new_bar},
+    {"new_args", (void *) new_args},
     {NULL, NULL} // Fin de la table
 };
 
+// Fonction de imported_functions servant l'import name, NULL sinon
+static void *host_function(const char *name) {
+    for (int i = 0; imported_functions[i].name; i++) {
+        if (strcmp(imported_functions[i].name, name) == 0) {
+            return imported_functions[i].addr;
+        }
+    }
+    return NULL;
+}
+
+// Implémentation du CRC32C retenue par le loader
+static const char *crc32c_kind(void) {
+#if defined(__x86_64__)
+    return __builtin_cpu_supports("sse4.2") ? "SSE4.2" : "table";
+#else
+    return "table";
+#endif
+}
+
+// Ajoute un nom de fonction (copié) à la liste à exécuter
+static int add_function(struct arguments *args, const char *name) {
+    if (args->func_count == args->func_capacity) {
+        int capacity = args->func_capacity ? args->func_capacity * 2 : 16;
+        char **names = realloc(args->func_names, capacity * sizeof(char *));
+        if (!names) {
+            perror("realloc failed");
+            return -1;
+        }
+        args->func_names = names;
+        args->func_capacity = capacity;
+    }
+    args->func_names[args->func_count] = strdup(name);
+    if (!args->func_names[args->func_count]) {
+        perror("strdup failed");
+        return -1;
+    }
+    args->func_count++;
+    return 0;
+}
+
+// Lit un nom de fonction par ligne ; lignes vides et commentaires ignorés
+static int read_function_file(struct arguments *args, const char *path) {
+    FILE *file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!file) {
+        perror("fopen failed");
+        return -1;
+    }
+
+    char *line = NULL;
+    size_t size = 0;
+    int ret = 0;
+    while (getline(&line, &size, file) != -1) {
+        line[strcspn(line, " \t\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+        if (add_function(args, line) != 0) {
+            ret = -1;
+            break;
+        }
+    }
+
+    free(line);
+    if (file != stdin) {
+        fclose(file);
+    }
+    return ret;
+}
+
+// Politiques de résidence acceptées par --policy
+static const struct {
+    const char *name;
+    int flags;
+} policies[] = {
+    {"lazy", 0},
+    {"readahead", LOAD_READAHEAD},
+    {"populate", LOAD_POPULATE},
+    {"lock", LOAD_LOCK},
+    {"profile", LOAD_PROFILE},
+};
+
+// Convertit "readahead,lock" en options LOAD_* ; -1 si un nom est inconnu
+static int parse_policy(const char *list) {
+    int flags = 0;
+    while (*list) {
+        size_t len = strcspn(list, ",");
+        size_t i = 0;
+        while (i < sizeof(policies) / sizeof(policies[0]) &&
+               !(strlen(policies[i].name) == len && strncmp(policies[i].name, list, len) == 0)) {
+            i++;
+        }
+        if (i == sizeof(policies) / sizeof(policies[0])) {
+            return -1;
+        }
+        flags |= policies[i].flags;
+        list += len + (list[len] == ',');
+    }
+    return flags;
+}
+
 // Traitement des options
 static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     struct arguments *args = state->input;
@@ -60,22 +222,103 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
             if (args->debug_level < 0) args->debug_level = 0;
             if (args->debug_level > 5) args->debug_level = 5;
             break;
+        case 'f':
+            args->func_file = arg;
+            break;
+        case 'r':
+            args->repeat = atol(arg);
+            if (args->repeat < 0) args->repeat = 0;
+            break;
+        case 't':
+            args->duration = atof(arg);
+            if (args->duration < 0) args->duration = 0;
+            break;
+        case 'b':
+            args->batch = atol(arg);
+            if (args->batch < 1) args->batch = 1;
+            break;
+        case 'i':
+            args->index = 1;
+            break;
+        case 'm':
+            args->from_memory = 1;
+            break;
+        case 'S':
+            args->serve_socket = arg;
+            break;
+        case 'c':
+            args->connect_socket = arg;
+            break;
+        case 'R':
+            args->reload_path = arg;
+            break;
+        case 'G':
+            args->global_libs = arg;
+            break;
+        case 'p':
+            args->packed = 1;
+            break;
+        case 'H':
+            args->load_flags |= LOAD_HUGE_TEXT;
+            break;
+        case 'P': {
+            int flags = parse_policy(arg);
+            if (flags < 0) {
+                argp_error(state, "unknown policy: %s", arg);
+            }
+            args->load_flags |= flags;
+            break;
+        }
+        case 'F':
+            args->faults = 1;
+            break;
+        case 'W':
+            args->record_profile = 1;
+            break;
+        case 'M':
+            args->meminfo = 1;
+            break;
+        case 'C':
+            args->checksum = 1;
+            break;
+        case 'V':
+            args->load_flags |= LOAD_VERIFY;
+            break;
+        case 'z':
+            args->compress_path = arg;
+            break;
+        case 'A':
+            args->async = 1;
+            break;
+        case 's':
+            args->load_flags |= LOAD_CALLSTATS;
+            if (arg) {
+                args->stats_period = atol(arg);
+                if (args->stats_period < 0) {
+                    argp_error(state, "invalid sample period: %s", arg);
+                }
+            }
+            break;
+        case 'n':
+            args->namespaces = atoi(arg);
+            if (args->namespaces < 1) {
+                argp_error(state, "invalid namespace count: %s", arg);
+            }
+            break;
         case ARGP_KEY_ARG:
             if (state->arg_num == 0) {
                 args->lib_path = arg;
-            } else {
-                if (state->arg_num == 1) {
-                    args->func_names = malloc(sizeof(char *) * (state->argc - 1));
-                    if (!args->func_names) {
-                        argp_usage(state);
-                        return ENOMEM;
-                    }
-                }
-                args->func_names[args->func_count++] = arg;
+            } else if (add_function(args, arg) != 0) {
+                return ENOMEM;
             }
             break;
         case ARGP_KEY_END:
-            if (state->arg_num < 2) {
+            if (args->func_file && read_function_file(args, args->func_file) != 0) {
+                argp_failure(state, 1, 0, "cannot read function list %s", args->func_file);
+            }
+            if (state->arg_num < 1 ||
+                (args->func_count == 0 && !args->index && !args->serve_socket &&
+                 !args->compress_path && !args->checksum)) {
                 argp_usage(state);
             }
             break;
@@ -88,9 +331,469 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
 // Parser argp
 static struct argp argp = {options, parse_opt, args_doc, doc, 0, 0, 0};
 
-// Fonction utilitaire pour écrire directement sur stdout
-static void write_stdout(const char *msg) {
-    printf("%s", msg);
+typedef const char *(*str_fn)();
+
+// Lit tout le fichier (ou stdin pour "-") dans un tampon alloué
+static void *read_all(const char *path, size_t *len) {
+    FILE *file = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (!file) {
+        perror("fopen failed");
+        return NULL;
+    }
+
+    size_t capacity = 1 << 16;
+    size_t size = 0;
+    char *buf = malloc(capacity);
+    while (buf) {
+        size += fread(buf + size, 1, capacity - size, file);
+        if (size < capacity) {
+            break;
+        }
+        capacity *= 2;
+        char *grown = realloc(buf, capacity);
+        if (!grown) {
+            free(buf);
+        }
+        buf = grown;
+    }
+    if (!buf || ferror(file)) {
+        perror("read failed");
+        free(buf);
+        buf = NULL;
+    }
+    if (file != stdin) {
+        fclose(file);
+    }
+    *len = size;
+    return buf;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+// Affiche une ligne de résultat ; l'histogramme est en picosecondes, un
+// échantillon par lot. Avec batch > 1 les percentiles sont ceux des
+// moyennes par lot, pas ceux des appels : le libellé le dit.
+static void print_latency(const char *label, const histogram_t *hist, uint64_t calls, long batch) {
+    printf("%-28s calls=%-10lu mean=%8.2f %sp50=%8.2f p99=%8.2f p999=%8.2f max=%8.2f ns/call\n",
+           label, (unsigned long) calls, hist_mean(hist) / 1000.0,
+           batch > 1 ? "per-batch mean " : "", hist_percentile(hist, 50.0) / 1000.0,
+           hist_percentile(hist, 99.0) / 1000.0, hist_percentile(hist, 99.9) / 1000.0,
+           hist->max / 1000.0);
+}
+
+// Arguments définis passés à chaque import mesuré (new_args() en prend 7)
+#define IMPORT_ARGS 1, 2, 3, 4, 5, 6, 7.5
+typedef const char *(*import_fn)(long, long, long, long, long, long, double);
+
+/**
+ * @brief Appelle fn par lots de args->batch appels jusqu'à atteindre
+ * --repeat appels ou --duration secondes, et enregistre le temps moyen
+ * par appel de chaque lot. Avec --batch 1, chaque échantillon est un
+ * appel (lecture de l'horloge comprise).
+ *
+ * @param import : import appelé directement avec IMPORT_ARGS, au lieu de fn.
+ * @param handle/sym_id : si handle est non NULL, l'import sym_id est
+ *        appelé avec IMPORT_ARGS par my_dlplt_call(), rejeu synthétique
+ *        d'une entrée PLT (push id ; push handle ; jmp isos_trampoline)
+ *        depuis le loader : pas un appel depuis le code de la bibliothèque.
+ * @return le nombre d'appels effectués.
+ */
+static uint64_t measure_calls(struct arguments *args, str_fn fn, import_fn import, void *handle,
+                              long sym_id, histogram_t *hist) {
+    uint64_t deadline = args->duration > 0 ? now_ns() + (uint64_t) (args->duration * 1e9) : 0;
+    uint64_t calls = 0;
+    hist_init(hist);
+
+    while ((args->repeat == 0 || calls < (uint64_t) args->repeat) &&
+           (deadline == 0 || now_ns() < deadline)) {
+        long batch = args->batch;
+        if (args->repeat > 0 && (uint64_t) args->repeat - calls < (uint64_t) batch) {
+            batch = args->repeat - calls;
+        }
+
+        uint64_t start = now_ns();
+        if (handle) {
+#if defined(__x86_64__)
+            for (long i = 0; i < batch; i++) {
+                my_dlplt_call(IMPORT_ARGS, handle, sym_id);
+                asm volatile("" ::: "memory");
+            }
+#endif
+        } else if (import) {
+            for (long i = 0; i < batch; i++) {
+                import(IMPORT_ARGS);
+                asm volatile("" ::: "memory");
+            }
+        } else {
+            for (long i = 0; i < batch; i++) {
+                fn();
+                asm volatile("" ::: "memory");
+            }
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        hist_record(hist, elapsed * 1000 / batch);
+        calls += batch;
+    }
+    return calls;
+}
+
+// Mode débit : mesure chaque fonction puis compare PLT et appel direct
+static void run_throughput(struct arguments *args, void *handle, void **func_addrs) {
+    histogram_t hist;
+
+    printf("== Appels des fonctions (batch=%ld) ==\n", args->batch);
+    for (int i = 0; i < args->func_count; i++) {
+        if (!func_addrs[i]) {
+            debug_warn("Function not found in the library");
+            continue;
+        }
+        uint64_t calls = measure_calls(args, (str_fn) func_addrs[i], NULL, NULL, 0, &hist);
+        print_latency(args->func_names[i], &hist, calls, args->batch);
+    }
+
+#if defined(__x86_64__)
+    // Chaque import : rejeu de son entrée PLT (slot lié) contre pointeur direct
+    printf("== Imports : rejeu synthétique de l'entrée PLT (my_dlplt_call) vs appel direct ==\n");
+    const char *name;
+    for (int id = 0; (name = my_dlimport_name(handle, id)) != NULL; id++) {
+        void *target = host_function(name);
+        if (!target) {
+            continue;
+        }
+        char label[64];
+
+        // Un appel rejoué d'abord : ce que l'import reçoit, et sa réponse
+        snprintf(label, sizeof(label), "%s [plt replay]", name);
+        printf("%-28s => %s\n", label, (const char *) my_dlplt_call(IMPORT_ARGS, handle, id));
+
+        uint64_t calls = measure_calls(args, NULL, NULL, handle, id, &hist);
+        print_latency(label, &hist, calls, args->batch);
+
+        calls = measure_calls(args, NULL, (import_fn) target, NULL, 0, &hist);
+        snprintf(label, sizeof(label), "%s [direct]", name);
+        print_latency(label, &hist, calls, args->batch);
+    }
+#endif
+}
+
+// Mode client : chaque fonction est exécutée par un fils du zygote
+static int run_client(struct arguments *args) {
+    int status = 0;
+    for (int i = 0; i < args->func_count; i++) {
+        char reply[ZYGOTE_MAX_REQUEST];
+        int ret = zygote_request(args->connect_socket, args->lib_path, args->func_names[i],
+                                 reply, sizeof(reply));
+        if (ret < 0) {
+            debug_error("Zygote injoignable");
+            return 1;
+        }
+        if (ret > 0) {
+            debug_warn(reply);
+            status = 1;
+            continue;
+        }
+        printf("Résultat de l'appel: %s\n", reply);
+    }
+    return status;
+}
+
+// Bilan mémoire de l'image, segment par segment (en Kio)
+static void print_meminfo(const char *path, void *handle) {
+    lib_meminfo_t info;
+    if (my_dlmeminfo(handle, &info) != 0) {
+        debug_warn("Bilan mémoire incomplet");
+    }
+    printf("Mémoire de %s (Kio):\n", path);
+    // Largeurs fixées à la main : printf compte les octets des caractères accentués
+    printf("  segment    adresse           taille  résident       rss       pss   partagé "
+           "privé mod      swap\n");
+    for (int i = 0; i <= info.count; i++) {
+        const segment_meminfo_t *seg = i < info.count ? &info.segments[i] : &info.total;
+        char name[16];
+        char addr[24];
+        if (i < info.count) {
+            snprintf(name, sizeof(name), "%d %c%c%c", seg->segment,
+                     (seg->flags & PF_R) ? 'R' : '-', (seg->flags & PF_W) ? 'W' : '-',
+                     (seg->flags & PF_X) ? 'X' : '-');
+            snprintf(addr, sizeof(addr), "%p", seg->start);
+        } else {
+            snprintf(name, sizeof(name), "total");
+            addr[0] = '\0';
+        }
+        printf("  %-10s %-14s %9zu %9zu %9zu %9zu %9zu %9zu %9zu\n", name, addr,
+               seg->size >> 10, seg->resident >> 10, seg->rss >> 10, seg->pss >> 10,
+               seg->shared >> 10, seg->private_dirty >> 10, seg->swap >> 10);
+    }
+}
+
+// Mode serveur : toutes les bibliothèques sont chargées et liées avant fork
+static int run_server(struct arguments *args) {
+    int count = args->func_count + 1;
+    char **paths = malloc(count * sizeof(char *));
+    void **handles = malloc(count * sizeof(void *));
+    if (!paths || !handles) {
+        perror("malloc failed");
+        free(paths);
+        free(handles);
+        return 1;
+    }
+    paths[0] = args->lib_path;
+    memcpy(paths + 1, args->func_names, args->func_count * sizeof(char *));
+
+    // Toutes les bibliothèques servies peuvent partager une seule réservation
+    void *pack = args->packed ? my_dlpack_create(0) : NULL;
+    int status = 0;
+    int loaded = 0;
+    if (args->packed && !pack) {
+        debug_error("Échec de la création du pack");
+        status = 1;
+        count = 0;
+    }
+    for (; loaded < count; loaded++) {
+        handles[loaded] = pack ? my_dlopen_packed(pack, paths[loaded])
+                               : my_dlopen_flags(paths[loaded], args->load_flags);
+        if (!handles[loaded] || my_set_plt_resolve(handles[loaded], imported_functions) != 0) {
+            debug_error("Échec du chargement");
+            status = 1;
+            break;
+        }
+        if (my_dlprebind(handles[loaded]) != 0) {
+            debug_warn("Imports non résolus au chargement");
+        }
+    }
+
+    for (int i = 0; args->meminfo && i < loaded; i++) {
+        print_meminfo(paths[i], handles[i]);
+    }
+
+    if (status == 0 && zygote_serve(args->serve_socket, paths, handles, count) != 0) {
+        status = 1;
+    }
+
+    for (int i = 0; i < loaded; i++) {
+        my_dlclose(handles[i]);
+    }
+    if (pack) {
+        my_dlpack_destroy(pack);
+    }
+    free(paths);
+    free(handles);
+    return status;
+}
+
+// Bilan du chargement : taille de l'image et pages du texte
+static void print_load_stats(const load_stats_t *stats) {
+    static const char *const page_kinds[] = {"pages normales", "THP", "hugetlbfs"};
+    printf("Image: %zu octets, texte: %zu octets dont %zu en pages de 2 Mo (%s)\n",
+           stats->image_size, stats->text_size, stats->text_huge_size,
+           page_kinds[stats->text_pages]);
+    printf("Résidence: %zu octets préchargés, %zu verrouillés\n", stats->populated_size,
+           stats->locked_size);
+    if (stats->verified_size) {
+        printf("Intégrité: %zu octets vérifiés (CRC32C %s)\n", stats->verified_size,
+               crc32c_kind());
+    }
+}
+
+// Profil des imports (--stats) : ceux qui ont été appelés, dans l'ordre des imports
+static void print_call_stats(void *handle) {
+    int count = my_dlstats(handle, NULL, 0);
+    import_stats_t *stats = count > 0 ? calloc(count, sizeof(import_stats_t)) : NULL;
+    if (!stats) {
+        debug_warn("Profil des appels indisponible");
+        return;
+    }
+    my_dlstats(handle, stats, count);
+    printf("== Appels des imports ==\n");
+    for (int i = 0; i < count; i++) {
+        if (stats[i].calls == 0) {
+            continue;
+        }
+        printf("%-24s %10lu appels", stats[i].name, stats[i].calls);
+        if (stats[i].samples > 0) {
+            printf("  moy %8.1f ns  min %lu  max %lu ns (%lu mesures)",
+                   (double) stats[i].total_ns / stats[i].samples, stats[i].min_ns,
+                   stats[i].max_ns, stats[i].samples);
+        }
+        printf("\n");
+    }
+    free(stats);
+}
+
+// Charge les bibliothèques de --global, après LIBRARY_PATH ; -1 en cas d'échec
+static int load_global_libraries(const char *list, void ***handles) {
+    char *paths = strdup(list);
+    int capacity = 1;
+    for (const char *p = list; *p; p++) {
+        capacity += *p == ',';
+    }
+    *handles = calloc(capacity, sizeof(void *));
+    if (!paths || !*handles) {
+        perror("malloc failed");
+        free(paths);
+        free(*handles);
+        return -1;
+    }
+    int count = 0;
+    char *save = NULL;
+    for (char *path = strtok_r(paths, ",", &save); path; path = strtok_r(NULL, ",", &save)) {
+        void *lib = my_dlopen(path);
+        if (!lib || my_set_plt_resolve(lib, imported_functions) != 0) {
+            debug_error("Échec du chargement");
+            for (int i = 0; i < count; i++) {
+                my_dlclose((*handles)[i]);
+            }
+            free(*handles);
+            free(paths);
+            return -1;
+        }
+        (*handles)[count++] = lib;
+    }
+    free(paths);
+    return count;
+}
+
+// Résout chaque fonction dans la première bibliothèque qui l'exporte
+static void bind_global(struct arguments *args, void **func_addrs) {
+    for (int i = 0; i < args->func_count; i++) {
+        void *owner = NULL;
+        func_addrs[i] = my_dlsym_global(args->func_names[i], &owner);
+        if (args->verbose && owner) {
+            printf("%s: fourni par le handle %p\n", args->func_names[i], owner);
+        }
+    }
+}
+
+/*
+ * Touche les pages de pile que les appels vont occuper (zone XSAVE des
+ * trampolines, plusieurs Ko avec AVX-512) : seuls les défauts de page
+ * de l'image sont comptés.
+ */
+static __attribute__((noinline)) void prefault_stack(void) {
+    volatile char pad[PREFAULT_STACK_SIZE];
+    for (size_t off = 0; off < sizeof(pad); off += 4096) {
+        pad[off] = 0;
+    }
+}
+
+/*
+ * Exécute une fois le côté hôte des imports : new_args() écrit son
+ * tampon statique (.bss de l'hôte) et son snprintf("%f") entre dans le
+ * code flottant de la libc, pas encore projeté ou selon l'emplacement
+ * de la libc (fault-around). Ces défauts ne sont pas ceux de l'image.
+ */
+static void warm_host_imports(void) {
+    new_foo();
+    new_bar();
+    new_args(1, 2, 3, 4, 5, 6, 7.5);
+}
+
+// Défauts de page pris par le premier appel de chaque fonction liée
+static void report_first_call_faults(struct arguments *args, void **func_addrs) {
+    struct rusage before, after;
+    int calls = 0;
+    prefault_stack();
+    warm_host_imports();
+    getrusage(RUSAGE_SELF, &before);
+    for (int i = 0; i < args->func_count; i++) {
+        if (func_addrs[i]) {
+            ((str_fn) func_addrs[i])();
+            calls++;
+        }
+    }
+    getrusage(RUSAGE_SELF, &after);
+    printf("Défauts de page pendant les %d premiers appels: %ld mineurs, %ld majeurs\n", calls,
+           after.ru_minflt - before.ru_minflt, after.ru_majflt - before.ru_majflt);
+}
+
+// Appelle chaque fonction liée et affiche son résultat
+static void call_functions(struct arguments *args, void **func_addrs) {
+    for (int i = 0; i < args->func_count; i++) {
+        if (args->verbose) {
+            debug_info("Recherche de fonction");
+        }
+        printf("Recherche de la fonction %s\n", args->func_names[i]);
+        void *func_addr = func_addrs[i];
+        if (func_addr) {
+            debug_info("Adresse de fonction trouvée");
+
+            // Afficher l'adresse
+            printf("%s() => Adresse: 0x%lx\n", args->func_names[i], (unsigned long) func_addr);
+
+            // Appel de la fonction
+            str_fn func_ptr = (str_fn) func_addr;
+            const char *result = func_ptr();
+
+            // Afficher le résultat
+            printf("Résultat de l'appel: %s\n", result);
+        } else {
+            debug_warn("Function not found in the library");
+        }
+    }
+}
+
+/*
+ * Mode espaces de noms : une instance privée de la bibliothèque par
+ * espace (my_dlmopen), puis les mêmes appels dans chacune. Les données
+ * modifiées par une instance ne sont pas vues des autres.
+ */
+static int run_namespaces(struct arguments *args) {
+    int count = args->namespaces;
+    void **spaces = calloc(count, sizeof(void *));
+    void **handles = calloc(count, sizeof(void *));
+    void **func_addrs = calloc(args->func_count, sizeof(void *));
+    if (!spaces || !handles || !func_addrs) {
+        perror("calloc failed");
+        free(spaces);
+        free(handles);
+        free(func_addrs);
+        return 1;
+    }
+
+    int status = 0;
+    int loaded = 0;
+    for (; loaded < count; loaded++) {
+        spaces[loaded] = my_dlns_create();
+        handles[loaded] = spaces[loaded] ? my_dlmopen(spaces[loaded], args->lib_path) : NULL;
+        if (!handles[loaded] || my_set_plt_resolve(handles[loaded], imported_functions) != 0) {
+            debug_error("Échec du chargement");
+            status = 1;
+            break;
+        }
+    }
+
+    for (int k = 0; status == 0 && k < count; k++) {
+        printf("== Espace %d ==\n", k);
+        if (my_dlbind(handles[k], (const char *const *) args->func_names, func_addrs,
+                      args->func_count) < 0) {
+            debug_error("Échec de la liaison des fonctions");
+            status = 1;
+            break;
+        }
+        call_functions(args, func_addrs);
+    }
+
+    for (int k = 0; status == 0 && args->meminfo && k < count; k++) {
+        char label[32];
+        snprintf(label, sizeof(label), "espace %d", k);
+        print_meminfo(label, handles[k]);
+    }
+
+    // Fermer un espace ferme aussi les instances qu'il contient
+    for (int k = 0; k < count; k++) {
+        if (spaces[k]) {
+            my_dlns_destroy(spaces[k]);
+        }
+    }
+    free(func_addrs);
+    free(handles);
+    free(spaces);
+    return status;
 }
 
 // Fonction principale
@@ -100,32 +803,133 @@ int main(int argc, char **argv) {
     // Initialisation des arguments
     args.verbose = 0;
     args.func_count = 0;
+    args.func_capacity = 0;
     args.lib_path = NULL;
     args.func_names = NULL;
     args.debug_level = DBG_ERROR;
+    args.func_file = NULL;
+    args.repeat = 0;
+    args.duration = 0;
+    args.batch = DEFAULT_BATCH;
+    args.index = 0;
+    args.from_memory = 0;
+    args.serve_socket = NULL;
+    args.connect_socket = NULL;
+    args.reload_path = NULL;
+    args.global_libs = NULL;
+    args.packed = 0;
+    args.load_flags = 0;
+    args.faults = 0;
+    args.record_profile = 0;
+    args.meminfo = 0;
+    args.namespaces = 0;
+    args.async = 0;
+    args.compress_path = NULL;
+    args.checksum = 0;
+    args.stats_period = -1;
 
     // Parsing des arguments
     argp_parse(&argp, argc, argv, 0, 0, &args);
 
-    // Initialisation du debug
+    // Initialisation du debug : traces de la CLI et du loader
     debug_init(args.debug_level);
+    my_dldebug_init(args.debug_level);
+    if (args.stats_period >= 0) {
+        my_dlstats_sample((unsigned) args.stats_period);
+    }
 
     if (args.verbose) {
         debug_info("Debug activé");
         debug_info("Chargement de bibliothèque");
     }
 
-    // Chargement de la bibliothèque
-    void *handle = my_dlopen(args.lib_path);
+    // Modes zygote : client (aucun chargement local) et serveur
+    if (args.connect_socket || args.serve_socket) {
+        int status = args.connect_socket ? run_client(&args) : run_server(&args);
+        for (int i = 0; i < args.func_count; i++) {
+            free(args.func_names[i]);
+        }
+        free(args.func_names);
+        return status;
+    }
+
+    // Mode somme de contrôle : ajoute la note CRC32C puis s'arrête
+    if (args.checksum) {
+        int segments = my_dlintegrity_write(args.lib_path);
+        if (segments < 0) {
+            debug_error("Échec de l'écriture de la note d'intégrité");
+            return 1;
+        }
+        printf("%s: CRC32C de %d segments dans %s (%s)\n", args.lib_path, segments,
+               INTEGRITY_SECTION, crc32c_kind());
+        return 0;
+    }
+
+    // Mode conteneur : écrit l'image compressée puis s'arrête
+    if (args.compress_path) {
+        int blocks = isosz_write(args.lib_path, args.compress_path);
+        struct stat in_st, out_st;
+        if (blocks < 0 || stat(args.lib_path, &in_st) != 0 ||
+            stat(args.compress_path, &out_st) != 0) {
+            debug_error("Échec de l'écriture du conteneur");
+            return 1;
+        }
+        printf("%s: %d blocs, %lld -> %lld octets\n", args.compress_path, blocks,
+               (long long) in_st.st_size, (long long) out_st.st_size);
+        return 0;
+    }
+
+    if (args.namespaces > 0) {
+        int status = run_namespaces(&args);
+        for (int i = 0; i < args.func_count; i++) {
+            free(args.func_names[i]);
+        }
+        free(args.func_names);
+        return status;
+    }
+
+    // Chargement de la bibliothèque, depuis le disque ou depuis un tampon
+    void *handle = NULL;
+    void *pack = NULL;
+    if (args.from_memory) {
+        size_t len = 0;
+        void *image = read_all(args.lib_path, &len);
+        if (image) {
+            handle = my_dlopen_mem(image, len);
+            free(image);
+        }
+    } else if (args.packed) {
+        pack = my_dlpack_create(0);
+        handle = pack ? my_dlopen_packed(pack, args.lib_path) : NULL;
+    } else if (args.async) {
+        void *req = my_dlopen_async(args.lib_path, args.load_flags);
+        handle = req ? my_dlasync_wait(req) : NULL;
+    } else {
+        handle = my_dlopen_flags(args.lib_path, args.load_flags);
+    }
     if (!handle) {
         debug_error("Échec du chargement");
         return 1;
     }
+    if (args.load_flags & ~LOAD_CALLSTATS) {
+        print_load_stats(my_dlloadstats(handle));
+    }
     // Configuration de la résolution PLT
     if (my_set_plt_resolve(handle, imported_functions) != 0) {
         debug_error("Échec configuration PLT resolver");
         return 1;
     }
+    // Mode index : écrit le fichier .isosidx puis s'arrête
+    if (args.index) {
+        int count = isosidx_write(args.lib_path, handle);
+        if (count < 0) {
+            debug_error("Échec de l'écriture de l'index");
+            return 1;
+        }
+        printf("%s%s: %d symboles indexés\n", args.lib_path, ISOSIDX_SUFFIX, count);
+        return 0;
+    }
+
     // Initialisation de la bibliothèque
     /*if (init_library(handle, imported_functions) != 0) {
         debug_warn("Échec initialisation bibliothèque");
@@ -133,45 +937,85 @@ int main(int argc, char **argv) {
         exit(1);
     }*/
 
-    // Exécution des fonctions demandées
-    for (int i = 0; i < args.func_count; i++) {
-        if (args.verbose) {
-            debug_info("Recherche de fonction");
+    // Résolution de toutes les fonctions demandées en un seul appel
+    void **func_addrs = calloc(args.func_count, sizeof(void *));
+    if (!func_addrs) {
+        perror("calloc failed");
+        return 1;
+    }
+    void **extra_handles = NULL;
+    int extra_count = 0;
+    if (args.global_libs) {
+        extra_count = load_global_libraries(args.global_libs, &extra_handles);
+        if (extra_count < 0) {
+            return 1;
         }
-        printf("Recherche de la fonction %s\n", args.func_names[i]);
-        // Recherche de l'adresse de la fonction
-        void *func_addr = my_dlsym(handle, args.func_names[i]);
-        if (func_addr) {
-            debug_info("Adresse de fonction trouvée");
+        bind_global(&args, func_addrs);
+    } else if (my_dlbind(handle, (const char *const *) args.func_names, func_addrs,
+                         args.func_count) < 0) {
+        debug_error("Échec de la liaison des fonctions");
+        return 1;
+    }
 
-            // Afficher l'adresse
-            write_stdout(args.func_names[i]);
-            write_stdout("() => Adresse: 0x");
+    if (args.faults) {
+        report_first_call_faults(&args, func_addrs);
+    }
 
-            // Convertir l'adresse en hex
-            char addr_str[20];
-            //snprintf(addr_str, sizeof(addr_str), "%lx", (unsigned long) func_addr);
-            printf("0x%lx", (unsigned long) func_addr);
-            write_stdout(addr_str);
-            write_stdout("\n");
+    // Mode débit : boucle d'appels et histogrammes de latence
+    if (args.repeat > 0 || args.duration > 0) {
+        run_throughput(&args, handle, func_addrs);
+    }
 
-            // Appel de la fonction
-            const char * (*func_ptr)() = (const char* (*)()) func_addr;
-            const char *result = func_ptr();
+    // Exécution des fonctions demandées
+    if (args.repeat == 0 && args.duration == 0) {
+        call_functions(&args, func_addrs);
+    }
 
-            // Afficher le résultat
-            write_stdout("Résultat de l'appel: ");
-            write_stdout(result);
-            write_stdout("\n");
-        } else {
-            debug_warn("Function not found in the library");
+    if (args.load_flags & LOAD_CALLSTATS) {
+        print_call_stats(handle);
+    }
+
+    // Les appels ci-dessus servent d'échauffement : on garde les pages touchées
+    if (args.record_profile) {
+        int pages = isosprof_write(args.lib_path, handle);
+        if (pages < 0) {
+            debug_error("Échec de l'écriture du profil");
+            return 1;
         }
+        printf("%s%s: %d pages enregistrées\n", args.lib_path, ISOSPROF_SUFFIX, pages);
+    }
+
+    if (args.meminfo) {
+        print_meminfo(args.lib_path, handle);
+    }
+
+    // Rechargement à chaud, puis les mêmes appels sur la nouvelle version
+    if (args.reload_path && args.repeat == 0 && args.duration == 0) {
+        if (my_dlreload(handle, args.reload_path) == 0) {
+            printf("Bibliothèque rechargée depuis %s\n", args.reload_path);
+        }
+        if (my_dlbind(handle, (const char *const *) args.func_names, func_addrs,
+                      args.func_count) < 0) {
+            debug_error("Échec de la liaison des fonctions");
+            return 1;
+        }
+        call_functions(&args, func_addrs);
     }
 
     // Nettoyage
-    if (args.func_names) {
-        free(args.func_names);
+    for (int i = 0; i < extra_count; i++) {
+        my_dlclose(extra_handles[i]);
+    }
+    free(extra_handles);
+    my_dlclose(handle);
+    if (pack) {
+        my_dlpack_destroy(pack);
+    }
+    free(func_addrs);
+    for (int i = 0; i < args.func_count; i++) {
+        free(args.func_names[i]);
     }
+    free(args.func_names);
 
     debug_info("Fin du programme");
 
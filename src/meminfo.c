@@ -0,0 +1,176 @@
+#include "meminfo.h"
+#include "debug.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/**
+ * @brief Calcule les plages projetées pour les segments PT_LOAD d'une
+ *        image chargée à base_addr. ranges peut être NULL pour n'obtenir
+ *        que leur nombre.
+ *
+ * @return le nombre de plages.
+ */
+int meminfo_ranges(void *base_addr, const elf_phdr *phdrs, int phnum, size_t page_size,
+                   mapped_range_t *ranges) {
+    int count = 0;
+    for (int i = 0; i < phnum; i++) {
+        if (phdrs[i].p_type != PT_LOAD) {
+            continue;
+        }
+        if (ranges) {
+            uint64_t start = phdrs[i].p_vaddr & ~(page_size - 1);
+            uint64_t end = (phdrs[i].p_vaddr + phdrs[i].p_memsz + page_size - 1) &
+                           ~(page_size - 1);
+            ranges[count].start = (char *) base_addr + start;
+            ranges[count].size = end - start;
+            ranges[count].segment = i;
+            ranges[count].flags = phdrs[i].p_flags;
+        }
+        count++;
+    }
+    return count;
+}
+
+// Octets de pages présentes sur la plage (mincore)
+static size_t resident_bytes(void *addr, size_t size, size_t page_size) {
+    size_t pages = size / page_size;
+    unsigned char *vec = malloc(pages);
+    size_t resident = 0;
+    if (vec && mincore(addr, size, vec) == 0) {
+        for (size_t i = 0; i < pages; i++) {
+            resident += (vec[i] & 1) * page_size;
+        }
+    }
+    free(vec);
+    return resident;
+}
+
+// Part de value revenant à overlap octets d'une zone de size octets
+static size_t share(size_t value, size_t overlap, size_t size) {
+    return overlap == size ? value : (size_t) ((double) value * overlap / size);
+}
+
+static void add_counts(segment_meminfo_t *to, const segment_meminfo_t *from) {
+    to->size += from->size;
+    to->resident += from->resident;
+    to->rss += from->rss;
+    to->pss += from->pss;
+    to->shared += from->shared;
+    to->private_dirty += from->private_dirty;
+    to->swap += from->swap;
+}
+
+/*
+ * Compteurs smaps d'une zone mémoire (VMA), ajoutés aux plages qu'elle
+ * recouvre au prorata du recouvrement (une zone peut réunir deux
+ * segments voisins de mêmes droits, un segment s'étendre sur plusieurs).
+ */
+static void attribute_vma(uintptr_t start, uintptr_t end, const segment_meminfo_t *vma,
+                          const mapped_range_t *ranges, int count, segment_meminfo_t *out) {
+    for (int i = 0; i < count; i++) {
+        uintptr_t lo = (uintptr_t) ranges[i].start;
+        uintptr_t hi = lo + ranges[i].size;
+        lo = lo > start ? lo : start;
+        hi = hi < end ? hi : end;
+        if (lo >= hi) {
+            continue;
+        }
+        size_t overlap = hi - lo;
+        size_t size = end - start;
+        out[i].rss += share(vma->rss, overlap, size);
+        out[i].pss += share(vma->pss, overlap, size);
+        out[i].shared += share(vma->shared, overlap, size);
+        out[i].private_dirty += share(vma->private_dirty, overlap, size);
+        out[i].swap += share(vma->swap, overlap, size);
+    }
+}
+
+/**
+ * @brief Bilan mémoire des plages d'une image : mincore() pour les pages
+ *        présentes, puis une seule lecture de /proc/self/smaps pour RSS,
+ *        PSS, pages partagées, privées modifiées et swap.
+ *
+ * @return 0 en cas de succès, -1 si smaps est illisible (seul resident
+ *         est alors rempli).
+ */
+int meminfo_collect(const mapped_range_t *ranges, int count, lib_meminfo_t *info) {
+    memset(info, 0, sizeof(*info));
+    size_t page_size = getpagesize();
+
+    segment_meminfo_t *segs = calloc(count ? count : 1, sizeof(segment_meminfo_t));
+    if (!segs) {
+        perror("calloc failed");
+        return -1;
+    }
+    uintptr_t lo = UINTPTR_MAX;
+    uintptr_t hi = 0;
+    for (int i = 0; i < count; i++) {
+        segs[i].start = ranges[i].start;
+        segs[i].size = ranges[i].size;
+        segs[i].segment = ranges[i].segment;
+        segs[i].flags = ranges[i].flags;
+        segs[i].resident = resident_bytes(ranges[i].start, ranges[i].size, page_size);
+        uintptr_t start = (uintptr_t) ranges[i].start;
+        lo = start < lo ? start : lo;
+        hi = start + ranges[i].size > hi ? start + ranges[i].size : hi;
+    }
+
+    int ret = 0;
+    FILE *smaps = fopen("/proc/self/smaps", "r");
+    if (!smaps) {
+        debug_warn("Impossible de lire /proc/self/smaps");
+        ret = -1;
+    } else {
+        // Zone en cours : ses compteurs sont attribués à la ligne d'en-tête suivante
+        uintptr_t start = 0, end = 0;
+        int inside = 0;
+        segment_meminfo_t vma;
+        memset(&vma, 0, sizeof(vma));
+        char line[256];
+        size_t kb;
+        for (;;) {
+            int more = fgets(line, sizeof(line), smaps) != NULL;
+            uintptr_t next_start, next_end;
+            int header = more && sscanf(line, "%lx-%lx ", &next_start, &next_end) == 2;
+            if (!more || header) {
+                if (inside) {
+                    attribute_vma(start, end, &vma, ranges, count, segs);
+                }
+                if (!more || next_start >= hi) {
+                    break;
+                }
+                start = next_start;
+                end = next_end;
+                inside = start < hi && end > lo;
+                memset(&vma, 0, sizeof(vma));
+            } else if (!inside) {
+                continue;
+            } else if (sscanf(line, "Rss: %zu kB", &kb) == 1) {
+                vma.rss = kb << 10;
+            } else if (sscanf(line, "Pss: %zu kB", &kb) == 1) {
+                vma.pss = kb << 10;
+            } else if (sscanf(line, "Shared_Clean: %zu kB", &kb) == 1 ||
+                       sscanf(line, "Shared_Dirty: %zu kB", &kb) == 1) {
+                vma.shared += kb << 10;
+            } else if (sscanf(line, "Private_Dirty: %zu kB", &kb) == 1) {
+                vma.private_dirty = kb << 10;
+            } else if (sscanf(line, "Swap: %zu kB", &kb) == 1) {
+                vma.swap = kb << 10;
+            }
+        }
+        fclose(smaps);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (i < MEMINFO_MAX_SEGMENTS) {
+            info->segments[info->count++] = segs[i];
+        }
+        add_counts(&info->total, &segs[i]);
+    }
+    free(segs);
+    return ret;
+}
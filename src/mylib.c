@@ -2,6 +2,7 @@
 #include "mylib.h"
 #include "isos-support.h"
 #include "loader.h"
+#include "cpu_features.h"
 
 // Définir les variables globales pour le handle et le trampoline
 void *loader_handle = NULL;
@@ -12,13 +13,20 @@ const char *new_foo();
 
 const char *new_bar();
 
+const char *new_args(long a, long b, long c, long d, long e, long f, double x);
+
+// Suffixe distinguant les versions construites pour le rechargement à chaud
+#ifndef MYLIB_VERSION
+#define MYLIB_VERSION ""
+#endif
+
 // Implémentation des fonctions exportées
 const char *foo_exported() {
-    return "Hello from foo_exported()";
+    return "Hello from foo_exported()" MYLIB_VERSION;
 }
 
 const char *bar_exported() {
-    return "Hello from bar_exported()";
+    return "Hello from bar_exported()" MYLIB_VERSION;
 }
 
 // Implémentation des fonctions qui importent
@@ -30,10 +38,52 @@ const char *bar_imported() {
     return new_bar();
 }
 
+// Import avec arguments : vérifie que le trampoline les préserve
+const char *args_imported() {
+    return new_args(1, 2, 3, 4, 5, 6, 7.5);
+}
+
+// Variantes d'un noyau choisies au chargement (IFUNC)
+static const char *kernel_scalar() {
+    return "Hello from kernel_dispatch() [scalar]";
+}
+
+static const char *kernel_avx2() {
+    return "Hello from kernel_dispatch() [avx2]";
+}
+
+static const char *kernel_avx512() {
+    return "Hello from kernel_dispatch() [avx512]";
+}
+
+typedef const char *(*kernel_fn)();
+
+// Résolveur appelé une seule fois par le loader avec les capacités du CPU
+static kernel_fn resolve_kernel(const isos_cpu_features_t *features) {
+    if (!features || features->size < sizeof(isos_cpu_features_t)) {
+        return kernel_scalar;
+    }
+    if (features->flags & ISOS_CPU_AVX512F) {
+        return kernel_avx512;
+    }
+    if (features->flags & ISOS_CPU_AVX2) {
+        return kernel_avx2;
+    }
+    return kernel_scalar;
+}
+
+const char *kernel_dispatch() __attribute__((ifunc("resolve_kernel")));
+
+// Appel local d'une IFUNC (passe par une relocation IRELATIVE de la PLT)
+const char *kernel_caller() {
+    return kernel_dispatch();
+}
+
 // Table des symboles importés
 const char *imported_symbols[] = {
     "new_foo", // ID 0
     "new_bar", // ID 1
+    "new_args", // ID 2
     NULL
 };
 
@@ -43,6 +93,9 @@ symbol_entry exported_symbols[] = {
     {"bar_exported", (void *) bar_exported},
     {"foo_imported", (void *) foo_imported},
     {"bar_imported", (void *) bar_imported},
+    {"args_imported", (void *) args_imported},
+    {"kernel_dispatch", (void *) kernel_dispatch},
+    {"kernel_caller", (void *) kernel_caller},
     {NULL, NULL} // Fin de la table
 };
 
@@ -58,6 +111,7 @@ loader_info_t loader_info = {
 PLT_BEGIN
 PLT_ENTRY(0, new_foo)
 PLT_ENTRY(1, new_bar)
+PLT_ENTRY(2, new_args)
 
 // Fonction get_symbol_table pour l'entry point
 symbol_entry *get_symbol_table() {
@@ -0,0 +1,163 @@
+#include "namespace.h"
+#include "symbol_index.h"
+#include "debug.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tables partagées vivantes, une par fichier
+static shared_exports_t *shared_head;
+static pthread_mutex_t shared_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Export et sa position dans la table d'origine, le temps du tri
+typedef struct {
+    symbol_entry entry;
+    int index;
+} ranked_export;
+
+static int compare_export(const void *a, const void *b) {
+    const ranked_export *ea = a;
+    const ranked_export *eb = b;
+    int cmp = strcmp(ea->entry.name, eb->entry.name);
+    if (cmp != 0) {
+        return cmp;
+    }
+    // À nom égal, le premier de la table gagne, comme dans my_dlsym() ;
+    // qsort déplace les éléments : seule la position d'origine départage
+    return ea->index < eb->index ? -1 : (ea->index > eb->index);
+}
+
+/**
+ * @brief Copie triée par nom d'une table d'export (terminée par NULL),
+ *        allouée dans arena.
+ *
+ * @param count : reçoit le nombre d'exports.
+ * @return la table triée, ou NULL en cas d'erreur d'allocation.
+ */
+symbol_entry *exports_sort(arena_t *arena, const symbol_entry *exports, int *count) {
+    int n = 0;
+    while (exports[n].name != NULL) {
+        n++;
+    }
+
+    ranked_export *ranked = malloc((n + 1) * sizeof(ranked_export));
+    symbol_entry *sorted = arena_alloc(arena, (n + 1) * sizeof(symbol_entry));
+    if (!ranked || !sorted) {
+        perror("allocation failed");
+        free(ranked);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        ranked[i].entry = exports[i];
+        ranked[i].index = i;
+    }
+    qsort(ranked, n, sizeof(ranked_export), compare_export);
+    for (int i = 0; i < n; i++) {
+        sorted[i] = ranked[i].entry;
+    }
+    sorted[n] = exports[n];
+    free(ranked);
+
+    *count = n;
+    return sorted;
+}
+
+// Exports de .dynsym lus dans le fichier (pas dans une image chargée)
+static shared_exports_t *shared_exports_build(const elf_file *elf) {
+    arena_t *arena = arena_create(ARENA_DEFAULT_RESERVE);
+    shared_exports_t *shared = arena_alloc(arena, sizeof(shared_exports_t));
+    symbol_entry *exports =
+            arena_calloc(arena, elf->dynsym_count + 1, sizeof(symbol_entry));
+    if (!shared || !exports) {
+        perror("Failed to allocate shared export table");
+        arena_destroy(arena);
+        return NULL;
+    }
+    shared->arena = arena;
+    shared->exports = exports;
+    elf_identity_fill(elf, &shared->identity);
+
+    int count = 0;
+    for (size_t i = 1; i < elf->dynsym_count; i++) {
+        const Elf64_Sym *sym = &elf->dynsym[i];
+        const char *name = elf_string(elf->dynstr, elf->dynstr_size, sym->st_name);
+        if (!name || !elf_sym_exported(sym)) {
+            continue;
+        }
+        exports[count].name = arena_memdup(arena, name, strlen(name) + 1);
+        exports[count].addr = (void *) (uintptr_t) sym->st_value;
+        if (!exports[count].name) {
+            perror("Failed to copy export name");
+            arena_destroy(arena);
+            return NULL;
+        }
+        count++;
+    }
+
+    if (bloom_init(&shared->bloom, arena, count) != 0) {
+        debug_warn("Filtre des exports indisponible");
+    }
+    for (int i = 0; i < count; i++) {
+        bloom_add(&shared->bloom, isosidx_hash(exports[i].name));
+    }
+    // Index trié de my_dlbind(), lui aussi commun à toutes les instances
+    shared->sorted = exports_sort(arena, exports, &shared->count);
+    if (!shared->sorted) {
+        arena_destroy(arena);
+        return NULL;
+    }
+    return shared;
+}
+
+/**
+ * @brief Table d'export partagée du fichier elf, construite au premier
+ *        appel puis réutilisée tant qu'une instance la référence.
+ *
+ * @return la table (référence à rendre par shared_exports_put()), ou NULL
+ *         si le fichier n'a pas de .dynsym ou en cas d'erreur.
+ */
+shared_exports_t *shared_exports_get(const elf_file *elf) {
+    if (!elf->dynsym || elf->dynsym_count == 0) {
+        return NULL;
+    }
+    elf_identity identity;
+    elf_identity_fill(elf, &identity);
+
+    pthread_mutex_lock(&shared_lock);
+    shared_exports_t *shared = shared_head;
+    while (shared && !elf_identity_match(&shared->identity, &identity)) {
+        shared = shared->next;
+    }
+    if (shared) {
+        debug_info("Table d'export partagée réutilisée");
+    } else if ((shared = shared_exports_build(elf)) != NULL) {
+        shared->next = shared_head;
+        shared_head = shared;
+    }
+    if (shared) {
+        shared->refs++;
+    }
+    pthread_mutex_unlock(&shared_lock);
+    return shared;
+}
+
+// Rend une référence ; la table est libérée avec sa dernière instance
+void shared_exports_put(shared_exports_t *shared) {
+    if (!shared) {
+        return;
+    }
+    pthread_mutex_lock(&shared_lock);
+    if (--shared->refs > 0) {
+        pthread_mutex_unlock(&shared_lock);
+        return;
+    }
+    shared_exports_t **link = &shared_head;
+    while (*link && *link != shared) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        *link = shared->next;
+    }
+    pthread_mutex_unlock(&shared_lock);
+    arena_destroy(shared->arena);
+}
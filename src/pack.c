@@ -0,0 +1,83 @@
+#include "pack.h"
+#include "debug.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief Crée un pack : réservation PROT_NONE (rien n'est engagé tant
+ *        qu'aucune image n'y est chargée) et arène de métadonnées.
+ *
+ * @param reserve : taille réservée pour les images (arrondie à la page).
+ * @return le pack, ou NULL en cas d'échec.
+ */
+lib_pack_t *pack_create(size_t reserve) {
+    size_t page_size = getpagesize();
+    size_t size = (reserve + page_size - 1) & ~(page_size - 1);
+
+    arena_t *arena = arena_create(ARENA_DEFAULT_RESERVE);
+    lib_pack_t *pack = arena_alloc(arena, sizeof(lib_pack_t));
+    if (!pack) {
+        arena_destroy(arena);
+        return NULL;
+    }
+
+    void *base = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        perror("pack reservation failed");
+        arena_destroy(arena);
+        return NULL;
+    }
+
+    pack->base = base;
+    pack->size = size;
+    pack->arena = arena;
+    return pack;
+}
+
+/**
+ * @brief Prend la plage suivante du pack pour une image de size octets.
+ *
+ * @return le début de la plage (PROT_NONE), ou NULL si le pack est plein.
+ */
+void *pack_reserve(lib_pack_t *pack, size_t size) {
+    size_t page_size = getpagesize();
+    size = (size + page_size - 1) & ~(page_size - 1);
+    if (size > pack->size - pack->used) {
+        debug_warn("Pack plein");
+        return NULL;
+    }
+
+    void *addr = pack->base + pack->used;
+    pack->used += size;
+    pack->count++;
+    return addr;
+}
+
+/**
+ * @brief Rend les pages d'une image du pack. La plage redevient PROT_NONE
+ *        et n'est pas réutilisée : les autres images restent en place.
+ */
+void pack_release(lib_pack_t *pack, void *base_addr, const elf_phdr *phdrs, int phnum) {
+    uint64_t base_offset;
+    size_t total_size;
+    if (!base_addr || load_extent(phdrs, phnum, getpagesize(), &base_offset, &total_size) != 0) {
+        return;
+    }
+    mmap((char *) base_addr + base_offset, total_size, PROT_NONE,
+         MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    pack->count--;
+}
+
+/**
+ * @brief Démonte la réservation et l'arène : toutes les images et tous
+ *        les handles du pack deviennent invalides.
+ */
+void pack_destroy(lib_pack_t *pack) {
+    if (!pack) {
+        return;
+    }
+    munmap(pack->base, pack->size);
+    arena_destroy(pack->arena);
+}
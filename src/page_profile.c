@@ -0,0 +1,291 @@
+#include "page_profile.h"
+#include "dynloader.h"
+#include "debug.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Bit "page présente" d'une entrée de /proc/self/pagemap
+#define PAGEMAP_PRESENT (1ull << 63)
+#define PAGEMAP_SWAPPED (1ull << 62)
+
+/**
+ * @brief Marque dans present[] les pages de [addr, addr + pages) qui sont
+ *        projetées dans ce processus. /proc/self/pagemap donne l'état
+ *        propre au processus ; à défaut mincore() indique les pages en
+ *        cache, ce qui surestime le profil sans le fausser.
+ *
+ * @return 0 en cas de succès, -1 si aucune des deux sources ne répond.
+ */
+static int scan_present(int pagemap_fd, void *addr, size_t pages, size_t page_size,
+                        unsigned char *present) {
+    if (pagemap_fd >= 0) {
+        uint64_t *entries = malloc(pages * sizeof(uint64_t));
+        off_t offset = (off_t) ((uintptr_t) addr / page_size) * sizeof(uint64_t);
+        ssize_t size = pages * sizeof(uint64_t);
+        if (entries && pread(pagemap_fd, entries, size, offset) == size) {
+            for (size_t i = 0; i < pages; i++) {
+                present[i] = (entries[i] & (PAGEMAP_PRESENT | PAGEMAP_SWAPPED)) != 0;
+            }
+            free(entries);
+            return 0;
+        }
+        free(entries);
+    }
+    if (mincore(addr, pages * page_size, present) != 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < pages; i++) {
+        present[i] &= 1;
+    }
+    return 0;
+}
+
+// Étendue (alignée sur la page) d'un segment chargé
+static void segment_pages(const lib_handle_t *lib, int i, size_t page_size, void **addr,
+                          size_t *pages) {
+    const elf_phdr *ph = &lib->phdrs[i];
+    uint64_t start = ph->p_vaddr & ~(page_size - 1);
+    uint64_t end = (ph->p_vaddr + ph->p_memsz + page_size - 1) & ~(page_size - 1);
+    *addr = (char *) lib->base_addr + start;
+    *pages = (end - start) / page_size;
+}
+
+static int sidecar_path(const char *library_path, char *path, size_t size) {
+    int n = snprintf(path, size, "%s" ISOSPROF_SUFFIX, library_path);
+    return (n < 0 || (size_t) n >= size) ? -1 : 0;
+}
+
+/**
+ * @brief Écrit <library_path>.isosprof d'après les pages de la
+ *        bibliothèque présentes à cet instant. À appeler à la fin de
+ *        l'échauffement, sur une image chargée sans LOAD_POPULATE ni
+ *        LOAD_LOCK (toutes ses pages seraient alors présentes).
+ *
+ * @return le nombre de pages enregistrées, -1 en cas d'erreur.
+ */
+int isosprof_write(const char *library_path, void *handle) {
+    lib_handle_t *lib = (lib_handle_t *) handle;
+    if (!lib || !lib->base_addr) {
+        debug_error("Handle invalide");
+        return -1;
+    }
+    if (lib->current) {
+        lib = lib->current;
+    }
+
+    elf_file elf;
+    if (elf_open(library_path, &elf) != 0) {
+        return -1;
+    }
+    isosprof_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, ISOSPROF_MAGIC, sizeof(hdr.magic));
+    hdr.version = ISOSPROF_VERSION;
+    hdr.page_size = getpagesize();
+    elf_identity_fill(&elf, &hdr.identity);
+    elf_close(&elf);
+
+    size_t page_size = hdr.page_size;
+    size_t run_capacity = 64;
+    isosprof_run *runs = malloc(run_capacity * sizeof(isosprof_run));
+    int pagemap_fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    int total = 0;
+
+    for (int i = 0; i < lib->phnum && runs; i++) {
+        if (lib->phdrs[i].p_type != PT_LOAD) {
+            continue;
+        }
+        void *addr;
+        size_t pages;
+        segment_pages(lib, i, page_size, &addr, &pages);
+        unsigned char *present = malloc(pages);
+        if (!present || scan_present(pagemap_fd, addr, pages, page_size, present) != 0) {
+            debug_warn("Impossible de lire les pages présentes");
+            free(present);
+            continue;
+        }
+
+        // Suites de pages présentes consécutives
+        for (size_t p = 0; p < pages; p++) {
+            if (!present[p]) {
+                continue;
+            }
+            size_t first = p;
+            while (p + 1 < pages && present[p + 1]) {
+                p++;
+            }
+            if (hdr.run_count == run_capacity) {
+                run_capacity *= 2;
+                isosprof_run *grown = realloc(runs, run_capacity * sizeof(isosprof_run));
+                if (!grown) {
+                    free(runs);
+                    runs = NULL;
+                    break;
+                }
+                runs = grown;
+            }
+            runs[hdr.run_count].segment = i;
+            runs[hdr.run_count].first_page = first;
+            runs[hdr.run_count].page_count = p - first + 1;
+            hdr.run_count++;
+            total += p - first + 1;
+        }
+        free(present);
+    }
+    if (pagemap_fd >= 0) {
+        close(pagemap_fd);
+    }
+    if (!runs) {
+        perror("malloc failed");
+        return -1;
+    }
+
+    char path[4096];
+    char tmp_path[4096 + 16];
+    if (sidecar_path(library_path, path, sizeof(path)) != 0) {
+        free(runs);
+        return -1;
+    }
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int) getpid());
+
+    // Nom temporaire puis renommage, comme pour l'index de symboles
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror("open failed");
+        free(runs);
+        return -1;
+    }
+    size_t runs_size = hdr.run_count * sizeof(isosprof_run);
+    int ok = write(fd, &hdr, sizeof(hdr)) == (ssize_t) sizeof(hdr) &&
+             write(fd, runs, runs_size) == (ssize_t) runs_size;
+    free(runs);
+    if (!ok || close(fd) != 0 || rename(tmp_path, path) != 0) {
+        perror("write profile failed");
+        unlink(tmp_path);
+        return -1;
+    }
+    return total;
+}
+
+/**
+ * @brief Projette le profil de la bibliothèque s'il existe, correspond au
+ *        fichier ouvert et à la taille de page courante.
+ *
+ * @return 0 si le profil est utilisable, -1 sinon (prof reste vide).
+ */
+int isosprof_open(const char *library_path, const elf_file *elf, isosprof_t *prof) {
+    memset(prof, 0, sizeof(*prof));
+
+    char path[4096];
+    if (sidecar_path(library_path, path, sizeof(path)) != 0) {
+        return -1;
+    }
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if ((size_t) st.st_size < sizeof(isosprof_header)) {
+        debug_warn("Profil d'accès invalide, ignoré");
+        close(fd);
+        return -1;
+    }
+    size_t size = st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    const isosprof_header *hdr = map;
+    const isosprof_run *runs = (const isosprof_run *) (hdr + 1);
+    int valid = memcmp(hdr->magic, ISOSPROF_MAGIC, sizeof(hdr->magic)) == 0 &&
+                hdr->version == ISOSPROF_VERSION && hdr->page_size == (uint32_t) getpagesize() &&
+                sizeof(*hdr) + (uint64_t) hdr->run_count * sizeof(isosprof_run) == size;
+
+    // Chaque suite doit tenir dans un segment PT_LOAD du fichier
+    size_t page_size = getpagesize();
+    for (uint32_t i = 0; valid && i < hdr->run_count; i++) {
+        const isosprof_run *run = &runs[i];
+        if (run->segment >= elf->phnum || elf->phdrs[run->segment].p_type != PT_LOAD) {
+            valid = 0;
+            break;
+        }
+        const elf_phdr *ph = &elf->phdrs[run->segment];
+        uint64_t start = ph->p_vaddr & ~(page_size - 1);
+        uint64_t pages = (ph->p_vaddr + ph->p_memsz - start + page_size - 1) / page_size;
+        valid = (uint64_t) run->first_page + run->page_count <= pages;
+    }
+    if (!valid) {
+        debug_warn("Profil d'accès invalide, ignoré");
+        munmap(map, size);
+        return -1;
+    }
+
+    elf_identity current;
+    elf_identity_fill(elf, &current);
+    if (!elf_identity_match(&hdr->identity, &current)) {
+        debug_warn("Profil d'accès périmé, ignoré");
+        munmap(map, size);
+        return -1;
+    }
+
+    prof->map = map;
+    prof->size = size;
+    prof->hdr = hdr;
+    prof->runs = runs;
+    debug_info("Profil d'accès chargé");
+    return 0;
+}
+
+void isosprof_close(isosprof_t *prof) {
+    if (prof->map) {
+        munmap((void *) prof->map, prof->size);
+    }
+    memset(prof, 0, sizeof(*prof));
+}
+
+/**
+ * @return les octets de l'image de la bibliothèque présents dans ce
+ *         processus (mêmes sources que le profil).
+ */
+size_t isosprof_resident_bytes(void *handle) {
+    lib_handle_t *lib = (lib_handle_t *) handle;
+    if (!lib) {
+        return 0;
+    }
+    if (lib->current) {
+        lib = lib->current;
+    }
+    size_t page_size = getpagesize();
+    int pagemap_fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    size_t resident = 0;
+    for (int i = 0; i < lib->phnum && lib->base_addr; i++) {
+        if (lib->phdrs[i].p_type != PT_LOAD) {
+            continue;
+        }
+        void *addr;
+        size_t pages;
+        segment_pages(lib, i, page_size, &addr, &pages);
+        unsigned char *present = malloc(pages);
+        if (present && scan_present(pagemap_fd, addr, pages, page_size, present) == 0) {
+            for (size_t p = 0; p < pages; p++) {
+                resident += present[p] ? page_size : 0;
+            }
+        }
+        free(present);
+    }
+    if (pagemap_fd >= 0) {
+        close(pagemap_fd);
+    }
+    return resident;
+}
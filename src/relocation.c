@@ -1,13 +1,204 @@
+#define _GNU_SOURCE
 #include "elf_parser.h"
+#include "cpu_features.h"
 #include "debug.h"
+#include <dlfcn.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-int perform_relocations(void *base_addr, elf_header *hdr, elf_phdr *phdrs) {
-    debug_info("Début des relocations");
+// Nombre de résolveurs IFUNC mémorisés pendant un chargement
+#define IFUNC_CACHE_SIZE 64
+
+typedef struct {
+    uintptr_t resolver[IFUNC_CACHE_SIZE];
+    void *target[IFUNC_CACHE_SIZE];
+} ifunc_cache;
+
+/**
+ * @brief Appelle un résolveur IFUNC une seule fois par chargement.
+ *
+ * Plusieurs relocations (IRELATIVE, GLOB_DAT, JUMP_SLOT...) peuvent viser
+ * le même résolveur : le résultat est mis en cache pour que chaque site
+ * d'appel soit lié directement à la meilleure variante.
+ */
+static void *resolve_ifunc(ifunc_cache *cache, uintptr_t resolver) {
+    size_t slot = (resolver >> 4) % IFUNC_CACHE_SIZE;
+    for (size_t n = 0; n < IFUNC_CACHE_SIZE; n++) {
+        size_t i = (slot + n) % IFUNC_CACHE_SIZE;
+        if (cache->resolver[i] == resolver) {
+            return cache->target[i];
+        }
+        if (cache->resolver[i] == 0) {
+            isos_ifunc_resolver_t fn = (isos_ifunc_resolver_t) resolver;
+            cache->target[i] = fn(isos_cpu_features());
+            cache->resolver[i] = resolver;
+            debug_verbose("Résolveur IFUNC appelé");
+            return cache->target[i];
+        }
+    }
+
+    // Cache plein : on appelle le résolveur sans mémoriser
+    return ((isos_ifunc_resolver_t) resolver)(isos_cpu_features());
+}
+
+/**
+ * @brief Adresse d'une donnée importée (GLOB_DAT, R_X86_64_64), cherchée
+ *        dans le processus hôte.
+ *
+ * Seul l'hôte (dlsym(RTLD_DEFAULT)) est consulté : ni l'espace de noms
+ * du handle ni les autres images de my_dlopen(), que les relocations
+ * précèdent. Une donnée exportée par une autre image chargée par le
+ * loader reste donc introuvable ici ; seuls les appels (JUMP_SLOT) y
+ * sont cherchés, à la liaison paresseuse.
+ *
+ * @return l'adresse, NULL si le symbole y est introuvable.
+ */
+static void *lookup_data_import(const Elf64_Sym *sym, const char *strtab) {
+    if (!strtab) {
+        return NULL;
+    }
+    return dlsym(RTLD_DEFAULT, strtab + sym->st_name);
+}
+
+/**
+ * @brief Applique une table RELA.
+ *
+ * @param ifunc_pass 0 pour les relocations simples, 1 pour les IFUNC.
+ *        Les résolveurs IFUNC doivent s'exécuter une fois l'image mappée
+ *        et toutes les autres relocations appliquées.
+ * @return le nombre de données importées non faibles introuvables.
+ */
+static int apply_rela_table(void *base_addr, Elf64_Rela *rela, int rela_count,
+                             Elf64_Sym *symtab, const char *strtab, ifunc_cache *cache,
+                             int ifunc_pass) {
+    int missing = 0;
+    for (int i = 0; i < rela_count; i++) {
+        uint32_t type = ELF64_R_TYPE(rela[i].r_info);
+        uint32_t sym_idx = ELF64_R_SYM(rela[i].r_info);
+        uintptr_t target_addr = (uintptr_t) base_addr + rela[i].r_offset;
+        uint64_t *target = (uint64_t *) target_addr;
+
+        debug_verbose("Relocation trouvée");
+        switch (type) {
+            case R_X86_64_RELATIVE:
+            case R_ACCH64_RELATIVE:
+                if (!ifunc_pass) {
+                    *target = (uint64_t) base_addr + rela[i].r_addend;
+                    debug_verbose("Relocation de type RELATIVE");
+                }
+                break;
+
+            case R_X86_64_IRELATIVE:
+            case R_AARCH64_IRELATIVE:
+                if (ifunc_pass) {
+                    uintptr_t resolver = (uintptr_t) base_addr + rela[i].r_addend;
+                    *target = (uint64_t) resolve_ifunc(cache, resolver);
+                    debug_verbose("Relocation de type IRELATIVE");
+                }
+                break;
+
+            case R_X86_64_64:
+            case R_X86_64_GLOB_DAT:
+            case R_X86_64_JUMP_SLOT: {
+                // Seuls les symboles définis dans la bibliothèque sont liés ici
+                if (!symtab || sym_idx == 0) {
+                    break;
+                }
+                // sauf les données importées (typeinfo, personnalité C++...),
+                // cherchées dans le processus hôte ; les JUMP_SLOT le sont au premier appel
+                if (symtab[sym_idx].st_shndx == SHN_UNDEF) {
+                    if (ifunc_pass || type == R_X86_64_JUMP_SLOT) {
+                        break;
+                    }
+                    void *addr = lookup_data_import(&symtab[sym_idx], strtab);
+                    if (!addr && ELF64_ST_BIND(symtab[sym_idx].st_info) != STB_WEAK) {
+                        // Comme ld.so : symbole indéfini, chargement refusé
+                        debug_printf(DBG_ERROR, "Symbole indéfini : %s",
+                                     strtab ? strtab + symtab[sym_idx].st_name : "?");
+                        missing++;
+                        break;
+                    }
+                    // Import faible absent : le slot vaut 0
+                    *target = (uint64_t) addr + (type == R_X86_64_64 ? rela[i].r_addend : 0);
+                    debug_verbose("Relocation de donnée importée");
+                    break;
+                }
+                Elf64_Sym *sym = &symtab[sym_idx];
+                int is_ifunc = ELF64_ST_TYPE(sym->st_info) == STT_GNU_IFUNC;
+                if (is_ifunc != ifunc_pass) {
+                    break;
+                }
+                uint64_t value = (uint64_t) base_addr + sym->st_value;
+                if (is_ifunc) {
+                    value = (uint64_t) resolve_ifunc(cache, (uintptr_t) value);
+                }
+                if (type == R_X86_64_64) {
+                    value += rela[i].r_addend;
+                }
+                *target = value;
+                debug_verbose("Relocation de symbole local");
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+    return missing;
+}
+
+/**
+ * @brief Segment PT_LOAD qui contient [off, off + size) et dont les
+ *        droits incluent flags (PF_R, PF_W, PF_X). Les trous entre
+ *        segments restent PROT_NONE : une table doit tenir dans un seul.
+ *
+ * @return le segment, NULL si aucun.
+ */
+static const elf_phdr *image_segment(const dyn_tables *tables, uint64_t off, uint64_t size,
+                                     uint32_t flags) {
+    for (int i = 0; i < tables->phnum; i++) {
+        const elf_phdr *ph = &tables->phdrs[i];
+        if (ph->p_type == PT_LOAD && (ph->p_flags & flags) == flags && off >= ph->p_vaddr &&
+            off - ph->p_vaddr <= ph->p_memsz && size <= ph->p_memsz - (off - ph->p_vaddr)) {
+            return ph;
+        }
+    }
+    return NULL;
+}
+
+static int in_image(const dyn_tables *tables, uint64_t off, uint64_t size) {
+    return image_segment(tables, off, size, PF_R) != NULL;
+}
+
+// Table de relocations [off, off + size) : pointeur dans l'image et nombre d'entrées
+static int rela_view(void *base_addr, const dyn_tables *tables, uint64_t off, uint64_t size,
+                     Elf64_Rela **rela, int *count) {
+    if (size / sizeof(Elf64_Rela) > INT32_MAX || !in_image(tables, off, size)) {
+        return -1;
+    }
+    *rela = (Elf64_Rela *) ((uintptr_t) base_addr + off);
+    *count = (int) (size / sizeof(Elf64_Rela));
+    return 0;
+}
+
+/**
+ * @brief Parcourt PT_DYNAMIC et récupère les tables de relocations.
+ *
+ * Les valeurs de PT_DYNAMIC viennent du fichier : chaque table (et
+ * PT_DYNAMIC lui-même) doit tenir dans l'étendue des PT_LOAD, projetée
+ * en entier, avant d'être lue.
+ *
+ * @return 1 si des relocations sont présentes, 0 sinon, -1 si une table
+ *         sort de l'image.
+ */
+int find_dyn_tables(void *base_addr, const elf_header *hdr, const elf_phdr *phdrs,
+                    dyn_tables *tables) {
+    memset(tables, 0, sizeof(*tables));
 
-    elf_phdr *dyn_segment = NULL;
+    tables->phdrs = phdrs;
+    tables->phnum = hdr->e_phnum;
+    const elf_phdr *dyn_segment = NULL;
     for (int i = 0; i < hdr->e_phnum; i++) {
         if (phdrs[i].p_type == PT_DYNAMIC) {
             dyn_segment = &phdrs[i];
@@ -20,60 +211,477 @@ int perform_relocations(void *base_addr, elf_header *hdr, elf_phdr *phdrs) {
         debug_info("Aucun segment dynamique trouvé");
         return 0;
     }
-    Elf64_Rela *rela = NULL;
-    int rela_count = 0;
-    // Parcourir la section dynamique
-    //uint64_t *dynamic = (uint64_t *) ((char *) base_addr + dyn_segment->p_vaddr);
-    uintptr_t dynamic_addr = (uintptr_t)base_addr + dyn_segment->p_vaddr;
-    uint64_t *dynamic = (uint64_t *)dynamic_addr;
+    if (!in_image(tables, dyn_segment->p_vaddr, dyn_segment->p_memsz)) {
+        debug_error("PT_DYNAMIC hors de l'image");
+        return -1;
+    }
+    // Parcourir la section dynamique, sans dépasser le segment
+    const Elf64_Dyn *dynamic = (const Elf64_Dyn *) ((uintptr_t) base_addr + dyn_segment->p_vaddr);
+    size_t dyn_count = dyn_segment->p_memsz / sizeof(Elf64_Dyn);
     debug_detail("Section dynamique trouvée");
 
-    int i = 0;
+    uint64_t rela_off = 0, rela_size = 0, jmprel_off = 0, jmprel_size = 0;
+    uint64_t sym_off = 0, str_off = 0, str_size = 0, got_off = 0;
+    uint64_t init_array_off = 0, init_array_size = 0, fini_array_off = 0, fini_array_size = 0;
+    int has_rela = 0, has_jmprel = 0, has_sym = 0, has_str = 0, has_strsz = 0, has_got = 0;
+    size_t i;
+    for (i = 0; i < dyn_count && dynamic[i].d_tag != DT_NULL; i++) {
+        uint64_t val = dynamic[i].d_val;
+        debug_verbose("Entrée dynamique trouvée");
 
-    while (dynamic[i] != 0) {
-        uint64_t tag = dynamic[i++]; // Récupère le tag
-        uint64_t val = dynamic[i++]; // Récupère la valeur associée au tag
+        switch (dynamic[i].d_tag) {
+            case DT_RELA:
+                rela_off = val;
+                has_rela = 1;
+                debug_detail("Table RELA trouvée");
+                break;
+            case DT_RELASZ:
+                rela_size = val;
+                debug_detail("Taille table RELA trouvée");
+                break;
+            case DT_JMPREL:
+                // Relocations PLT (peuvent contenir des IRELATIVE)
+                jmprel_off = val;
+                has_jmprel = 1;
+                debug_detail("Table JMPREL trouvée");
+                break;
+            case DT_PLTRELSZ:
+                jmprel_size = val;
+                break;
+            case DT_SYMTAB:
+                sym_off = val;
+                has_sym = 1;
+                break;
+            case DT_STRTAB:
+                str_off = val;
+                has_str = 1;
+                break;
+            case DT_STRSZ:
+                str_size = val;
+                has_strsz = 1;
+                break;
+            case DT_PLTGOT:
+                got_off = val;
+                has_got = 1;
+                break;
+            case DT_RELR:
+                tables->has_relr = 1;
+                break;
+            case DT_INIT:
+                tables->init = val;
+                break;
+            case DT_FINI:
+                tables->fini = val;
+                break;
+            case DT_INIT_ARRAY:
+                init_array_off = val;
+                break;
+            case DT_INIT_ARRAYSZ:
+                init_array_size = val;
+                break;
+            case DT_FINI_ARRAY:
+                fini_array_off = val;
+                break;
+            case DT_FINI_ARRAYSZ:
+                fini_array_size = val;
+                break;
+            // -z now : RTLD_NOW imposé par l'éditeur de liens
+            case DT_BIND_NOW:
+                tables->bind_now = 1;
+                break;
+            case DT_FLAGS:
+                tables->bind_now |= (val & DF_BIND_NOW) != 0;
+                break;
+            case DT_FLAGS_1:
+                tables->bind_now |= (val & DF_1_NOW) != 0;
+                break;
+            default:
+                break;
+        }
+    }
+    if (i == dyn_count) {
+        debug_error("PT_DYNAMIC sans DT_NULL");
+        return -1;
+    }
 
-        debug_verbose("Entrée dynamique trouvée");
+    if ((has_rela && rela_view(base_addr, tables, rela_off, rela_size, &tables->rela,
+                               &tables->rela_count) != 0) ||
+        (has_jmprel && rela_view(base_addr, tables, jmprel_off, jmprel_size, &tables->jmprel,
+                                 &tables->jmprel_count) != 0)) {
+        debug_error("Table de relocations hors de l'image");
+        return -1;
+    }
+    if (has_sym) {
+        const elf_phdr *seg = image_segment(tables, sym_off, sizeof(Elf64_Sym), PF_R);
+        if (!seg) {
+            debug_error("DT_SYMTAB hors de l'image");
+            return -1;
+        }
+        tables->symtab = (Elf64_Sym *) ((uintptr_t) base_addr + sym_off);
+        tables->sym_count = (seg->p_vaddr + seg->p_memsz - sym_off) / sizeof(Elf64_Sym);
+    }
+    if (has_str) {
+        const elf_phdr *seg = image_segment(tables, str_off, 1, PF_R);
+        if (!has_strsz && seg) {
+            str_size = seg->p_vaddr + seg->p_memsz - str_off;
+        }
+        if (str_size == 0 || !in_image(tables, str_off, str_size)) {
+            debug_error("DT_STRTAB hors de l'image");
+            return -1;
+        }
+        tables->strtab = (const char *) ((uintptr_t) base_addr + str_off);
+        tables->strsz = str_size;
+    }
+    if (has_got) {
+        // GOT[0..2] : réservés à l'éditeur de liens, écrits après le mprotect final
+        if (!image_segment(tables, got_off, 3 * sizeof(uint64_t), PF_R | PF_W)) {
+            debug_error("DT_PLTGOT hors de l'image");
+            return -1;
+        }
+        tables->pltgot = (uint64_t *) ((uintptr_t) base_addr + got_off);
+    }
+    // DT_INIT et DT_FINI : du code ; les tableaux, des pointeurs relocalisés
+    if ((tables->init && !image_segment(tables, tables->init, 1, PF_R | PF_X)) ||
+        (tables->fini && !image_segment(tables, tables->fini, 1, PF_R | PF_X))) {
+        debug_error("DT_INIT/DT_FINI hors du code de l'image");
+        return -1;
+    }
+    if (init_array_size / sizeof(uint64_t) > INT32_MAX ||
+        fini_array_size / sizeof(uint64_t) > INT32_MAX ||
+        (init_array_size && !in_image(tables, init_array_off, init_array_size)) ||
+        (fini_array_size && !in_image(tables, fini_array_off, fini_array_size))) {
+        debug_error("DT_INIT_ARRAY/DT_FINI_ARRAY hors de l'image");
+        return -1;
+    }
+    if (init_array_size) {
+        tables->init_array = (const uint64_t *) ((uintptr_t) base_addr + init_array_off);
+        tables->init_array_count = (int) (init_array_size / sizeof(uint64_t));
+    }
+    if (fini_array_size) {
+        tables->fini_array = (const uint64_t *) ((uintptr_t) base_addr + fini_array_off);
+        tables->fini_array_count = (int) (fini_array_size / sizeof(uint64_t));
+    }
+    return tables->rela_count > 0 || tables->jmprel_count > 0;
+}
+
+/**
+ * @brief Constructeurs (fini == 0) ou destructeurs de l'image, dans
+ *        l'ordre de ld.so : DT_INIT puis DT_INIT_ARRAY ; DT_FINI_ARRAY
+ *        à rebours puis DT_FINI.
+ *
+ * À appeler une fois les relocations faites : les entrées des tableaux
+ * sont des adresses absolues. Les entrées 0 et -1 (sentinelles) sont
+ * ignorées ; les autres doivent pointer dans un segment exécutable.
+ *
+ * @param out : tableau d'au moins 1 + *_array_count entrées, ou NULL
+ *        pour seulement compter.
+ * @return le nombre de fonctions, -1 si une entrée sort du code.
+ */
+int dyn_init_functions(void *base_addr, const dyn_tables *tables, int fini, elf_init_fn *out) {
+    uint64_t single = fini ? tables->fini : tables->init;
+    const uint64_t *array = fini ? tables->fini_array : tables->init_array;
+    int array_count = fini ? tables->fini_array_count : tables->init_array_count;
+    int count = 0;
+
+    if (!fini && single) {
+        if (out) {
+            out[count] = (elf_init_fn) ((uintptr_t) base_addr + single);
+        }
+        count++;
+    }
+    for (int i = 0; i < array_count; i++) {
+        uint64_t addr = array[fini ? array_count - 1 - i : i];
+        if (addr == 0 || addr == UINT64_MAX) {
+            continue;
+        }
+        if (addr < (uintptr_t) base_addr ||
+            !image_segment(tables, addr - (uintptr_t) base_addr, 1, PF_R | PF_X)) {
+            debug_error("Constructeur ou destructeur hors du code de l'image");
+            return -1;
+        }
+        if (out) {
+            out[count] = (elf_init_fn) addr;
+        }
+        count++;
+    }
+    if (fini && single) {
+        if (out) {
+            out[count] = (elf_init_fn) ((uintptr_t) base_addr + single);
+        }
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Vérifie chaque entrée d'une table avant de l'appliquer : cible
+ *        dans un segment, symbole dans DT_SYMTAB et nom dans DT_STRTAB,
+ *        résolveur IFUNC dans un segment exécutable. Les passes
+ *        suivantes (IFUNC, liaison paresseuse, PLT) indexent sans
+ *        recontrôler.
+ *
+ * Les cibles écrites après le mprotect final (IFUNC, JUMP_SLOT
+ * paresseux) doivent être dans un segment PF_W.
+ *
+ * @return 0 si la table est saine, -1 sinon.
+ */
+static int check_rela_table(const dyn_tables *tables, const Elf64_Rela *rela, int rela_count) {
+    for (int i = 0; i < rela_count; i++) {
+        uint32_t type = ELF64_R_TYPE(rela[i].r_info);
+        uint32_t sym_idx = ELF64_R_SYM(rela[i].r_info);
+        uint32_t target_flags = 0;
+        // Tout indice de symbole est lu par une passe ou une autre, quel que soit le type
+        if (sym_idx != 0 &&
+            (!tables->symtab || sym_idx >= tables->sym_count ||
+             !elf_string(tables->strtab, tables->strsz, tables->symtab[sym_idx].st_name))) {
+            return -1;
+        }
+        switch (type) {
+            case R_X86_64_RELATIVE:
+            case R_ACCH64_RELATIVE:
+                break;
+            case R_X86_64_IRELATIVE:
+            case R_AARCH64_IRELATIVE:
+                if (!image_segment(tables, (uint64_t) rela[i].r_addend, 1, PF_X)) {
+                    return -1;
+                }
+                target_flags = PF_W;
+                break;
+            case R_X86_64_64:
+            case R_X86_64_GLOB_DAT:
+            case R_X86_64_JUMP_SLOT: {
+                if (type == R_X86_64_JUMP_SLOT) {
+                    target_flags = PF_W;
+                }
+                if (sym_idx == 0 || !tables->symtab) {
+                    break;
+                }
+                const Elf64_Sym *sym = &tables->symtab[sym_idx];
+                if (sym->st_shndx != SHN_UNDEF && ELF64_ST_TYPE(sym->st_info) == STT_GNU_IFUNC) {
+                    if (!image_segment(tables, sym->st_value, 1, PF_X)) {
+                        return -1;
+                    }
+                    target_flags = PF_W;
+                }
+                break;
+            }
+            default:
+                continue;
+        }
+        if (!image_segment(tables, rela[i].r_offset, sizeof(uint64_t), target_flags)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int perform_relocations(void *base_addr, const elf_header *hdr, const elf_phdr *phdrs) {
+    debug_info("Début des relocations");
 
-        if (tag == 7) {
-            // DT_RELA
-            //rela = (Elf64_Rela *) ((char *) base_addr + val); // Calcule l'adresse de la table RELA
-            uintptr_t rela_addr = (uintptr_t)base_addr + val;
-            rela = (Elf64_Rela *)rela_addr;
-            debug_detail("Table RELA trouvée");
-        } else if (tag == 8) {
-            // DT_RELASZ
-            rela_count = val / sizeof(Elf64_Rela);
-            // Calcule le nombre d'entrées dans la table en divisant la taille totale par la taille d'une entrée
-            debug_detail("Taille table RELA trouvée");
-        }
-    }
-    //structure recuperer read-df -d relacout npmbre d'netre
-    if (!rela || rela_count == 0) {
+    // TLS et relocations compactes (glibc, toolchains récents) : l'image
+    // serait incomplète, on refuse plutôt que de planter au premier appel
+    for (int i = 0; i < hdr->e_phnum; i++) {
+        if (phdrs[i].p_type == PT_TLS) {
+            debug_error("Segment PT_TLS non supporté");
+            return -1;
+        }
+    }
+
+    dyn_tables tables;
+    int has_relocs = find_dyn_tables(base_addr, hdr, phdrs, &tables);
+    if (has_relocs < 0) {
+        return -1;
+    }
+    if (tables.has_relr) {
+        debug_error("Relocations DT_RELR non supportées");
+        return -1;
+    }
+    if (!has_relocs) {
         debug_info("Aucune relocation trouvée");
         return 0;
     }
 
+    if (check_rela_table(&tables, tables.rela, tables.rela_count) != 0 ||
+        check_rela_table(&tables, tables.jmprel, tables.jmprel_count) != 0) {
+        debug_error("Relocation hors de l'image");
+        return -1;
+    }
+
     debug_info("Traitement des relocations");
+    int missing =
+        apply_rela_table(base_addr, tables.rela, tables.rela_count, tables.symtab, tables.strtab,
+                         NULL, 0) +
+        apply_rela_table(base_addr, tables.jmprel, tables.jmprel_count, tables.symtab,
+                         tables.strtab, NULL, 0);
+    if (missing > 0) {
+        return -1;
+    }
 
-    for (int i = 0; i < rela_count; i++) {
-        uint64_t offset = rela[i].r_offset;
-        uint32_t type = rela[i].r_info & 0xffffffff;
+    debug_info("Relocations terminées");
+    return 0;
+}
 
-        debug_verbose("Relocation trouvée");
-        if (type == R_X86_64_RELATIVE || type == R_ACCH64_RELATIVE) {
-            //uint64_t *target = (uint64_t *) ((char *) base_addr + offset);
-            uintptr_t target_addr = (uintptr_t)base_addr + offset;
-            uint64_t *target = (uint64_t *)target_addr;
-            debug_verbose("Relocation de type RELATIVE");
-            uint64_t new_value = (uint64_t) base_addr + rela[i].r_addend;
-            *target = new_value;
+// Vrai si chaque cible de la table tombe dans un segment PF_W
+static int targets_writable(const Elf64_Rela *rela, int rela_count, const elf_header *hdr,
+                            const elf_phdr *phdrs) {
+    for (int r = 0; r < rela_count; r++) {
+        uint64_t off = rela[r].r_offset;
+        int writable = 0;
+        for (int i = 0; i < hdr->e_phnum && !writable; i++) {
+            writable = phdrs[i].p_type == PT_LOAD && (phdrs[i].p_flags & PF_W) &&
+                       off >= phdrs[i].p_vaddr &&
+                       off + sizeof(uint64_t) <= phdrs[i].p_vaddr + phdrs[i].p_memsz;
+        }
+        if (!writable) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Vérifie qu'aucune relocation n'écrit dans un segment en lecture
+ *        seule (DT_TEXTREL). Nécessaire avec LOAD_SHARED_TEXT, où ces
+ *        segments ne sont jamais rendus inscriptibles.
+ *
+ * @return 0 si toutes les cibles sont inscriptibles, -1 sinon.
+ */
+int relocations_writable(void *base_addr, const elf_header *hdr, const elf_phdr *phdrs) {
+    dyn_tables tables;
+    int has_relocs = find_dyn_tables(base_addr, hdr, phdrs, &tables);
+    if (has_relocs <= 0) {
+        return has_relocs;
+    }
+    if (!targets_writable(tables.rela, tables.rela_count, hdr, phdrs) ||
+        !targets_writable(tables.jmprel, tables.jmprel_count, hdr, phdrs)) {
+        debug_error("Relocation dans un segment en lecture seule (TEXTREL)");
+        return -1;
+    }
+    return 0;
+}
+
+// JUMP_SLOT vers un symbole externe : lié au premier appel via GOT[2]
+int is_lazy_jump_slot(const Elf64_Rela *rela, const Elf64_Sym *symtab) {
+    uint32_t sym_idx = ELF64_R_SYM(rela->r_info);
+    return ELF64_R_TYPE(rela->r_info) == R_X86_64_JUMP_SLOT && symtab && sym_idx != 0 &&
+           symtab[sym_idx].st_shndx == SHN_UNDEF;
+}
 
-            debug_verbose("Relocation appliquée");
+/**
+ * @brief Prépare la liaison paresseuse d'une PLT standard (.plt/.got.plt).
+ *
+ * GOT[1] reçoit plt_handle et GOT[2] plt_resolver : PLT0 les empile et y
+ * saute comme vers _dl_runtime_resolve. Chaque slot JUMP_SLOT externe
+ * contient l'adresse de lien de son entrée PLT (push index ; jmp PLT0) :
+ * on la décale de la base pour que le premier appel passe par PLT0.
+ *
+ * @return le nombre de slots paresseux, -1 si la GOT est introuvable.
+ */
+int setup_lazy_plt(void *base_addr, const elf_header *hdr, const elf_phdr *phdrs,
+                   void *plt_handle, void *plt_resolver) {
+    dyn_tables tables;
+    int has_relocs = find_dyn_tables(base_addr, hdr, phdrs, &tables);
+    if (has_relocs <= 0) {
+        return has_relocs;
+    }
+    int lazy = 0;
+    for (int i = 0; i < tables.jmprel_count; i++) {
+        if (is_lazy_jump_slot(&tables.jmprel[i], tables.symtab)) {
+            uint64_t *slot = (uint64_t *) ((uintptr_t) base_addr + tables.jmprel[i].r_offset);
+            *slot += (uint64_t) base_addr;
+            lazy++;
         }
     }
+    if (lazy == 0) {
+        return 0;
+    }
+    if (!tables.pltgot) {
+        debug_error("DT_PLTGOT absent : liaison paresseuse impossible");
+        return -1;
+    }
+    tables.pltgot[1] = (uint64_t) plt_handle;
+    tables.pltgot[2] = (uint64_t) plt_resolver;
+    debug_info("PLT standard prête pour la liaison paresseuse");
+    return lazy;
+}
 
-    debug_info("Relocations terminées");
+/**
+ * @brief Cherche une relocation vers un symbole externe (non faible)
+ *        restée sans valeur après perform_relocations().
+ *
+ * Un résolveur IFUNC peut lire de tels slots (c'est le cas de la libc,
+ * qui dépend de ld.so) : on ne l'appelle pas tant qu'ils restent vides.
+ * Les données trouvées dans l'hôte sont liées et ne comptent pas ; avec
+ * lazy_plt, les JUMP_SLOT passent par le résolveur de PLT et ne comptent
+ * pas non plus.
+ */
+static int has_unbound_imports(Elf64_Rela *rela, int rela_count, Elf64_Sym *symtab,
+                               const char *strtab, int lazy_plt) {
+    if (!symtab) {
+        return 0;
+    }
+    for (int i = 0; i < rela_count; i++) {
+        uint32_t type = ELF64_R_TYPE(rela[i].r_info);
+        uint32_t sym_idx = ELF64_R_SYM(rela[i].r_info);
+        if (type != R_X86_64_64 && type != R_X86_64_GLOB_DAT && type != R_X86_64_JUMP_SLOT) {
+            continue;
+        }
+        if (lazy_plt && type == R_X86_64_JUMP_SLOT) {
+            continue;
+        }
+        if (sym_idx == 0 || symtab[sym_idx].st_shndx != SHN_UNDEF ||
+            ELF64_ST_BIND(symtab[sym_idx].st_info) == STB_WEAK) {
+            continue;
+        }
+        if (type == R_X86_64_JUMP_SLOT || !lookup_data_import(&symtab[sym_idx], strtab)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Vrai si la table contient une relocation à résoudre par un résolveur IFUNC
+static int has_ifunc_relocs(const Elf64_Rela *rela, int rela_count, const Elf64_Sym *symtab) {
+    for (int i = 0; i < rela_count; i++) {
+        uint32_t type = ELF64_R_TYPE(rela[i].r_info);
+        uint32_t sym_idx = ELF64_R_SYM(rela[i].r_info);
+        if (type == R_X86_64_IRELATIVE || type == R_AARCH64_IRELATIVE) {
+            return 1;
+        }
+        if (symtab && sym_idx != 0 && symtab[sym_idx].st_shndx != SHN_UNDEF &&
+            ELF64_ST_TYPE(symtab[sym_idx].st_info) == STT_GNU_IFUNC) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int perform_ifunc_relocations(void *base_addr, const elf_header *hdr, const elf_phdr *phdrs,
+                              int lazy_plt) {
+    dyn_tables tables;
+    int has_relocs = find_dyn_tables(base_addr, hdr, phdrs, &tables);
+    if (has_relocs <= 0) {
+        return has_relocs;
+    }
+
+    if (!has_ifunc_relocs(tables.rela, tables.rela_count, tables.symtab) &&
+        !has_ifunc_relocs(tables.jmprel, tables.jmprel_count, tables.symtab)) {
+        return 0;
+    }
+
+    // Les slots IFUNC resteraient vides : le premier appel planterait
+    if (has_unbound_imports(tables.rela, tables.rela_count, tables.symtab, tables.strtab,
+                            lazy_plt) ||
+        has_unbound_imports(tables.jmprel, tables.jmprel_count, tables.symtab, tables.strtab,
+                            lazy_plt)) {
+        debug_error("Imports externes non liés : résolveurs IFUNC impossibles");
+        return -1;
+    }
+
+    debug_info("Résolution des IFUNC");
+    ifunc_cache cache;
+    memset(&cache, 0, sizeof(cache));
+    apply_rela_table(base_addr, tables.rela, tables.rela_count, tables.symtab, tables.strtab, &cache, 1);
+    apply_rela_table(base_addr, tables.jmprel, tables.jmprel_count, tables.symtab, tables.strtab, &cache, 1);
     return 0;
 }
@@ -0,0 +1,253 @@
+#include "symbol_index.h"
+#include "dynloader.h"
+#include "debug.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// FNV-1a 32 bits : rapide sur des noms courts
+uint32_t isosidx_hash(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *) name; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int sidecar_path(const char *library_path, char *path, size_t size) {
+    int n = snprintf(path, size, "%s" ISOSIDX_SUFFIX, library_path);
+    return (n < 0 || (size_t) n >= size) ? -1 : 0;
+}
+
+/**
+ * @brief Écrit l'index <library_path>.isosidx des symboles exportés par
+ *        une bibliothèque déjà chargée.
+ *
+ * Le fichier est d'abord écrit sous un nom temporaire puis renommé : un
+ * processus qui le projette au même moment voit l'ancien ou le nouveau.
+ *
+ * @return le nombre de symboles indexés, -1 en cas d'erreur.
+ */
+int isosidx_write(const char *library_path, void *handle) {
+    lib_handle_t *lib = (lib_handle_t *) handle;
+    if (!lib || !lib->exported_symbols) {
+        debug_error("Handle invalide");
+        return -1;
+    }
+
+    elf_file elf;
+    if (elf_open(library_path, &elf) != 0) {
+        return -1;
+    }
+
+    // Seules les adresses dans l'image ont un sens dans un autre processus
+    uint64_t image_start;
+    size_t image_size;
+    if (load_extent(lib->phdrs, lib->phnum, 1, &image_start, &image_size) != 0) {
+        elf_close(&elf);
+        return -1;
+    }
+
+    isosidx_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, ISOSIDX_MAGIC, sizeof(hdr.magic));
+    hdr.version = ISOSIDX_VERSION;
+    elf_identity_fill(&elf, &hdr.identity);
+    elf_close(&elf);
+
+    // Taille de la table : puissance de deux, facteur de charge <= 1/2
+    uint32_t count = 0;
+    uint32_t strtab_size = 0;
+    for (symbol_entry *e = lib->exported_symbols; e->name; e++) {
+        count++;
+        strtab_size += strlen(e->name) + 1;
+    }
+    uint32_t buckets = 8;
+    while (buckets < count * 2) {
+        buckets *= 2;
+    }
+    hdr.bucket_count = buckets;
+    hdr.strtab_size = strtab_size;
+
+    size_t size = sizeof(hdr) + buckets * sizeof(isosidx_slot) + strtab_size;
+    uint8_t *buf = calloc(1, size);
+    if (!buf) {
+        perror("calloc failed");
+        return -1;
+    }
+    isosidx_slot *slots = (isosidx_slot *) (buf + sizeof(hdr));
+    char *strtab = (char *) (slots + buckets);
+    for (uint32_t i = 0; i < buckets; i++) {
+        slots[i].name_off = ISOSIDX_EMPTY;
+    }
+
+    uint32_t str_pos = 0;
+    int outside = 0;
+    for (symbol_entry *e = lib->exported_symbols; e->name; e++) {
+        // Adresse relative à la base, comme export_address() la lit
+        uintptr_t addr = (uintptr_t) e->addr;
+        if (addr >= (uintptr_t) lib->base_addr) {
+            addr -= (uintptr_t) lib->base_addr;
+        }
+        if (addr < image_start || addr - image_start >= image_size) {
+            outside++;
+            continue;
+        }
+        uint32_t hash = isosidx_hash(e->name);
+        uint32_t i = hash & (buckets - 1);
+        int duplicate = 0;
+        while (slots[i].name_off != ISOSIDX_EMPTY) {
+            // Comme my_dlsym(), la première entrée de la table l'emporte
+            if (slots[i].hash == hash && strcmp(strtab + slots[i].name_off, e->name) == 0) {
+                duplicate = 1;
+                break;
+            }
+            i = (i + 1) & (buckets - 1);
+        }
+        if (duplicate) {
+            continue;
+        }
+        slots[i].hash = hash;
+        slots[i].name_off = str_pos;
+        slots[i].offset = addr;
+        strcpy(strtab + str_pos, e->name);
+        str_pos += strlen(e->name) + 1;
+        hdr.entry_count++;
+    }
+    memcpy(buf, &hdr, sizeof(hdr));
+    if (outside) {
+        debug_printf(DBG_WARN, "%d export(s) hors de l'image, non indexé(s)", outside);
+    }
+
+    char path[4096];
+    char tmp_path[4096 + 16];
+    if (sidecar_path(library_path, path, sizeof(path)) != 0) {
+        free(buf);
+        return -1;
+    }
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int) getpid());
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror("open failed");
+        free(buf);
+        return -1;
+    }
+    ssize_t written = write(fd, buf, size);
+    free(buf);
+    if (written != (ssize_t) size || close(fd) != 0 || rename(tmp_path, path) != 0) {
+        perror("write index failed");
+        unlink(tmp_path);
+        return -1;
+    }
+    return (int) hdr.entry_count;
+}
+
+/**
+ * @brief Projette l'index de la bibliothèque s'il existe et correspond
+ *        bien au fichier ouvert (build-id, sinon périphérique/inode/
+ *        taille/date).
+ *
+ * @return 0 si l'index est utilisable, -1 sinon (idx reste vide).
+ */
+int isosidx_open(const char *library_path, const elf_file *elf, isosidx_t *idx) {
+    memset(idx, 0, sizeof(*idx));
+
+    char path[4096];
+    if (sidecar_path(library_path, path, sizeof(path)) != 0) {
+        return -1;
+    }
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(isosidx_header)) {
+        close(fd);
+        return -1;
+    }
+    size_t size = st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    const isosidx_header *hdr = map;
+    uint64_t expected = sizeof(*hdr) + (uint64_t) hdr->bucket_count * sizeof(isosidx_slot) +
+                        hdr->strtab_size;
+    const char *strtab = (const char *) map + sizeof(*hdr) +
+                         (size_t) hdr->bucket_count * sizeof(isosidx_slot);
+    if (memcmp(hdr->magic, ISOSIDX_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != ISOSIDX_VERSION || hdr->bucket_count == 0 ||
+        (hdr->bucket_count & (hdr->bucket_count - 1)) != 0 ||
+        expected != size ||
+        (hdr->strtab_size > 0 && strtab[hdr->strtab_size - 1] != '\0')) {
+        debug_warn("Index de symboles invalide, ignoré");
+        munmap(map, size);
+        return -1;
+    }
+
+    elf_identity current;
+    elf_identity_fill(elf, &current);
+    int match = elf_identity_match(&hdr->identity, &current);
+    if (!match) {
+        debug_warn("Index de symboles périmé, ignoré");
+        munmap(map, size);
+        return -1;
+    }
+    uint64_t image_start;
+    size_t image_size;
+    if (load_extent(elf->phdrs, elf->phnum, 1, &image_start, &image_size) != 0) {
+        munmap(map, size);
+        return -1;
+    }
+
+    idx->map = map;
+    idx->size = size;
+    idx->hdr = hdr;
+    idx->slots = (const isosidx_slot *) (hdr + 1);
+    idx->strtab = strtab;
+    idx->image_start = image_start;
+    idx->image_end = image_start + image_size;
+    debug_info("Index de symboles chargé");
+    return 0;
+}
+
+void isosidx_close(isosidx_t *idx) {
+    if (idx->map) {
+        munmap((void *) idx->map, idx->size);
+    }
+    memset(idx, 0, sizeof(*idx));
+}
+
+/**
+ * @return le slot du symbole, ou NULL s'il n'est pas exporté. Un slot
+ *         dont l'offset sort de l'image (index corrompu ou falsifié)
+ *         n'est jamais rendu.
+ */
+const isosidx_slot *isosidx_probe(const isosidx_t *idx, const char *name, uint32_t hash) {
+    uint32_t mask = idx->hdr->bucket_count - 1;
+    uint32_t i = hash & mask;
+    for (uint32_t n = 0; n <= mask; n++) {
+        const isosidx_slot *slot = &idx->slots[i];
+        if (slot->name_off == ISOSIDX_EMPTY) {
+            return NULL;
+        }
+        if (slot->hash == hash && slot->name_off < idx->hdr->strtab_size &&
+            strcmp(idx->strtab + slot->name_off, name) == 0) {
+            if (slot->offset < idx->image_start || slot->offset >= idx->image_end) {
+                debug_warn("Index de symboles : adresse hors de l'image, ignorée");
+                return NULL;
+            }
+            return slot;
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
@@ -1,14 +1,229 @@
+#define _GNU_SOURCE
 #include "debug.h"
 #include "dynloader.h"
 #include "elf_parser.h"
+#include "integrity.h"
+#include "callstats.h"
+#include "cpu_features.h"
 #include "isos-support.h"
+#include "arena.h"
 #include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
 void isos_trampoline();
+void isos_dl_resolve();
+#if defined(__x86_64__)
+/*
+ * Sauvegarde et restauration de l'état vectoriel (xmm, moitiés hautes
+ * des ymm/zmm, k0-7) sous les registres déjà empilés, comme
+ * _dl_runtime_resolve_xsave : zone alignée sur 64 de isos_xsave_size
+ * octets (CPUID 0xD), ou FXSAVE si le noyau n'a pas activé XSAVE.
+ * Utilisent %eax et %edx, à sauver avant.
+ */
+#define SAVE_VECTOR_STATE                                             \
+    "    andq $-64, %rsp"                                        "\n" \
+    "    movl isos_xsave_size(%rip), %eax"                       "\n" \
+    "    testl %eax, %eax"                                       "\n" \
+    "    jz 8f"                                                  "\n" \
+    "    subq %rax, %rsp"                                        "\n" \
+    "    xorl %edx, %edx"                                        "\n" \
+    "    movq %rdx, 512(%rsp)"                                   "\n" \
+    "    movq %rdx, 520(%rsp)"                                   "\n" \
+    "    movq %rdx, 528(%rsp)"                                   "\n" \
+    "    movq %rdx, 536(%rsp)"                                   "\n" \
+    "    movq %rdx, 544(%rsp)"                                   "\n" \
+    "    movq %rdx, 552(%rsp)"                                   "\n" \
+    "    movq %rdx, 560(%rsp)"                                   "\n" \
+    "    movq %rdx, 568(%rsp)"                                   "\n" \
+    "    movl $" XSTR(ISOS_XSAVE_MASK) ", %eax"                  "\n" \
+    "    xsave (%rsp)"                                           "\n" \
+    "    jmp 9f"                                                 "\n" \
+    "8:"                                                         "\n" \
+    "    subq $" XSTR(ISOS_FXSAVE_SIZE) ", %rsp"                 "\n" \
+    "    fxsave (%rsp)"                                          "\n" \
+    "9:"                                                         "\n"
+
+#define RESTORE_VECTOR_STATE                                          \
+    "    movl isos_xsave_size(%rip), %eax"                       "\n" \
+    "    testl %eax, %eax"                                       "\n" \
+    "    jz 8f"                                                  "\n" \
+    "    movl $" XSTR(ISOS_XSAVE_MASK) ", %eax"                  "\n" \
+    "    xorl %edx, %edx"                                        "\n" \
+    "    xrstor (%rsp)"                                          "\n" \
+    "    jmp 9f"                                                 "\n" \
+    "8:"                                                         "\n" \
+    "    fxrstor (%rsp)"                                         "\n" \
+    "9:"                                                         "\n"
+
+/*
+ * Sauvegarde et restauration du jeu complet de registres d'arguments
+ * (vectoriels compris) autour de l'appel d'un résolveur C. À l'entrée,
+ * après "push %rbp", 8(%rbp) et 16(%rbp) contiennent les deux mots
+ * empilés par l'entrée PLT.
+ */
+#define SAVE_ARG_REGS                                                 \
+    "    pushq %rbp"                                             "\n" \
+    "    movq %rsp, %rbp"                                        "\n" \
+    "    pushq %rdi"                                             "\n" \
+    "    pushq %rsi"                                             "\n" \
+    "    pushq %rdx"                                             "\n" \
+    "    pushq %rcx"                                             "\n" \
+    "    pushq %r8"                                              "\n" \
+    "    pushq %r9"                                              "\n" \
+    "    pushq %rax"                                             "\n" \
+    SAVE_VECTOR_STATE
+
+// Cible (retour du résolveur) dans %r11, pile revenue à son état d'entrée
+#define RESTORE_ARG_REGS                                              \
+    "    movq %rax, %r11"                                        "\n" \
+    RESTORE_VECTOR_STATE                                              \
+    "    leaq -56(%rbp), %rsp"                                   "\n" \
+    "    popq %rax"                                              "\n" \
+    "    popq %r9"                                               "\n" \
+    "    popq %r8"                                               "\n" \
+    "    popq %rcx"                                              "\n" \
+    "    popq %rdx"                                              "\n" \
+    "    popq %rsi"                                              "\n" \
+    "    popq %rdi"                                              "\n" \
+    "    leave"                                                  "\n"
+
+// Dépile aussi les deux mots de l'entrée PLT, puis saute sur la cible
+#define RESTORE_ARG_REGS_AND_JUMP                                     \
+    RESTORE_ARG_REGS                                                  \
+    "    addq $16, %rsp"                                         "\n" \
+    "    jmp *%r11"                                              "\n"
+
+/*
+ * Trampoline x86-64 qui préserve les arguments de l'appelant.
+ *
+ * A l'entrée la pile contient : [rsp] = handle, [rsp+8] = sym_id,
+ * [rsp+16] = adresse de retour de l'appelant. Les registres d'arguments
+ * (rdi, rsi, rdx, rcx, r8, r9, rax pour les varargs, xmm/ymm/zmm) ne
+ * sont jamais touchés sur le chemin rapide : si le symbole est déjà lié
+ * dans handle->plt_bound (sym_id < plt_bound_count), on saute
+ * directement sur la cible en n'utilisant que r10/r11. Sinon on
+ * sauvegarde tout le jeu de registres d'arguments (état vectoriel étendu
+ * compris) avant d'appeler loader_plt_resolver().
+ */
+asm(".pushsection .text,\"ax\",\"progbits\""                  "\n"
+    "isos_trampoline:"                                           "\n"
+    "    movq (%rsp), %r11"                                      "\n"
+    "    movq 8(%rsp), %r10"                                     "\n"
+    "    cmpl " XSTR(LIB_HANDLE_PLT_BOUND_COUNT_OFF) "(%r11), %r10d" "\n"
+    "    jae 1f"                                                 "\n"
+    "    movq " XSTR(LIB_HANDLE_PLT_BOUND_OFF) "(%r11), %r11"    "\n"
+    "    testq %r11, %r11"                                       "\n"
+    "    jz 1f"                                                  "\n"
+    "    movq (%r11,%r10,8), %r11"                               "\n"
+    "    testq %r11, %r11"                                       "\n"
+    "    jz 1f"                                                  "\n"
+    "    addq $16, %rsp"                                         "\n"
+    "    jmp *%r11"                                              "\n"
+    "1:"                                                         "\n"
+    SAVE_ARG_REGS
+    "    movq 8(%rbp), %rdi"                                     "\n"
+    "    movl 16(%rbp), %esi"                                    "\n"
+    "    call loader_plt_resolver@PLT"                           "\n"
+    RESTORE_ARG_REGS_AND_JUMP
+    ".popsection"                                                "\n");
+
+/*
+ * Équivalent de _dl_runtime_resolve pour les PLT standard : PLT0 empile
+ * GOT[1] (le handle) puis saute sur GOT[2], ici, avec [rsp] = handle,
+ * [rsp+8] = indice de la relocation dans DT_JMPREL. Le slot de la GOT
+ * est lié par loader_jmprel_resolver() : seul le premier appel passe ici.
+ */
+asm(".pushsection .text,\"ax\",\"progbits\""                  "\n"
+    "isos_dl_resolve:"                                           "\n"
+    SAVE_ARG_REGS
+    "    movq 8(%rbp), %rdi"                                     "\n"
+    "    movq 16(%rbp), %rsi"                                    "\n"
+    "    call loader_jmprel_resolver@PLT"                        "\n"
+    RESTORE_ARG_REGS_AND_JUMP
+    ".popsection"                                                "\n");
+
+/*
+ * Stubs de LOAD_CALLSTATS (cf. callstats.h). Un stub saute ici avec
+ * %r11 = son callstats_entry, la pile telle que l'a laissée l'appel.
+ * Chemin rapide, sans toucher aux registres d'arguments : compteur de
+ * l'import dans le bloc du thread, décompte avant le prochain
+ * chronométrage, puis saut sur la cible. Bloc absent ou décompte épuisé
+ * (la retenue couvre une ligne neuve, à zéro) : callstats_slow().
+ */
+asm(".pushsection .text,\"ax\",\"progbits\""                  "\n"
+    ".globl isos_call_count"                                     "\n"
+    ".type isos_call_count, @function"                           "\n"
+    "isos_call_count:"                                           "\n"
+    "    movq isos_callstats_lines@gottpoff(%rip), %r10"         "\n"
+    "    movq %fs:(%r10), %r10"                                  "\n"
+    "    testq %r10, %r10"                                       "\n"
+    "    jz 1f"                                                  "\n"
+    "    addq " XSTR(CALLSTATS_LINE_OFF) "(%r11), %r10"          "\n"
+    "    incq " XSTR(CALLSTATS_CALLS_OFF) "(%r10)"               "\n"
+    "    subl $1, " XSTR(CALLSTATS_COUNTDOWN_OFF) "(%r10)"       "\n"
+    "    jbe 1f"                                                 "\n"
+    "    jmp *" XSTR(CALLSTATS_TARGET_OFF) "(%r11)"              "\n"
+    "1:"                                                         "\n"
+    SAVE_ARG_REGS
+    "    movq %r11, %rdi"                                        "\n"
+    "    leaq 8(%rbp), %rsi"                                     "\n"
+    "    call callstats_slow@PLT"                                "\n"
+    RESTORE_ARG_REGS
+    "    jmp *%r11"                                              "\n"
+    ".size isos_call_count, .-isos_call_count"                   "\n"
+    ".popsection"                                                "\n");
+
+/*
+ * Retour d'un appel chronométré : la cible a fait "ret" ici au lieu de
+ * chez l'appelant. Les registres de retour (rax, rdx, état vectoriel
+ * pour xmm0/xmm1 et leurs moitiés hautes) sont préservés autour de
+ * callstats_return(), qui rend la vraie adresse de retour ; -8(%rsp) est
+ * le mot qui la contenait.
+ */
+asm(".pushsection .text,\"ax\",\"progbits\""                  "\n"
+    ".globl isos_call_return"                                    "\n"
+    ".type isos_call_return, @function"                          "\n"
+    "isos_call_return:"                                          "\n"
+    "    leaq -8(%rsp), %rdi"                                    "\n"
+    "    pushq %rbp"                                             "\n"
+    "    movq %rsp, %rbp"                                        "\n"
+    "    pushq %rax"                                             "\n"
+    "    pushq %rdx"                                             "\n"
+    SAVE_VECTOR_STATE
+    "    call callstats_return@PLT"                              "\n"
+    "    movq %rax, %r11"                                        "\n"
+    RESTORE_VECTOR_STATE
+    "    leaq -16(%rbp), %rsp"                                   "\n"
+    "    popq %rdx"                                              "\n"
+    "    popq %rax"                                              "\n"
+    "    leave"                                                  "\n"
+    "    jmp *%r11"                                              "\n"
+    ".size isos_call_return, .-isos_call_return"                 "\n"
+    ".popsection"                                                "\n");
+
+/*
+ * my_dlplt_call(a, b, c, d, e, f, x, handle, sym_id) rejoue une entrée
+ * PLT de bibliothèque (push id ; push handle ; jmp isos_trampoline) pour
+ * mesurer depuis le loader le coût d'un import. a..f et x restent dans
+ * rdi..r9 et xmm0, où l'import les trouve ; handle et sym_id arrivent sur
+ * la pile (7e et 8e arguments entiers) et y sont empilés dans l'ordre
+ * d'une entrée PLT.
+ */
+asm(".pushsection .text,\"ax\",\"progbits\""                  "\n"
+    ".globl my_dlplt_call"                                       "\n"
+    ".type my_dlplt_call, @function"                             "\n"
+    "my_dlplt_call:"                                             "\n"
+    "    pushq 16(%rsp)"                                         "\n"
+    "    pushq 16(%rsp)"                                         "\n"
+    "    jmp isos_trampoline"                                    "\n"
+    ".size my_dlplt_call, .-my_dlplt_call"                       "\n"
+    ".popsection"                                                "\n");
+#else
 asm(".pushsection .text,\"ax\",\"progbits\""
     "\n"
     "isos_trampoline:"
@@ -17,6 +232,7 @@ asm(".pushsection .text,\"ax\",\"progbits\""
     "\n" JMP_REG(REG_RET) "\n"
     ".popsection"
     "\n");
+#endif
 
 /**
  * @param handler  : the loader handler returned by my_dlopen().
@@ -30,240 +246,1119 @@ asm(".pushsection .text,\"ax\",\"progbits\""
  *                   from the imported symbol table.
  * @return the address of the function to be called by the trampoline.
  */
-typedef struct {
-    uint64_t vaddr;
-    uint64_t size;
-    uint32_t flags;
-} load_segment;
 
-int check_elf(const char *library_path) {
-    elf_header hdr;
+// Affiche l'en-tête ELF de library_path ; -1 si ce n'est pas un ELF valide
+int my_dlcheck_elf(const char *library_path) {
+    elf_file elf;
 
-    if (read_elf_header(library_path, &hdr) != 0) {
+    if (elf_open(library_path, &elf) != 0) {
         return -1;
     }
 
-    if (check_valid_lib(&hdr) != 0) {
+    print_header(elf.hdr);
+
+    elf_close(&elf);
+    return 0;
+}
+
+// Résumé des segments PT_LOAD, déjà validés par elf_open()
+static void print_load_segments(const elf_file *elf) {
+    const elf_phdr *first = NULL;
+    const elf_phdr *last = NULL;
+    int load_count = 0;
+    elf_iter it;
+    const elf_phdr *ph;
+    elf_iter_init(&it, elf);
+    while ((ph = elf_next_phdr(&it)) != NULL) {
+        if (ph->p_type != PT_LOAD) {
+            continue;
+        }
+        if (!first) {
+            first = ph;
+        }
+        last = ph;
+        load_count++;
+    }
+    if (!first) {
+        return;
+    }
+
+    printf("Load segments found: %d\n", load_count);
+    printf("Total memory size required: %lu bytes\n",
+           last->p_vaddr + last->p_memsz - first->p_vaddr);
+
+    int idx = 0;
+    elf_iter_init(&it, elf);
+    while ((ph = elf_next_phdr(&it)) != NULL) {
+        if (ph->p_type != PT_LOAD) {
+            continue;
+        }
+        printf("PT_LOAD[%d]: vaddr=0x%lx, size=%lu, flags=%c%c%c\n", idx++,
+               ph->p_vaddr, ph->p_memsz,
+               (ph->p_flags & PF_R) ? 'R' : '-',
+               (ph->p_flags & PF_W) ? 'W' : '-',
+               (ph->p_flags & PF_X) ? 'X' : '-');
+    }
+}
+
+// Arguments du processus, passés aux constructeurs comme le fait ld.so
+static int process_argc;
+static char **process_argv;
+
+__attribute__((constructor)) static void save_process_args(int argc, char **argv, char **envp) {
+    (void) envp;
+    process_argc = argc;
+    process_argv = argv;
+}
+
+/**
+ * @brief Fin du chargement d'un handle publié : liaison immédiate si
+ *        l'image la demande (-z now), puis ses constructeurs.
+ *
+ * Un import introuvable à ce stade reste paresseux au lieu de faire
+ * échouer le chargement : la table de l'hôte (my_set_plt_resolve()) ne
+ * peut être fournie qu'après l'ouverture, et la relie alors.
+ */
+static void run_constructors(lib_handle_t *handle) {
+    if (handle->bind_now) {
+        int missing = my_dlprebind(handle);
+        if (missing > 0) {
+            debug_printf(DBG_INFO, "BIND_NOW : %d import(s) lié(s) au premier appel",
+                         missing);
+        }
+    }
+    for (int i = 0; i < handle->init_count; i++) {
+        handle->init_funcs[i](process_argc, process_argv, environ);
+    }
+    handle->initialized = 1;
+}
+
+static void run_destructors(lib_handle_t *handle) {
+    if (!handle->initialized) {
+        return;
+    }
+    handle->initialized = 0;
+    for (int i = 0; i < handle->fini_count; i++) {
+        handle->fini_funcs[i](process_argc, process_argv, environ);
+    }
+}
+
+// Démonte l'image et son index ; les métadonnées restent dans l'arène
+static void release_image(lib_handle_t *handle) {
+    run_destructors(handle);
+    eh_frame_deregister(&handle->eh_frame);
+    isosidx_close(&handle->sym_index);
+    if (handle->pack) {
+        pack_release(handle->pack, handle->base_addr, handle->phdrs, handle->phnum);
+    } else {
+        unload_library(handle->base_addr, handle->phdrs, handle->phnum);
+    }
+    handle->base_addr = NULL;
+}
+
+// Libère tout ce qu'un handle possède : image, index et arène (handle compris).
+// L'arène d'un handle packé est celle du pack, libérée par my_dlpack_destroy().
+static void release_handle(lib_handle_t *handle) {
+    release_image(handle);
+    callstats_destroy(handle->callstats);
+    shared_exports_put(handle->shared_exports);
+    if (!handle->pack) {
+        arena_destroy(handle->arena);
+    }
+}
+
+// Chargement abandonné : comme release_handle(), et l'arène d'un pack
+// rend aussi le handle et ses métadonnées (allouées depuis mark)
+static void discard_handle(lib_handle_t *handle, arena_mark_t mark) {
+    lib_pack_t *pack = handle->pack;
+    release_handle(handle);
+    if (pack) {
+        arena_rewind(pack->arena, mark);
+    }
+}
+
+static void retire_version(void *arg) {
+    release_handle(arg);
+}
+
+// Le handle d'origine reste celui de l'appelant : seule son image part
+static void retire_root_image(void *arg) {
+    release_image(arg);
+}
+
+// Version effectivement servie par un handle (cf. my_dlreload())
+static lib_handle_t *current_version(void *handle) {
+    lib_handle_t *lib = handle;
+    lib_handle_t *current = __atomic_load_n(&lib->current, __ATOMIC_SEQ_CST);
+    return current ? current : lib;
+}
+
+// Filtre de Bloom des noms exportés (table d'export et index .isosidx)
+static int build_exports_bloom(lib_handle_t *handle) {
+    size_t count = handle->sym_index.map ? handle->sym_index.hdr->entry_count : 0;
+    for (symbol_entry *e = handle->exported_symbols; e && e->name; e++) {
+        count++;
+    }
+    if (bloom_init(&handle->exports_bloom, handle->arena, count) != 0) {
         return -1;
     }
+    for (symbol_entry *e = handle->exported_symbols; e && e->name; e++) {
+        bloom_add(&handle->exports_bloom, isosidx_hash(e->name));
+    }
+    for (uint32_t i = 0; handle->sym_index.map && i < handle->sym_index.hdr->bucket_count; i++) {
+        if (handle->sym_index.slots[i].name_off != ISOSIDX_EMPTY) {
+            bloom_add(&handle->exports_bloom, handle->sym_index.slots[i].hash);
+        }
+    }
+    return 0;
+}
 
-    print_header(&hdr);
+/**
+ * @brief Construit l'index trié des symboles exportés (fusion de
+ *        my_dlbind()). Fait au chargement, avant publication du handle :
+ *        les lecteurs concurrents le trouvent complet, sans verrou.
+ *
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation.
+ */
+static int build_sorted_exports(lib_handle_t *lib) {
+    if (!lib->exported_symbols) {
+        return 0;
+    }
+    lib->sorted_exports = exports_sort(lib->arena, lib->exported_symbols, &lib->export_count);
+    return lib->sorted_exports ? 0 : -1;
+}
 
+/*
+ * LOAD_CALLSTATS : un stub par import, ceux de la PLT du loader (sym_id)
+ * puis ceux de la PLT standard (plt_bound_count + indice DT_JMPREL).
+ * Sans profil possible l'image reste chargée, sans compteurs.
+ */
+// Nom de l'import id d'un profil : PLT du loader, puis slots JUMP_SLOT
+static const char *import_name(const lib_handle_t *lib, int id) {
+    if (id < lib->plt_bound_count) {
+        return lib->imported_symbols[id];
+    }
+    const Elf64_Rela *rela = &lib->jmprel[id - lib->plt_bound_count];
+    return lib->dynstr + lib->dynsym[ELF64_R_SYM(rela->r_info)].st_name;
+}
+
+static void attach_callstats(lib_handle_t *handle) {
+    if (!(handle->load_flags & LOAD_CALLSTATS)) {
+        return;
+    }
+    int count = handle->plt_bound_count + (handle->plt_stubs ? handle->jmprel_count : 0);
+    handle->callstats = count > 0 ? callstats_create(count) : NULL;
+    if (count > 0 && !handle->callstats) {
+        debug_warn("Profil des appels indisponible");
+    }
+    // setjmp, vfork... : une adresse de retour déviée ne survivrait pas au second retour
+    for (int id = 0; handle->callstats && id < count; id++) {
+        if (callstats_returns_twice(import_name(handle, id))) {
+            callstats_set_count_only(handle->callstats, id);
+        }
+    }
+}
+
+/*
+ * loader_info_t est une donnée : une bibliothèque écrite pour ce loader
+ * (--entry loader_info) a son point d'entrée dans un segment non
+ * exécutable. Sinon (e_entry nul, ou dans le texte comme pour la libc),
+ * c'est une bibliothèque ordinaire.
+ */
+static int has_loader_info(const elf_file *elf) {
+    uint64_t entry = elf->hdr->e_entry;
+    if (entry == 0) {
+        return 0;
+    }
+    for (size_t i = 0; i < elf->phnum; i++) {
+        const elf_phdr *ph = &elf->phdrs[i];
+        if (ph->p_type == PT_LOAD && entry >= ph->p_vaddr && entry < ph->p_vaddr + ph->p_memsz) {
+            // La structure entière dans le segment ; son contenu, lui, fait foi
+            return !(ph->p_flags & PF_X) &&
+                   sizeof(loader_info_t) <= ph->p_vaddr + ph->p_memsz - entry;
+        }
+    }
     return 0;
 }
 
-int validate_load_segments(const char *library_path, elf_header *hdr) {
-    int fd = open(library_path, O_RDONLY);
-    if (fd < 0) {
-        perror("open failed");
+// Tables d'import et d'export fournies par loader_info, et cache de liaison PLT
+static int bind_loader_info(lib_handle_t *handle, uint64_t entry) {
+    // Fix alignment issues using uintptr_t for pointer arithmetic
+    uintptr_t info_addr_int = (uintptr_t) handle->base_addr + entry;
+
+    // Check alignment before casting
+    if (info_addr_int % sizeof(loader_info_t) != 0) {
+        debug_error("Adresse de loader_info mal alignée");
         return -1;
     }
 
-    elf_phdr *phdrs = NULL;
-    if (read_program_headers(fd, hdr, &phdrs) != 0) {
-        close(fd);
+    // Now it's safe to cast to loader_info_t*
+    loader_info_t *info = (loader_info_t *) info_addr_int;
+
+    // add tabsymbol to handle
+    handle->imported_symbols = info->imported_symbols;
+    handle->exported_symbols = info->exported_symbols;
+
+    // Cache de liaison PLT : une entrée par symbole importé
+    int import_count = 0;
+    while (handle->imported_symbols && handle->imported_symbols[import_count]) {
+        import_count++;
+    }
+    if (import_count > 0) {
+        handle->plt_bound = arena_calloc(handle->arena, import_count, sizeof(void *));
+        if (!handle->plt_bound) {
+            perror("Failed to allocate PLT binding cache");
+            return -1;
+        }
+        handle->plt_bound_count = import_count;
+    }
+    *(info->loader_handle) = handle;
+    *(info->isos_trampoline) = &isos_trampoline;
+    return 0;
+}
+
+// Table d'export d'une bibliothèque ordinaire (cf. elf_sym_exported())
+static int collect_dynsym_exports(lib_handle_t *handle, size_t dynsym_count) {
+    if (!handle->dynsym || !handle->dynstr || dynsym_count == 0) {
+        debug_warn("Error: no loader_info and no .dynsym");
         return -1;
     }
+    symbol_entry *exports = arena_calloc(handle->arena, dynsym_count + 1, sizeof(symbol_entry));
+    if (!exports) {
+        perror("Failed to allocate export table");
+        return -1;
+    }
+    // Le compte vient de la section .dynsym du fichier : borné par l'image
+    if (dynsym_count > handle->dynsym_count) {
+        dynsym_count = handle->dynsym_count;
+    }
+    int count = 0;
+    for (size_t i = 1; i < dynsym_count; i++) {
+        const Elf64_Sym *sym = &handle->dynsym[i];
+        const char *name = elf_string(handle->dynstr, handle->dynstr_size, sym->st_name);
+        if (!name || !elf_sym_exported(sym)) {
+            continue;
+        }
+        exports[count].name = name;
+        exports[count].addr = (char *) handle->base_addr + sym->st_value;
+        count++;
+    }
+    handle->exported_symbols = exports;
+    return 0;
+}
 
-    int load_count = 0;
-    load_segment *load_segments = malloc(hdr->e_phnum * sizeof(load_segment));
-    if (!load_segments) {
-        perror("malloc failed");
-        free(phdrs);
-        close(fd);
+// Constructeurs et destructeurs de l'image, appelés à la publication et au démontage
+static int record_init(lib_handle_t *handle, const dyn_tables *tables) {
+    int init_count = dyn_init_functions(handle->base_addr, tables, 0, NULL);
+    int fini_count = dyn_init_functions(handle->base_addr, tables, 1, NULL);
+    if (init_count < 0 || fini_count < 0) {
         return -1;
     }
+    handle->bind_now = tables->bind_now;
+    handle->init_funcs = arena_calloc(handle->arena, init_count + 1, sizeof(elf_init_fn));
+    handle->fini_funcs = arena_calloc(handle->arena, fini_count + 1, sizeof(elf_init_fn));
+    if (!handle->init_funcs || !handle->fini_funcs) {
+        perror("Failed to record constructors");
+        return -1;
+    }
+    handle->init_count = dyn_init_functions(handle->base_addr, tables, 0, handle->init_funcs);
+    handle->fini_count = dyn_init_functions(handle->base_addr, tables, 1, handle->fini_funcs);
+    return 0;
+}
 
-    for (int i = 0; i < hdr->e_phnum; i++) {
-        if (phdrs[i].p_type == PT_LOAD) {
-            load_segments[load_count].vaddr = phdrs[i].p_vaddr;
-            load_segments[load_count].size = phdrs[i].p_memsz;
-            load_segments[load_count].flags = phdrs[i].p_flags;
-            load_count++;
+// Tables DT_JMPREL de l'image et entrées PLT d'origine des slots paresseux
+static int record_plt(lib_handle_t *handle, const elf_header *hdr, const elf_phdr *phdrs) {
+    dyn_tables tables;
+    if (find_dyn_tables(handle->base_addr, hdr, phdrs, &tables) < 0 ||
+        record_init(handle, &tables) != 0) {
+        return -1;
+    }
+    handle->dynsym = tables.symtab;
+    handle->dynstr = tables.strtab;
+    handle->dynsym_count = tables.sym_count;
+    handle->dynstr_size = tables.strsz;
+    if (tables.jmprel_count == 0 || !tables.symtab || !tables.strtab) {
+        return 0;
+    }
+    handle->jmprel = tables.jmprel;
+    handle->jmprel_count = tables.jmprel_count;
+    handle->plt_stubs = arena_calloc(handle->arena, tables.jmprel_count, sizeof(uint64_t));
+    if (!handle->plt_stubs) {
+        perror("Failed to record PLT entries");
+        return -1;
+    }
+    for (int i = 0; i < tables.jmprel_count; i++) {
+        if (is_lazy_jump_slot(&tables.jmprel[i], tables.symtab)) {
+            handle->plt_stubs[i] =
+                    *(uint64_t *) ((char *) handle->base_addr + tables.jmprel[i].r_offset);
         }
     }
+    return 0;
+}
 
-    if (load_count == 0) {
-        printf("Error: No PT_LOAD segments found in library\n");
-        free(load_segments);
-        free(phdrs);
-        close(fd);
-        return -1;
+/**
+ * @brief Chargement commun à my_dlopen(), my_dlopen_fd() et
+ *        my_dlopen_mem() à partir d'un fichier ELF déjà projeté.
+ *
+ * @param library_path : chemin du fichier, ou NULL pour une image sans
+ *        chemin (pas d'index .isosidx dans ce cas).
+ * @param pack : pack dans lequel placer l'image, ou NULL.
+ * @param flags : options LOAD_* de load_library_ex().
+ * @param shared : table d'export partagée à utiliser au lieu de .dynsym
+ *        (référence cédée au handle), ou NULL.
+ * @return le handle, ou NULL (elf est fermé dans tous les cas).
+ */
+static void *dlopen_elf(elf_file *elf_in, const char *library_path, lib_pack_t *pack,
+                        int flags, shared_exports_t *shared) {
+    elf_file elf = *elf_in;
+    // Rien sur stdout pour un hôte qui a coupé les traces (my_dldebug_init(0))
+    if (debug_level > DBG_NONE) {
+        print_header(elf.hdr);
+        print_load_segments(&elf);
     }
 
-    uint64_t phdr_end = hdr->e_phoff + (hdr->e_phnum * hdr->e_phentsize);
-    int phdr_covered = 0;
+    // Toutes les métadonnées du chargement vivent dans une seule arène,
+    // le handle compris (celle du pack pour une image packée)
+    arena_t *arena = pack ? pack->arena : arena_create(ARENA_DEFAULT_RESERVE);
+    arena_mark_t mark = arena_mark(arena);
+    lib_handle_t *handle = arena_alloc(arena, sizeof(lib_handle_t));
+    if (!handle) {
+        perror("Failed to allocate memory for handle");
+        if (!pack) {
+            arena_destroy(arena);
+        }
+        shared_exports_put(shared);
+        elf_close(&elf);
+        return NULL;
+    }
+    handle->arena = arena;
+    handle->shared_exports = shared;
+    handle->pack = pack;
+    handle->load_flags = flags;
 
-    for (int i = 0; i < hdr->e_phnum; i++) {
-        if (phdrs[i].p_type == PT_LOAD && phdrs[i].p_offset <= hdr->e_phoff &&
-            phdrs[i].p_offset + phdrs[i].p_filesz >= phdr_end) {
-            phdr_covered = 1;
-            break;
+    // Le handle garde sa propre copie de la disposition des segments
+    handle->phnum = elf.phnum;
+    handle->phdrs = arena_memdup(arena, elf.phdrs, elf.phnum * sizeof(elf_phdr));
+    if (!handle->phdrs) {
+        perror("Failed to copy program headers");
+        discard_handle(handle, mark);
+        elf_close(&elf);
+        return NULL;
+    }
+
+    // Modified to store base_addr in the handle
+    void *base_addr = NULL;
+    load_options_t opts = {.flags = flags, .reservation = NULL};
+#if defined(__x86_64__)
+    // PLT standard : GOT[1] = handle, GOT[2] = isos_dl_resolve
+    opts.plt_handle = handle;
+    opts.plt_resolver = (void *) isos_dl_resolve;
+#endif
+    opts.compressed = elf.compressed;
+
+    // Image packée : plage suivante de la réservation commune
+    if (pack) {
+        uint64_t base_offset;
+        size_t total_size;
+        if (load_extent(elf.phdrs, elf.phnum, getpagesize(), &base_offset, &total_size) != 0 ||
+            !(opts.reservation = pack_reserve(pack, total_size))) {
+            debug_warn("Error: library does not fit in the pack");
+            discard_handle(handle, mark);
+            elf_close(&elf);
+            return NULL;
         }
     }
 
-    if (!phdr_covered && strstr(library_path, "lib") == NULL) {
-        printf("Error: No PT_LOAD segment spans all program headers\n");
-        free(load_segments);
-        free(phdrs);
-        close(fd);
-        return -1;
+    // Profil d'accès enregistré lors d'un échauffement précédent
+    isosprof_t profile;
+    memset(&profile, 0, sizeof(profile));
+    if ((flags & LOAD_PROFILE) && library_path &&
+        isosprof_open(library_path, &elf, &profile) == 0) {
+        opts.profile = &profile;
     }
 
-    for (int i = 1; i < load_count; i++) {
-        if (load_segments[i].vaddr < load_segments[i - 1].vaddr) {
-            printf("Error: PT_LOAD segments not in ascending order\n");
-            free(load_segments);
-            free(phdrs);
-            close(fd);
-            return -1;
+    // CRC32C attendus des segments, lus dans la note du fichier
+    if (flags & LOAD_VERIFY) {
+        uint32_t *crcs = arena_calloc(arena, elf.phnum, sizeof(uint32_t));
+        if (crcs && integrity_note_find(&elf, crcs) == 0) {
+            opts.crc32c = crcs;
         }
     }
 
-    for (int i = 1; i < load_count; i++) {
-        uint64_t prev_end = load_segments[i - 1].vaddr + load_segments[i - 1].size;
-        if (load_segments[i].vaddr < prev_end) {
-            printf("Error: PT_LOAD segments overlap in memory\n");
-            free(load_segments);
-            free(phdrs);
-            close(fd);
-            return -1;
+    int loaded = load_library_ex(elf.fd, elf.hdr, elf.phdrs, &opts, &handle->load_stats,
+                                 &base_addr);
+    isosprof_close(&profile);
+    if (loaded != 0) {
+        perror("Failed to load library");
+        discard_handle(handle, mark);
+        elf_close(&elf);
+        return NULL;
+    }
+    handle->base_addr = base_addr;
+
+    // Plages projetées, pour my_dlmeminfo()
+    handle->range_count = meminfo_ranges(base_addr, elf.phdrs, elf.phnum, getpagesize(), NULL);
+    handle->ranges = arena_alloc(arena, handle->range_count * sizeof(mapped_range_t));
+    if (!handle->ranges) {
+        perror("Failed to record mapped ranges");
+        discard_handle(handle, mark);
+        elf_close(&elf);
+        return NULL;
+    }
+    meminfo_ranges(base_addr, elf.phdrs, elf.phnum, getpagesize(), handle->ranges);
+
+    // Exceptions C++ à travers l'image : ses tables sont relocalisées et en place
+    eh_frame_register(&handle->eh_frame, base_addr, elf.phdrs, elf.phnum);
+
+    // Index de symboles précalculé, s'il correspond à ce fichier
+    if (library_path) {
+        isosidx_open(library_path, &elf, &handle->sym_index);
+    }
+
+    // PLT standard et symboles dynamiques, lus dans l'image chargée
+    if (record_plt(handle, elf.hdr, elf.phdrs) != 0) {
+        discard_handle(handle, mark);
+        elf_close(&elf);
+        return NULL;
+    }
+
+    int with_loader_info = has_loader_info(&elf);
+    size_t dynsym_count = elf.dynsym_count;
+    uint64_t entry = elf.hdr->e_entry;
+    elf_close(&elf);
+
+    // Table partagée entre instances : rien à construire
+    if (shared && !with_loader_info) {
+        handle->exported_symbols = shared->exports;
+        handle->exports_bloom = shared->bloom;
+        handle->sorted_exports = shared->sorted;
+        handle->export_count = shared->count;
+    } else {
+        // Bibliothèque ordinaire : exports pris dans .dynsym
+        int bound = with_loader_info ? bind_loader_info(handle, entry)
+                                     : collect_dynsym_exports(handle, dynsym_count);
+        if (bound != 0) {
+            discard_handle(handle, mark);
+            return NULL;
+        }
+
+        if (build_exports_bloom(handle) != 0) {
+            debug_warn("Filtre des exports indisponible");
         }
     }
 
-    uint64_t first_addr = load_segments[0].vaddr;
-    uint64_t last_addr_end =
-            load_segments[load_count - 1].vaddr + load_segments[load_count - 1].size;
-    uint64_t total_size = last_addr_end - first_addr;
+    // my_dlbind() sonde l'index .isosidx quand il existe
+    if (!handle->sym_index.map && !handle->sorted_exports && build_sorted_exports(handle) != 0) {
+        discard_handle(handle, mark);
+        return NULL;
+    }
 
-    printf("Load segments found: %d\n", load_count);
-    printf("Total memory size required: %lu bytes\n", total_size);
+    attach_callstats(handle);
+    return (void *)handle;
+}
+
+/*
+ * Espace de base : handles ouverts hors espace de noms, dans l'ordre de
+ * chargement, pour my_dlsym_global(). Seules les racines figurent dans
+ * un espace : une version chargée par my_dlreload() est servie par le
+ * handle d'origine.
+ */
+static lib_namespace_t base_ns = {NULL, NULL, PTHREAD_RWLOCK_INITIALIZER};
+
+static void *publish_handle(lib_namespace_t *ns, lib_handle_t *handle) {
+    if (!handle) {
+        return NULL;
+    }
+    pthread_rwlock_wrlock(&ns->lock);
+    handle->ns = ns;
+    handle->prev_loaded = ns->tail;
+    handle->next_loaded = NULL;
+    if (ns->tail) {
+        ns->tail->next_loaded = handle;
+    } else {
+        ns->head = handle;
+    }
+    ns->tail = handle;
+    pthread_rwlock_unlock(&ns->lock);
+    // Visible de l'espace : ses constructeurs peuvent appeler les autres handles
+    run_constructors(handle);
+    return handle;
+}
 
-    for (int i = 0; i < load_count; i++) {
-        printf("PT_LOAD[%d]: vaddr=0x%lx, size=%lu, flags=%c%c%c\n", i,
-               load_segments[i].vaddr, load_segments[i].size,
-               (load_segments[i].flags & PF_R) ? 'R' : '-',
-               (load_segments[i].flags & PF_W) ? 'W' : '-',
-               (load_segments[i].flags & PF_X) ? 'X' : '-');
+// À appeler sous ns->lock (écriture)
+static void unlink_loaded(lib_namespace_t *ns, lib_handle_t *handle) {
+    if (handle->prev_loaded) {
+        handle->prev_loaded->next_loaded = handle->next_loaded;
+    } else if (ns->head == handle) {
+        ns->head = handle->next_loaded;
     }
+    if (handle->next_loaded) {
+        handle->next_loaded->prev_loaded = handle->prev_loaded;
+    } else if (ns->tail == handle) {
+        ns->tail = handle->prev_loaded;
+    }
+    handle->prev_loaded = NULL;
+    handle->next_loaded = NULL;
+}
 
-    free(load_segments);
-    free(phdrs);
-    close(fd);
-    return 0;
+static void unpublish_handle(lib_handle_t *handle) {
+    lib_namespace_t *ns = handle->ns;
+    if (!ns) {
+        return;
+    }
+    pthread_rwlock_wrlock(&ns->lock);
+    unlink_loaded(ns, handle);
+    pthread_rwlock_unlock(&ns->lock);
 }
 
-void *my_dlopen(const char *library_path) {
-    if (check_elf(library_path) != 0) {
+// Premier handle encore ouvert d'un pack (my_dlpack_destroy())
+static lib_handle_t *first_packed(lib_pack_t *pack) {
+    pthread_rwlock_rdlock(&base_ns.lock);
+    lib_handle_t *lib = base_ns.head;
+    while (lib && lib->pack != pack) {
+        lib = lib->next_loaded;
+    }
+    pthread_rwlock_unlock(&base_ns.lock);
+    return lib;
+}
+
+// Chargement depuis un chemin, sans publication (cf. my_dlreload())
+static lib_handle_t *open_library(const char *library_path, int flags) {
+    // Le fichier est projeté une seule fois ; en-tête et phdrs sont des vues
+    elf_file elf;
+    if (elf_open(library_path, &elf) != 0) {
         debug_warn("Error: not a valid shared library");
         return NULL;
     }
+    return dlopen_elf(&elf, library_path, NULL, flags, NULL);
+}
 
-    // Allocate handle structure
-    lib_handle_t *handle = (lib_handle_t *) malloc(sizeof(lib_handle_t));
+void *my_dlopen(const char *library_path) {
+    return my_dlopen_flags(library_path, 0);
+}
+
+/**
+ * @brief my_dlopen() avec options de chargement.
+ *
+ * @param flags : LOAD_HUGE_TEXT pour placer le texte en pages de 2 Mo
+ *        (hugetlbfs, sinon THP, sinon pages normales ; voir my_dlloadstats()),
+ *        et politique de résidence : LOAD_READAHEAD, LOAD_POPULATE, LOAD_LOCK,
+ *        LOAD_PROFILE (pages du profil .isosprof seulement ; aucune : pages
+ *        chargées au premier accès).
+ */
+void *my_dlopen_flags(const char *library_path, int flags) {
+    return publish_handle(&base_ns, open_library(library_path, flags));
+}
+
+/**
+ * @return le bilan du chargement de la version servie par le handle,
+ *         NULL si le handle est invalide.
+ */
+const load_stats_t *my_dlloadstats(void *handle) {
     if (!handle) {
-        perror("Failed to allocate memory for handle");
+        debug_error("Invalid handle");
+        return NULL;
+    }
+    return &current_version(handle)->load_stats;
+}
+
+/**
+ * @brief Mémoire occupée par l'image d'un handle, segment par segment :
+ *        pages présentes, RSS, PSS, partagées, privées modifiées et swap.
+ *
+ * @return 0 en cas de succès, -1 sinon.
+ */
+int my_dlmeminfo(void *handle, lib_meminfo_t *info) {
+    if (!handle || !info) {
+        debug_error("Invalid handle");
+        return -1;
+    }
+    lib_handle_t *lib = current_version(handle);
+    return meminfo_collect(lib->ranges, lib->range_count, info);
+}
+
+/**
+ * @brief Profil des appels d'imports d'un handle chargé avec
+ *        LOAD_CALLSTATS, cumulé sur tous les threads : un élément par
+ *        import, PLT du loader puis PLT standard.
+ *
+ * @param stats : tableau de max éléments, rempli dans l'ordre des imports.
+ * @return le nombre d'imports (au-delà de max, non remplis), -1 si le
+ *         handle est invalide ou chargé sans profil.
+ */
+int my_dlstats(void *handle, import_stats_t *stats, int max) {
+    if (!handle) {
+        debug_error("Invalid handle");
+        return -1;
+    }
+    lib_handle_t *lib = current_version(handle);
+    callstats_t *cs = lib->callstats;
+    if (!cs) {
+        return -1;
+    }
+    for (int id = 0; stats && id < cs->count && id < max; id++) {
+        callstats_collect(cs, id, &stats[id]);
+        stats[id].name = import_name(lib, id);
+    }
+    return cs->count;
+}
+
+/**
+ * @brief Chronomètre un appel sur period de chaque import, par thread
+ *        (0 : compteurs seuls). Pris en compte au prochain chronométrage.
+ */
+void my_dlstats_sample(unsigned period) {
+    callstats_set_period(period);
+}
+
+/**
+ * @brief Crée un pack pour my_dlopen_packed().
+ *
+ * @param reserve : espace d'adresses réservé aux images, 0 pour
+ *        PACK_DEFAULT_RESERVE.
+ * @return le pack, ou NULL en cas d'échec.
+ */
+void *my_dlpack_create(size_t reserve) {
+    return pack_create(reserve ? reserve : PACK_DEFAULT_RESERVE);
+}
+
+/**
+ * @brief Comme my_dlopen(), mais l'image est posée juste après la
+ *        précédente dans la réservation du pack, et ses métadonnées
+ *        vont dans l'arène du pack.
+ *
+ * my_dlclose() rend les pages de l'image ; le handle lui-même n'est
+ * libéré que par my_dlpack_destroy().
+ *
+ * @return le handle, ou NULL si le chargement échoue ou si le pack est plein.
+ */
+void *my_dlopen_packed(void *pack, const char *library_path) {
+    if (!pack) {
+        debug_error("Invalid pack");
+        return NULL;
+    }
+    elf_file elf;
+    if (elf_open(library_path, &elf) != 0) {
+        debug_warn("Error: not a valid shared library");
+        return NULL;
+    }
+    return publish_handle(&base_ns, dlopen_elf(&elf, library_path, pack, 0, NULL));
+}
+
+/**
+ * @brief Démonte toutes les images d'un pack et libère leurs handles,
+ *        qu'ils aient été fermés par my_dlclose() ou non.
+ *
+ * @return 0 en cas de succès, -1 si le pack est invalide.
+ */
+int my_dlpack_destroy(void *pack) {
+    if (!pack) {
+        debug_error("Invalid pack");
+        return -1;
+    }
+    // Handles encore ouverts : fermés comme par my_dlclose() (destructeurs,
+    // .eh_frame retiré de libgcc, index .isosidx) avant de rendre la réservation
+    lib_handle_t *lib;
+    while ((lib = first_packed(pack))) {
+        my_dlclose(lib);
+    }
+    pack_destroy(pack);
+    return 0;
+}
+
+/**
+ * @brief Charge une bibliothèque depuis un descripteur déjà ouvert
+ *        (fichier, memfd...). Le descripteur reste à l'appelant.
+ */
+void *my_dlopen_fd(int fd) {
+    int own_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (own_fd < 0) {
+        perror("dup failed");
         return NULL;
     }
 
-    // Initialize handle
-    explicit_bzero(handle, sizeof(lib_handle_t));
-    
-    // header
-    elf_header hdr;
-    if (read_elf_header(library_path, &hdr) != 0) {
-        perror("Error reading header");
-        free(handle);
+    elf_file elf;
+    if (elf_open_fd(own_fd, &elf) != 0) {
+        debug_warn("Error: not a valid shared library");
+        elf_close(&elf);
         return NULL;
     }
+    return publish_handle(&base_ns, dlopen_elf(&elf, NULL, NULL, 0, NULL));
+}
 
-    if (check_valid_lib(&hdr) != 0) {
-        perror("Error: not a valid library");
-        free(handle);
+/**
+ * @brief Charge une bibliothèque depuis un tampon (image embarquée,
+ *        fichier tout juste téléchargé...) sans passer par le disque.
+ *
+ * L'image est copiée une seule fois dans un memfd scellé, que
+ * load_library() projette ensuite comme un fichier ordinaire. Le tampon
+ * peut être libéré dès le retour.
+ */
+void *my_dlopen_mem(const void *buf, size_t len) {
+    if (!buf || len == 0) {
+        debug_error("Image vide");
         return NULL;
     }
 
-    int fd = open(library_path, O_RDONLY);
+    int fd = memfd_create("isos-library", MFD_CLOEXEC | MFD_ALLOW_SEALING);
     if (fd < 0) {
-        perror("open failed");
-        free(handle);
+        perror("memfd_create failed");
         return NULL;
     }
-    
-    // declare phdrs
-    elf_phdr *phdrs = NULL;
-    if (read_program_headers(fd, &hdr, &phdrs) != 0) {
-        perror("Failed to read program headers");
-        close(fd);
-        free(handle);
+
+    const char *p = buf;
+    size_t left = len;
+    while (left > 0) {
+        ssize_t n = write(fd, p, left);
+        if (n <= 0) {
+            perror("write to memfd failed");
+            close(fd);
+            return NULL;
+        }
+        p += n;
+        left -= n;
+    }
+
+    // L'image ne peut plus changer une fois validée et projetée
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+        debug_warn("Impossible de sceller le memfd");
+    }
+
+    elf_file elf;
+    if (elf_open_fd(fd, &elf) != 0) {
+        debug_warn("Error: not a valid shared library");
+        elf_close(&elf);
         return NULL;
     }
+    return publish_handle(&base_ns, dlopen_elf(&elf, NULL, NULL, 0, NULL));
+}
 
-    // Modified to store base_addr in the handle
-    void *base_addr = NULL;
-    
-    // check variable hdr phdrs
-    if (load_library(fd, &hdr, phdrs, &base_addr) != 0) {
-        perror("Failed to load library");
-        free(phdrs);
-        close(fd);
-        free(handle);
+// Fin d'un my_dlopen_async(), sur le thread du loader
+static void *finish_async_open(int fd, const char *path, int flags) {
+    elf_file elf;
+    if (elf_open_fd(fd, &elf) != 0) {
+        debug_warn("Error: not a valid shared library");
+        elf_close(&elf);
         return NULL;
     }
-    handle->base_addr = base_addr;
+    return publish_handle(&base_ns, dlopen_elf(&elf, path, NULL, flags, NULL));
+}
 
-    if (validate_load_segments(library_path, &hdr) != 0) {
-        debug_warn("Error: PT_LOAD segment validation failed");
-        free(phdrs);
-        close(fd);
-        free(handle);
+/**
+ * @brief Lance le chargement de library_path sans bloquer l'appelant.
+ *
+ * Ouverture, lecture de l'en-tête et lecture anticipée des segments passent
+ * par l'anneau io_uring du thread du loader (E/S synchrones sur ce thread
+ * si io_uring est indisponible) ; projection et relocations s'y font aussi.
+ *
+ * @param flags : comme pour my_dlopen_flags().
+ * @return la requête, à terminer par my_dlasync_wait(), ou NULL si elle
+ *         n'a pas pu être soumise.
+ */
+void *my_dlopen_async(const char *library_path, int flags) {
+    if (!library_path) {
+        debug_error("Invalid path");
         return NULL;
     }
-    
-    if (!(handle->base_addr && hdr.e_entry != 0)) {
-        debug_warn("Error: Invalid entry point address");
-        free(phdrs);
-        close(fd);
-        free(handle);
+    return async_load_start(library_path, flags, finish_async_open);
+}
+
+// 1 si le chargement est terminé (my_dlasync_wait() ne bloquera pas)
+int my_dlasync_poll(void *req) {
+    return req ? async_load_done(req) : 1;
+}
+
+/**
+ * @return un eventfd qui devient lisible à la fin du chargement (pour
+ *         poll()/epoll), -1 si la requête est invalide. Il est fermé par
+ *         my_dlasync_wait().
+ */
+int my_dlasync_fd(void *req) {
+    return req ? ((dl_async_t *) req)->done_fd : -1;
+}
+
+/**
+ * @brief Attend la fin du chargement et libère la requête.
+ *
+ * @return le handle, ou NULL si le chargement a échoué.
+ */
+void *my_dlasync_wait(void *req) {
+    if (!req) {
+        debug_error("Invalid request");
         return NULL;
     }
+    return async_load_wait(req);
+}
 
-    // Fix alignment issues using uintptr_t for pointer arithmetic
-    uintptr_t info_addr_int = (uintptr_t)base_addr + hdr.e_entry;
-    
-    // Check alignment before casting
-    if (info_addr_int % sizeof(loader_info_t) != 0) {
-        debug_error("Adresse de loader_info mal alignée");
-        free(phdrs);
-        close(fd);
-        free(handle);  // Fix the memory leak here
+/**
+ * @brief Crée un espace de noms isolé (équivalent de dlmopen(LM_ID_NEWLM)).
+ *
+ * @return l'espace, ou NULL en cas d'échec.
+ */
+void *my_dlns_create(void) {
+    lib_namespace_t *ns = calloc(1, sizeof(lib_namespace_t));
+    if (!ns) {
+        perror("Failed to allocate namespace");
         return NULL;
     }
-    
-    // Now it's safe to cast to loader_info_t*
-    loader_info_t* info = (loader_info_t*)info_addr_int;
-    
-    // add tabsymbol to handle
-    handle->imported_symbols = info->imported_symbols;
-    handle->exported_symbols = info->exported_symbols;
-    *(info->loader_handle) = handle;
-    *(info->isos_trampoline) = &isos_trampoline;
+    if (pthread_rwlock_init(&ns->lock, NULL) != 0) {
+        perror("pthread_rwlock_init failed");
+        free(ns);
+        return NULL;
+    }
+    return ns;
+}
 
-    free(phdrs);  // Free the program headers as they're no longer needed
-    close(fd);
+/**
+ * @brief Charge une instance privée de la bibliothèque dans l'espace ns.
+ *
+ * Chaque appel crée une nouvelle instance : données et BSS privées,
+ * relogées pour elle. Texte et données en lecture seule sont projetés
+ * depuis le fichier sans jamais devenir inscriptibles (LOAD_SHARED_TEXT),
+ * et la table d'export d'une bibliothèque ordinaire est partagée : une
+ * instance de plus coûte à peu près ses segments inscriptibles.
+ *
+ * Les imports de la PLT standard sont cherchés dans la table de
+ * my_set_plt_resolve(), puis dans l'espace ns, puis dans le processus ;
+ * my_dlsym_global() ne voit pas les instances de ns.
+ *
+ * @return le handle (à fermer par my_dlclose() ou my_dlns_destroy()), ou
+ *         NULL si le chargement échoue (bibliothèque avec TEXTREL comprise).
+ */
+void *my_dlmopen(void *ns, const char *library_path) {
+    if (!ns) {
+        debug_error("Invalid namespace");
+        return NULL;
+    }
+    elf_file elf;
+    if (elf_open(library_path, &elf) != 0) {
+        debug_warn("Error: not a valid shared library");
+        return NULL;
+    }
+    shared_exports_t *shared = has_loader_info(&elf) ? NULL : shared_exports_get(&elf);
+    return publish_handle(ns, dlopen_elf(&elf, library_path, NULL, LOAD_SHARED_TEXT, shared));
+}
 
-    return (void *)handle;
+/**
+ * @brief Ferme toutes les instances encore ouvertes dans ns, puis l'espace.
+ *
+ * @return 0 en cas de succès, -1 si l'espace est invalide.
+ */
+int my_dlns_destroy(void *ns) {
+    lib_namespace_t *space = ns;
+    if (!space || space == &base_ns) {
+        debug_error("Invalid namespace");
+        return -1;
+    }
+    for (;;) {
+        pthread_rwlock_rdlock(&space->lock);
+        lib_handle_t *lib = space->head;
+        pthread_rwlock_unlock(&space->lock);
+        if (!lib) {
+            break;
+        }
+        my_dlclose(lib);
+    }
+    pthread_rwlock_destroy(&space->lock);
+    free(space);
+    return 0;
 }
 
-void *my_dlsym(void *handle, const char *symbol_name) {
-    // Check that handle is valid
-    if (!handle) {
+// Convertit une adresse de la table d'export en adresse absolue
+static void *export_address(lib_handle_t *lib, void *addr) {
+    if ((uintptr_t) addr < (uintptr_t) lib->base_addr) {
+        // Address is relative to the base
+        return (void *) ((char *) lib->base_addr + (uintptr_t) addr);
+    }
+    // Address is already absolute
+    return addr;
+}
+
+typedef struct {
+    const char *name;
+    size_t index;
+} bind_query;
+
+static int compare_query(const void *a, const void *b) {
+    const bind_query *qa = a;
+    const bind_query *qb = b;
+    return strcmp(qa->name, qb->name);
+}
+
+// Nombre de noms hachés d'avance pendant les recherches dans l'index
+#define BIND_PREFETCH_DISTANCE 8
+// Liste des noms manquants dans le message d'erreur (tronquée au-delà)
+#define BIND_MISSING_LIST_SIZE 256
+
+/**
+ * @brief Signale en une seule erreur les noms que my_dlbind() n'a pas
+ *        trouvés : leur nombre, puis leur liste.
+ *
+ * @return le nombre de noms manquants.
+ */
+static int report_missing(const char *const names[], void *const out[], size_t n) {
+    char list[BIND_MISSING_LIST_SIZE];
+    size_t used = 0;
+    int missing = 0;
+    list[0] = '\0';
+    for (size_t i = 0; i < n; i++) {
+        if (out[i]) {
+            continue;
+        }
+        if (used < sizeof(list)) {
+            used += (size_t) snprintf(list + used, sizeof(list) - used, "%s%s",
+                                      missing ? ", " : "", names[i]);
+        }
+        missing++;
+    }
+    if (missing) {
+        debug_printf(DBG_ERROR, "Symbols not found (%d): %s%s", missing, list,
+                     used >= sizeof(list) ? "..." : "");
+    }
+    return missing;
+}
+
+static void prefetch_slot(lib_handle_t *lib, uint32_t hash) {
+    uint32_t mask = lib->sym_index.hdr->bucket_count - 1;
+    __builtin_prefetch(&lib->sym_index.slots[hash & mask]);
+}
+
+/**
+ * @brief Variante de my_dlbind() avec l'index .isosidx : les slots des
+ *        prochains noms sont préchargés pendant qu'on sonde le courant.
+ */
+static int bind_from_index(lib_handle_t *lib, const char *const names[], void *out[],
+                           size_t n) {
+    uint32_t hashes[BIND_PREFETCH_DISTANCE];
+    for (size_t i = 0; i < n && i < BIND_PREFETCH_DISTANCE; i++) {
+        hashes[i] = isosidx_hash(names[i]);
+        prefetch_slot(lib, hashes[i]);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t hash = hashes[i % BIND_PREFETCH_DISTANCE];
+        if (i + BIND_PREFETCH_DISTANCE < n) {
+            uint32_t next = isosidx_hash(names[i + BIND_PREFETCH_DISTANCE]);
+            hashes[i % BIND_PREFETCH_DISTANCE] = next;
+            prefetch_slot(lib, next);
+        }
+
+        const isosidx_slot *slot = isosidx_probe(&lib->sym_index, names[i], hash);
+        out[i] = slot ? (char *) lib->base_addr + slot->offset : NULL;
+    }
+    return report_missing(names, out, n);
+}
+
+/**
+ * @brief Résout n symboles en une seule passe.
+ *
+ * Avec un index .isosidx, chaque nom coûte une sonde de hachage.
+ * Sinon les noms demandés sont triés puis fusionnés avec l'index trié
+ * des exports : chaque table n'est parcourue qu'une fois, quel que soit n.
+ *
+ * @param handle : le handle retourné par my_dlopen().
+ * @param names  : les noms à résoudre.
+ * @param out    : reçoit l'adresse de chaque nom (NULL si absent).
+ * @param n      : nombre de noms.
+ * @return 0 si tout est résolu, le nombre de noms manquants sinon
+ *         (tous signalés d'un coup), -1 en cas d'erreur.
+ */
+int my_dlbind(void *handle, const char *const names[], void *out[], size_t n) {
+    if (!handle || (n > 0 && (!names || !out))) {
         debug_error("Handle invalide");
-        return NULL;
+        return -1;
+    }
+
+    lib_handle_t *lib = current_version(handle);
+    if (lib->sym_index.map) {
+        return bind_from_index(lib, names, out, n);
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    bind_query *queries = malloc(n * sizeof(bind_query));
+    if (!queries) {
+        perror("malloc failed");
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        queries[i].name = names[i];
+        queries[i].index = i;
+        out[i] = NULL;
+    }
+    qsort(queries, n, sizeof(bind_query), compare_query);
+
+    // Fusion des deux listes triées
+    size_t q = 0;
+    int e = 0;
+    while (q < n && e < lib->export_count) {
+        if (e + 4 < lib->export_count) {
+            __builtin_prefetch(lib->sorted_exports[e + 4].name);
+        }
+        int cmp = strcmp(queries[q].name, lib->sorted_exports[e].name);
+        if (cmp == 0) {
+            out[queries[q].index] = export_address(lib, lib->sorted_exports[e].addr);
+            q++;   // le même export peut servir plusieurs requêtes identiques
+        } else if (cmp > 0) {
+            e++;
+        } else {
+            q++;
+        }
+    }
+    free(queries);
+    return report_missing(names, out, n);
+}
+
+/**
+ * @brief Remplit une structure de pointeurs de fonction en un seul appel.
+ *
+ * @param desc       : un descripteur (nom, offsetof) par champ.
+ * @param out_struct : la structure à remplir.
+ * @return comme my_dlbind().
+ */
+int my_dlbind_struct(void *handle, const my_dlbind_desc *desc, size_t n,
+                     void *out_struct) {
+    if (!out_struct || (n > 0 && !desc)) {
+        debug_error("Descripteur invalide");
+        return -1;
+    }
+    if (n == 0) {
+        return my_dlbind(handle, NULL, NULL, 0);
+    }
+
+    const char **names = malloc(n * sizeof(char *));
+    void **addrs = malloc(n * sizeof(void *));
+    if (!names || !addrs) {
+        perror("malloc failed");
+        free(names);
+        free(addrs);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        names[i] = desc[i].name;
+    }
+
+    int ret = my_dlbind(handle, names, addrs, n);
+    if (ret >= 0) {
+        for (size_t i = 0; i < n; i++) {
+            memcpy((char *) out_struct + desc[i].offset, &addrs[i], sizeof(void *));
+        }
+    }
+
+    free(names);
+    free(addrs);
+    return ret;
+}
+
+// Recherche d'un export dans une version ; hash n'est utile qu'avec l'index
+static void *lookup_export(lib_handle_t *lib, const char *symbol_name, uint32_t hash) {
+    // Index précalculé : une seule sonde dans la table de hachage
+    if (lib->sym_index.map) {
+        const isosidx_slot *slot = isosidx_probe(&lib->sym_index, symbol_name, hash);
+        return slot ? (char *) lib->base_addr + slot->offset : NULL;
     }
 
-    // Cast to your library handle type
-    lib_handle_t *lib = (lib_handle_t *) handle;
     // If loader_info exists and has an exported symbols table
     if (lib->exported_symbols) {
         // Look for the symbol in the exported symbols table
@@ -271,14 +1366,7 @@ void *my_dlsym(void *handle, const char *symbol_name) {
         for (int i = 0; table[i].name != NULL; i++) {
             if (strcmp(table[i].name, symbol_name) == 0) {
                 // Found the symbol!
-                // Check if the address is relative or absolute
-                if ((uintptr_t) table[i].addr < (uintptr_t) lib->base_addr) {
-                    // Address is relative to the base
-                    return (void *) ((char *) lib->base_addr + (uintptr_t) table[i].addr);
-                } else {
-                    // Address is already absolute
-                    return table[i].addr;
-                }
+                return export_address(lib, table[i].addr);
             }
         }
     }
@@ -287,6 +1375,70 @@ void *my_dlsym(void *handle, const char *symbol_name) {
     return NULL;
 }
 
+void *my_dlsym(void *handle, const char *symbol_name) {
+    // Check that handle is valid
+    if (!handle) {
+        debug_error("Handle invalide");
+        return NULL;
+    }
+
+    // Cast to your library handle type
+    lib_handle_t *lib = current_version(handle);
+    uint32_t hash = lib->sym_index.map ? isosidx_hash(symbol_name) : 0;
+    return lookup_export(lib, symbol_name, hash);
+}
+
+// Premier handle de ns, dans l'ordre de chargement, qui exporte symbol_name
+static void *namespace_lookup(lib_namespace_t *ns, const char *symbol_name, void **owner) {
+    if (owner) {
+        *owner = NULL;
+    }
+    if (!symbol_name) {
+        return NULL;
+    }
+    uint32_t hash = isosidx_hash(symbol_name);
+    void *addr = NULL;
+
+    pthread_rwlock_rdlock(&ns->lock);
+    for (lib_handle_t *root = ns->head; root && !addr; root = root->next_loaded) {
+        lib_handle_t *lib = current_version(root);
+        if (!lib->base_addr || !bloom_maybe(&lib->exports_bloom, hash)) {
+            continue;
+        }
+        addr = lookup_export(lib, symbol_name, hash);
+        if (addr && owner) {
+            *owner = root;
+        }
+    }
+    pthread_rwlock_unlock(&ns->lock);
+    return addr;
+}
+
+/**
+ * @brief Recherche globale (équivalent de dlsym(RTLD_DEFAULT, ...)) :
+ *        premier handle ouvert, dans l'ordre de chargement, qui exporte
+ *        symbol_name. Le nom est haché une seule fois ; le filtre de
+ *        Bloom de chaque handle écarte sans toucher à ses tables ceux
+ *        qui ne l'exportent pas. Les espaces de my_dlns_create() sont
+ *        exclus.
+ *
+ * @param owner : reçoit le handle qui fournit le symbole (peut être NULL).
+ * @return l'adresse du symbole, ou NULL s'il n'est exporté par aucun handle.
+ */
+void *my_dlsym_global(const char *symbol_name, void **owner) {
+    return namespace_lookup(&base_ns, symbol_name, owner);
+}
+
+/**
+ * @brief Comme my_dlsym_global(), restreint aux instances d'un espace.
+ *
+ * @param ns : l'espace retourné par my_dlns_create(), NULL pour l'espace
+ *        de base.
+ */
+void *my_dlsym_ns(void *ns, const char *symbol_name, void **owner) {
+    return namespace_lookup(ns ? ns : &base_ns, symbol_name, owner);
+}
+
 /*void* my_dlsym(void* handle, const char* symbol_name) {
     // On vérifie juste que le handle est valide (non NULL)
     if (!handle) {
@@ -336,13 +1488,170 @@ déjà été effectuée) return table[i].addr;
     return NULL;
 }
 */
+/**
+ * @brief Décharge une bibliothèque ouverte par my_dlopen().
+ *
+ * L'image et toutes les métadonnées du handle (arène) sont libérées en
+ * une fois : le handle et les adresses obtenues deviennent invalides.
+ *
+ * @return 0 en cas de succès, -1 si le handle est invalide.
+ */
+int my_dlclose(void *handle) {
+    if (!handle) {
+        debug_error("Invalid handle");
+        return -1;
+    }
+    lib_handle_t *root = (lib_handle_t *) handle;
+    lib_handle_t *current = root->current;
+
+    unpublish_handle(root);
+    // Versions encore en période de grâce, image d'origine comprise
+    epoch_flush(root);
+    if (current) {
+        release_handle(current);
+    }
+    release_handle(root);
+    return 0;
+}
+
+/**
+ * @brief Liaison immédiate (équivalent de RTLD_NOW) : résout tous les
+ *        imports du handle et remplit ses slots PLT (PLT du loader et
+ *        slots JUMP_SLOT d'une PLT standard).
+ *
+ * À appeler après my_set_plt_resolve(). Utile avant un fork() : les
+ * processus fils héritent des slots déjà liés.
+ *
+ * @return le nombre d'imports non résolus, -1 si le handle est invalide.
+ */
+int my_dlprebind(void *handle) {
+    if (!handle) {
+        debug_error("Invalid handle");
+        return -1;
+    }
+    lib_handle_t *lib = current_version(handle);
+
+    int missing = 0;
+    for (int id = 0; id < lib->plt_bound_count; id++) {
+        if (!loader_plt_bind(lib, id)) {
+            missing++;
+        }
+    }
+    // PLT standard : chaque slot paresseux est lié tout de suite
+    for (int i = 0; lib->plt_stubs && i < lib->jmprel_count; i++) {
+        if (lib->plt_stubs[i] && !loader_jmprel_bind(lib, i)) {
+            missing++;
+        }
+    }
+    return missing;
+}
+
 int my_set_plt_resolve(void *handle, void *resolve_table) {
     if (!handle) {
         debug_error("Invalid handle");
         return -1;
     }
-    lib_handle_t *lib_handle = (lib_handle_t *) handle;
+    lib_handle_t *lib_handle = current_version(handle);
 
     lib_handle->plt_resolve_table = resolve_table;
+    ((lib_handle_t *) handle)->plt_resolve_table = resolve_table;
+
+    // La table change : les liaisons déjà faites ne sont plus valides
+    for (int i = 0; i < lib_handle->plt_bound_count; i++) {
+        __atomic_store_n(&lib_handle->plt_bound[i], NULL, __ATOMIC_RELEASE);
+    }
+    // Slots de la PLT standard : retour à leur entrée PLT (liaison au prochain appel)
+    for (int i = 0; lib_handle->plt_stubs && i < lib_handle->jmprel_count; i++) {
+        if (lib_handle->plt_stubs[i]) {
+            uint64_t *slot =
+                    (uint64_t *) ((char *) lib_handle->base_addr + lib_handle->jmprel[i].r_offset);
+            __atomic_store_n(slot, lib_handle->plt_stubs[i], __ATOMIC_RELEASE);
+        }
+    }
+    // Image liée dès le chargement : elle le reste avec la nouvelle table
+    if (lib_handle->bind_now) {
+        my_dlprebind(lib_handle);
+    }
+    return 0;
+}
+
+// Nom de l'import id de la PLT du loader (table imported_symbols)
+const char *my_dlimport_name(void *handle, int id) {
+    if (!handle) {
+        debug_error("Invalid handle");
+        return NULL;
+    }
+    lib_handle_t *lib = current_version(handle);
+    return id >= 0 && id < lib->plt_bound_count ? lib->imported_symbols[id] : NULL;
+}
+
+/**
+ * @brief Remplace à chaud la bibliothèque d'un handle par new_path.
+ *
+ * La nouvelle version est chargée, relogée et entièrement liée à côté de
+ * l'ancienne, puis publiée par une seule écriture atomique : symboles,
+ * index et slots PLT basculent ensemble pour les appels suivants.
+ * L'ancienne image n'est démontée qu'après une période de grâce
+ * (epoch_reclaim()) ; ni les appelants ni le rechargement n'attendent.
+ *
+ * @param handle   : le handle retourné par my_dlopen(), qui reste valide.
+ * @param new_path : la nouvelle version de la bibliothèque.
+ * @return 0 en cas de succès, -1 si la nouvelle version ne peut être
+ *         chargée (l'ancienne reste alors servie).
+ */
+int my_dlreload(void *handle, const char *new_path) {
+    if (!handle || !new_path) {
+        debug_error("Invalid handle");
+        return -1;
+    }
+    lib_handle_t *root = (lib_handle_t *) handle;
+
+    lib_handle_t *next = open_library(new_path, root->load_flags);
+    if (!next) {
+        debug_warn("Reload failed, keeping the current version");
+        return -1;
+    }
+
+    // Mêmes imports que la version d'origine, cherchés dans le même espace
+    next->ns = root->ns;
+
+    // Liaison immédiate : aucun appel ne passera par le résolveur après la bascule
+    next->plt_resolve_table = root->plt_resolve_table;
+    if (next->plt_resolve_table && my_dlprebind(next) != 0) {
+        debug_warn("Some imports of the new version are unresolved");
+    }
+    run_constructors(next);
+
+    lib_handle_t *old = __atomic_load_n(&root->current, __ATOMIC_SEQ_CST);
+    while (!__atomic_compare_exchange_n(&root->current, &old, next, 0, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_SEQ_CST)) {
+    }
+
+    int ret = old ? epoch_retire(retire_version, old, root)
+                  : epoch_retire(retire_root_image, root, root);
+    if (ret != 0) {
+        debug_warn("Previous version will never be unmapped");
+    }
+    epoch_reclaim();
     return 0;
 }
+
+/*
+ * Noms publics (préfixe my_dl) des services internes : les modules
+ * gardent leurs noms, que libisosloader ne rend pas visibles.
+ */
+int my_dlepoch_enter(void) {
+    return epoch_enter();
+}
+
+void my_dlepoch_leave(void) {
+    epoch_leave();
+}
+
+int my_dlintegrity_write(const char *library_path) {
+    return integrity_write(library_path);
+}
+
+void my_dldebug_init(int level) {
+    debug_init(level);
+}
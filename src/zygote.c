@@ -0,0 +1,253 @@
+#define _GNU_SOURCE
+#include "zygote.h"
+#include "dynloader.h"
+#include "debug.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+static volatile sig_atomic_t g_zygote_stop = 0;
+
+static void zygote_on_signal(int sig) {
+    (void) sig;
+    g_zygote_stop = 1;
+}
+
+static int fill_address(struct sockaddr_un *addr, const char *socket_path) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr->sun_path)) {
+        debug_error("Chemin de socket trop long");
+        return -1;
+    }
+    strcpy(addr->sun_path, socket_path);
+    return 0;
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+// Lit jusqu'à la fin de ligne ou de flux ; la chaîne est terminée par '\0'
+static ssize_t read_line(int fd, char *buf, size_t size) {
+    size_t len = 0;
+    while (len + 1 < size) {
+        ssize_t n = read(fd, buf + len, size - 1 - len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        len += n;
+        if (memchr(buf + len - n, '\n', n)) {
+            break;
+        }
+    }
+    buf[len] = '\0';
+    buf[strcspn(buf, "\r\n")] = '\0';
+    return len;
+}
+
+// Exécuté dans le fils : une requête, une réponse
+static void zygote_worker(int conn, char **lib_paths, void **handles, int count) {
+    char request[ZYGOTE_MAX_REQUEST];
+    char reply[ZYGOTE_MAX_REQUEST + 64];
+
+    read_line(conn, request, sizeof(request));
+    char *func_name = strchr(request, ' ');
+    if (!func_name) {
+        snprintf(reply, sizeof(reply), "ERR malformed request\n");
+    } else {
+        *func_name++ = '\0';
+        void *handle = NULL;
+        for (int i = 0; i < count; i++) {
+            if (strcmp(lib_paths[i], request) == 0) {
+                handle = handles[i];
+                break;
+            }
+        }
+
+        void *func_addr = handle ? my_dlsym(handle, func_name) : NULL;
+        if (!handle) {
+            snprintf(reply, sizeof(reply), "ERR library not served: %s\n", request);
+        } else if (!func_addr) {
+            snprintf(reply, sizeof(reply), "ERR function not found: %s\n", func_name);
+        } else {
+            const char *(*func_ptr)() = (const char *(*)()) func_addr;
+            const char *result = func_ptr();
+            snprintf(reply, sizeof(reply), "%s\n", result ? result : "(null)");
+        }
+    }
+    write_all(conn, reply, strlen(reply));
+}
+
+/*
+ * Socket d'écoute publiée sur socket_path : liée et mise en écoute sous
+ * un nom temporaire, puis renommée. Dès que socket_path existe, connect()
+ * réussit.
+ */
+static int zygote_listen(const char *socket_path) {
+    char tmp_path[sizeof(((struct sockaddr_un *) 0)->sun_path)];
+    int len = snprintf(tmp_path, sizeof(tmp_path), "%s.%d", socket_path, (int) getpid());
+    if (len < 0 || (size_t) len >= sizeof(tmp_path)) {
+        debug_error("Chemin de socket trop long");
+        return -1;
+    }
+    struct sockaddr_un addr;
+    fill_address(&addr, tmp_path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        perror("socket failed");
+        return -1;
+    }
+    unlink(tmp_path);
+    // Droits fixés dès la création : pas de fenêtre où la socket serait
+    // joignable par d'autres utilisateurs
+    mode_t old_umask = umask(0077);
+    int bound = bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr));
+    umask(old_umask);
+    if (bound != 0) {
+        perror("bind failed");
+        close(listen_fd);
+        return -1;
+    }
+    if (chmod(tmp_path, 0600) != 0 || listen(listen_fd, SOMAXCONN) != 0 ||
+        rename(tmp_path, socket_path) != 0) {
+        perror("listen failed");
+        unlink(tmp_path);
+        close(listen_fd);
+        return -1;
+    }
+    return listen_fd;
+}
+
+/**
+ * @brief Sert les requêtes sur socket_path jusqu'à SIGINT/SIGTERM.
+ *
+ * Les handles doivent être chargés et liés (my_dlprebind()) : chaque
+ * fils en hérite tels quels et n'a plus qu'à appeler la fonction.
+ *
+ * La socket est créée en 0600 : seul l'utilisateur du serveur peut faire
+ * exécuter les fonctions servies. Elle n'apparaît sur socket_path qu'en
+ * écoute, gestionnaires de signaux déjà installés : un client qui la
+ * voit peut s'y connecter, ou arrêter le serveur. Les gestionnaires de
+ * SIGINT, SIGTERM et SIGCHLD de l'appelant sont rétablis au retour.
+ *
+ * @return 0 à l'arrêt normal, -1 en cas d'erreur de socket.
+ */
+int zygote_serve(const char *socket_path, char **lib_paths, void **handles, int count) {
+    struct sockaddr_un addr;
+    if (fill_address(&addr, socket_path) != 0) {
+        return -1;
+    }
+
+    // Les fils sont récoltés automatiquement ; accept() est interrompu
+    // par SIGINT/SIGTERM (pas de SA_RESTART)
+    struct sigaction sa, old_int, old_term, old_chld;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = zygote_on_signal;
+    g_zygote_stop = 0;
+    sigaction(SIGINT, &sa, &old_int);
+    sigaction(SIGTERM, &sa, &old_term);
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGCHLD, &sa, &old_chld);
+
+    int listen_fd = zygote_listen(socket_path);
+    if (listen_fd < 0) {
+        sigaction(SIGCHLD, &old_chld, NULL);
+        sigaction(SIGTERM, &old_term, NULL);
+        sigaction(SIGINT, &old_int, NULL);
+        return -1;
+    }
+
+    debug_printf(DBG_INFO, "Zygote prêt sur %s (%d bibliothèque(s))", socket_path, count);
+    fflush(stdout);
+
+    while (!g_zygote_stop) {
+        int conn = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (conn < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("accept failed");
+            break;
+        }
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(listen_fd);
+            zygote_worker(conn, lib_paths, handles, count);
+            close(conn);
+            _exit(0);
+        }
+        if (pid < 0) {
+            perror("fork failed");
+            write_all(conn, "ERR fork failed\n", 16);
+        }
+        close(conn);
+    }
+
+    close(listen_fd);
+    unlink(socket_path);
+    sigaction(SIGCHLD, &old_chld, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    sigaction(SIGINT, &old_int, NULL);
+    return 0;
+}
+
+/**
+ * @brief Envoie une requête au zygote et lit la réponse (sans '\n').
+ *
+ * @return 0 si l'appel a réussi, 1 si le serveur a répondu ERR,
+ *         -1 en cas d'erreur de communication.
+ */
+int zygote_request(const char *socket_path, const char *lib_path, const char *func_name,
+                   char *reply, size_t reply_size) {
+    struct sockaddr_un addr;
+    if (fill_address(&addr, socket_path) != 0) {
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket failed");
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+        perror("connect failed");
+        close(fd);
+        return -1;
+    }
+
+    char request[ZYGOTE_MAX_REQUEST];
+    int len = snprintf(request, sizeof(request), "%s %s\n", lib_path, func_name);
+    if (len < 0 || (size_t) len >= sizeof(request) || write_all(fd, request, len) != 0) {
+        debug_error("Requête trop longue ou écriture impossible");
+        close(fd);
+        return -1;
+    }
+    shutdown(fd, SHUT_WR);
+
+    read_line(fd, reply, reply_size);
+    close(fd);
+    return strncmp(reply, "ERR ", 4) == 0 ? 1 : 0;
+}
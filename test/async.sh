@@ -0,0 +1,110 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Async Load Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+make bench/lib/libplain.so bench/lib/libbigtext.so bench/bench_async > /dev/null
+
+# Chargement sur le thread du loader, puis appels comme d'habitude
+run_test "Async load" "./isos_loader -A ./libmylib.so foo bar" "Recherche de la fonction bar"
+run_test "Async load with residency policy" "./isos_loader -A -P populate ./libmylib.so foo" "préchargés"
+run_test "Async load of a standard library" "./isos_loader -A bench/lib/libplain.so plain_counter" "counter = 1"
+
+# Les erreurs remontent par my_dlasync_wait()
+run_test "Missing library" "./isos_loader -A $WORK_DIR/missing.so foo; test \$? -ne 0" "open failed"
+echo "not an elf" > "$WORK_DIR/bogus.so"
+run_test "Not an ELF file" "./isos_loader -A $WORK_DIR/bogus.so foo; test \$? -ne 0" "Not an ELF file"
+
+# Appels système io_uring refusés à la demande (FAIL_SYSCALL à partir
+# du FAIL_AFTER-ième appel), pour les replis du thread du loader
+cat > "$WORK_DIR/failsys.c" <<'SHIM'
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+long syscall(long nr, ...) {
+    static long (*next)(long, ...);
+    static int calls;
+    long a[6];
+    va_list ap;
+    va_start(ap, nr);
+    for (int i = 0; i < 6; i++) {
+        a[i] = va_arg(ap, long);
+    }
+    va_end(ap);
+    const char *fail = getenv("FAIL_SYSCALL");
+    const char *after = getenv("FAIL_AFTER");
+    if (fail && nr == atol(fail) && ++calls >= (after ? atoi(after) : 1)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!next) {
+        next = (long (*)(long, ...)) dlsym(RTLD_NEXT, "syscall");
+    }
+    return next(nr, a[0], a[1], a[2], a[3], a[4], a[5]);
+}
+SHIM
+gcc -shared -fPIC -o "$WORK_DIR/libfailsys.so" "$WORK_DIR/failsys.c" -ldl
+FAILSYS="LD_PRELOAD=$WORK_DIR/libfailsys.so"
+
+# Sondage IORING_REGISTER_PROBE refusé : E/S synchrones dès le départ
+run_test "Opcode probe fails: sync worker" \
+         "$FAILSYS FAIL_SYSCALL=427 ./isos_loader -d 2 -A ./libmylib.so foo bar" \
+         "io_uring indisponible"
+
+# io_uring_enter échoue avant toute soumission : repli sans perte
+run_test "io_uring_enter fails at once: sync fallback" \
+         "$FAILSYS FAIL_SYSCALL=426 ./isos_loader -d 2 -A ./libmylib.so foo bar" \
+         "Anneau io_uring abandonné"
+
+# Échec pendant la soumission de l'ouverture : la requête en vol échoue
+# au lieu de laisser le thread du loader tourner en boucle
+run_test "io_uring_enter fails with a request in flight" \
+         "$FAILSYS FAIL_SYSCALL=426 FAIL_AFTER=2 timeout 10 ./isos_loader -A ./libmylib.so foo; test \$? -ne 0 -a \$? -ne 124" \
+         "io_uring_enter failed: Invalid argument"
+
+run_test "Async bench" "./bench/bench_async 2 ./libmylib.so bench/lib/libplain.so bench/lib/libbigtext.so" "my_dlopen_async"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
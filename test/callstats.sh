@@ -0,0 +1,169 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Import Call Statistics Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+
+make bench/lib/libplain.so libisosloader.so > /dev/null
+if [ ! -f "bench/lib/libplain.so" ] || [ ! -f "libisosloader.so" ]; then
+    echo -e "${RED}Build failed! libplain.so or libisosloader.so is missing.${NC}"
+    exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Test 1: loader PLT imports counted per sym_id
+run_test "Loader PLT calls counted" \
+         "./isos_loader --stats libmylib.so foo_imported bar_imported foo_imported" \
+         "new_foo                           2 appels"
+
+# Test 2: every call timed with a period of 1
+run_test "Every call sampled" \
+         "./isos_loader --stats=1 libmylib.so foo_imported foo_imported" \
+         "(2 mesures)"
+
+# Test 3: counts only
+run_test "Counts without sampling" \
+         "./isos_loader --stats=0 libmylib.so bar_imported | grep -A3 'Appels des imports' | grep -v mesures" \
+         "new_bar                           1 appels"
+
+# Test 4: standard PLT (GOT slots) imports, host and libc
+run_test "Standard PLT calls counted" \
+         "./isos_loader --stats ./bench/lib/libplain.so plain_hello plain_length plain_hello" \
+         "snprintf                          3 appels"
+
+# Test 5: arguments and return values go through the stub untouched
+run_test "Arguments preserved through the stub" \
+         "./isos_loader --stats=1 libmylib.so args_imported" \
+         "Hello from new_args(1, 2, 3, 4, 5, 6, 7.5)"
+
+# Test 6: throughput mode through the trampoline
+run_test "Counts in repeat mode" \
+         "./isos_loader --stats -r 1000 libmylib.so foo_imported" \
+         "Appels des imports"
+
+# Test 7: no report without --stats
+run_test "No report by default" \
+         "! ./isos_loader libmylib.so foo_imported | grep -q 'Appels des imports'" \
+         ""
+
+# Test 8: invalid period
+run_test "Invalid sample period rejected" \
+         "./isos_loader --stats=-1 libmylib.so foo_imported; test \$? -ne 0" \
+         "invalid sample period"
+
+# Test 9: per-thread counters summed by my_dlstats(), through libisosloader.so
+cat > "$WORK_DIR/threads.c" <<'HOST'
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "isosloader.h"
+
+#define THREADS 4
+#define CALLS 100000
+
+long plain_hook(long x) { return x; }
+
+static long (*call)(long);
+
+static void *worker(void *arg) {
+    (void) arg;
+    for (long i = 0; i < CALLS; i++) {
+        call(i);
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    (void) argc;
+    my_dldebug_init(0);
+    my_dlstats_sample(16);
+    void *lib = my_dlopen_flags(argv[1], LOAD_CALLSTATS);
+    if (!lib) {
+        return 1;
+    }
+    *(void **) &call = my_dlsym(lib, "plain_call");
+    pthread_t tids[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        pthread_create(&tids[t], NULL, worker, NULL);
+    }
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(tids[t], NULL);
+    }
+    import_stats_t stats[8];
+    int count = my_dlstats(lib, stats, 8);
+    for (int i = 0; i < count && i < 8; i++) {
+        if (strcmp(stats[i].name, "plain_hook") == 0) {
+            printf("plain_hook: %lu calls, %s\n", (unsigned long) stats[i].calls,
+                   stats[i].samples > 0 ? "sampled" : "not sampled");
+        }
+    }
+    my_dlclose(lib);
+    return 0;
+}
+HOST
+run_test "Per-thread counters summed" \
+         "gcc -Wall -Wextra -Werror -I./include -rdynamic -o $WORK_DIR/threads $WORK_DIR/threads.c -L. -lisosloader -Wl,-rpath,$PWD -pthread && $WORK_DIR/threads ./bench/lib/libplain.so" \
+         "plain_hook: 400000 calls, sampled"
+
+# Test 10: setjmp returns twice through its stub, so it is counted but never timed
+cat > "$WORK_DIR/jumps.c" <<'LIB'
+#include <setjmp.h>
+#include <stdio.h>
+
+static char buffer[64];
+
+const char *jump_back(void) {
+    jmp_buf env;
+    volatile int returns = 0;
+    if (setjmp(env) < 3) {
+        returns++;
+        longjmp(env, returns);
+    }
+    snprintf(buffer, sizeof(buffer), "setjmp returned %d times", returns + 1);
+    return buffer;
+}
+LIB
+run_test "setjmp through a profiled import" \
+         "gcc -shared -fPIC -O1 -o $WORK_DIR/libjumps.so $WORK_DIR/jumps.c && ./isos_loader --stats=1 $WORK_DIR/libjumps.so jump_back jump_back" \
+         "setjmp returned 4 times"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
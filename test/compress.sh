@@ -0,0 +1,73 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Compressed Container Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+make bench/lib/libplain.so bench/lib/libbigtext.so bench/bench_compress > /dev/null
+
+run_test "Compress library" "./isos_loader -z $WORK_DIR/libmylib.isosz ./libmylib.so" "blocs"
+run_test "Load compressed library" "./isos_loader $WORK_DIR/libmylib.isosz foo bar" "Recherche de la fonction bar"
+
+# Relocations et PLT standard sur une image décompressée
+./isos_loader -z "$WORK_DIR/libplain.isosz" bench/lib/libplain.so > /dev/null
+run_test "Compressed standard library" "./isos_loader $WORK_DIR/libplain.isosz plain_counter plain_counter" "counter = 2"
+run_test "Compressed library in namespaces" "./isos_loader -n 2 $WORK_DIR/libplain.isosz plain_counter" "== Espace 1 =="
+run_test "Compressed library, async load" "./isos_loader -A $WORK_DIR/libplain.isosz plain_counter" "counter = 1"
+
+# Texte de 16 Mo : 64 blocs décompressés en parallèle, en grandes pages si possible
+./isos_loader -z "$WORK_DIR/libbigtext.isosz" bench/lib/libbigtext.so > /dev/null
+run_test "Compressed large text" "./isos_loader -H $WORK_DIR/libbigtext.isosz fn_1000 fn_1777" "fn_1777() => Adresse"
+
+run_test "Container is not compressed again" "./isos_loader -z $WORK_DIR/again.isosz $WORK_DIR/libplain.isosz; test \$? -ne 0" "déjà compressé"
+
+# Conteneurs abîmés : refusés, jamais chargés
+head -c 100 "$WORK_DIR/libplain.isosz" > "$WORK_DIR/truncated.isosz"
+run_test "Truncated container" "./isos_loader -d 1 $WORK_DIR/truncated.isosz plain_counter; test \$? -ne 0" "Conteneur compressé"
+cp "$WORK_DIR/libplain.isosz" "$WORK_DIR/corrupt.isosz"
+size=$(stat -c %s "$WORK_DIR/corrupt.isosz")
+printf '\xff\xff\xff\xff\xff\xff\xff\xff' | dd of="$WORK_DIR/corrupt.isosz" bs=1 seek=$((size - 600)) conv=notrunc 2> /dev/null
+run_test "Corrupted container" "./isos_loader -d 1 $WORK_DIR/corrupt.isosz plain_counter; test \$? -ne 0" "Conteneur compressé corrompu"
+
+run_test "Compression bench" "./bench/bench_compress bench/lib/libplain.so 2" "compressed cold"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,146 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Batch Symbol Binding Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+# Test 1: several functions bound in one call
+run_test "All functions bound" \
+         "./isos_loader ./libmylib.so foo_exported bar_exported foo_exported" \
+         "Hello from bar_exported()"
+
+# Test 2: every missing name is reported at once, as one error
+run_test "Missing names reported together" \
+         "./isos_loader -d 1 ./libmylib.so missing_one foo_exported missing_two" \
+         "Symbols not found (2): missing_one, missing_two"
+
+run_test "Existing names still called when others are missing" \
+         "./isos_loader -d 2 ./libmylib.so missing_one foo_exported missing_two" \
+         "Hello from foo_exported()"
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Nom exporté deux fois, au milieu d'autres : le tri ne doit pas changer
+# lequel gagne
+cat > "$WORK_DIR/dup.c" <<'LIB'
+#include <stddef.h>
+#include "loader.h"
+
+void *loader_handle = NULL;
+void *isos_trampoline = NULL;
+
+static const char *first(void) { return "Hello from the first dup"; }
+static const char *second(void) { return "Hello from the second dup"; }
+static const char *other(void) { return "Hello from other"; }
+
+const char *imported_symbols[] = {NULL};
+
+symbol_entry exported_symbols[] = {
+    {"m", (void *) other}, {"dup", (void *) first}, {"z", (void *) other},
+    {"a", (void *) other}, {"q", (void *) other},   {"dup", (void *) second},
+    {"b", (void *) other}, {"dup", (void *) second}, {"c", (void *) other},
+    {NULL, NULL}
+};
+
+loader_info_t loader_info = {
+    .exported_symbols = exported_symbols,
+    .imported_symbols = imported_symbols,
+    .loader_handle = &loader_handle,
+    .isos_trampoline = &isos_trampoline
+};
+LIB
+
+# Test 3: duplicate exports resolve to the first entry, like my_dlsym()
+run_test "Duplicate export: first entry wins" \
+         "gcc -shared -fPIC -I ./include $WORK_DIR/dup.c --entry loader_info -o $WORK_DIR/libdup.so -fvisibility=hidden && ./isos_loader $WORK_DIR/libdup.so dup" \
+         "Hello from the first dup"
+
+# Plusieurs threads lient en même temps sur un handle tout juste ouvert
+cat > "$WORK_DIR/threads.c" <<'HOST'
+#include <pthread.h>
+#include <stdio.h>
+#include "dynloader.h"
+#include "debug.h"
+
+#define THREADS 8
+
+static void *lib;
+static int wrong;
+
+static void *bind_all(void *arg) {
+    static const char *const names[] = {"foo_exported", "bar_exported", "kernel_caller"};
+    void *out[3];
+    (void) arg;
+    for (int i = 0; i < 1000; i++) {
+        if (my_dlbind(lib, names, out, 3) != 0 || out[0] != my_dlsym(lib, "foo_exported")) {
+            __atomic_add_fetch(&wrong, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    debug_init(DBG_NONE);
+    lib = argc > 1 ? my_dlopen(argv[1]) : NULL;
+    if (!lib) {
+        return 1;
+    }
+    // L'index trié est prêt avant que le handle soit rendu
+    int sorted = ((lib_handle_t *) lib)->sorted_exports != NULL;
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        pthread_create(&threads[i], NULL, bind_all, NULL);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    printf("index %s at open, %d wrong binds\n", sorted ? "built" : "missing", wrong);
+    my_dlclose(lib);
+    return 0;
+}
+HOST
+
+# Test 4: the sorted index is built at open time, concurrent binds agree
+CORE_OBJS=$(ls obj/*.o | grep -v -e obj/main.o -e obj/mylib.o -e obj/isosloader.o | tr "\n" " ")
+run_test "Concurrent binds on a fresh handle" \
+         "gcc -Wall -Wextra -Werror -I./include -rdynamic -o $WORK_DIR/threads $WORK_DIR/threads.c $CORE_OBJS -pthread && $WORK_DIR/threads ./libmylib.so" \
+         "index built at open, 0 wrong binds"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
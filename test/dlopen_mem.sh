@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Load From Memory Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+# Test 1: image read from a file into memory
+run_test "my_dlopen_mem from a buffer" \
+         "./isos_loader --from-memory ./libmylib.so foo_imported" \
+         "Hello from new_foo()"
+
+# Test 2: image streamed on stdin (stand-in for a download)
+run_test "my_dlopen_mem from stdin" \
+         "cat ./libmylib.so | ./isos_loader -m - args_imported kernel_caller" \
+         "Hello from new_args(1, 2, 3, 4, 5, 6, 7.5)"
+
+# Test 3: invalid buffer is rejected (the loader must exit with an error)
+run_test "Non-ELF buffer" \
+         "echo 'not an elf' | ./isos_loader -m - foo_exported; test \$? -ne 0" \
+         "Not an ELF file"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,162 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== C++ Exception Unwinding Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+
+make bench/lib/libehthrow.so bench/lib/libehcatch.so libisosloader.a libisosloader.so > /dev/null
+if [ ! -f "bench/lib/libehthrow.so" ] || [ ! -f "bench/lib/libehcatch.so" ]; then
+    echo -e "${RED}Build failed! libehthrow.so or libehcatch.so is missing.${NC}"
+    exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Hôte C : libehthrow.so lance, libehcatch.so rattrape, toutes deux chargées par le loader
+cat > "$WORK_DIR/host.c" <<'HOST'
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "isosloader.h"
+
+typedef long (*eh_catch_fn)(long, long, long *);
+
+int main(int argc, char **argv) {
+    int cycles = argc > 1 ? atoi(argv[1]) : 1;
+    my_dldebug_init(argc > 2 ? atoi(argv[2]) : 0);
+    if (!dlopen("libstdc++.so.6", RTLD_NOW | RTLD_GLOBAL)) {
+        return 1;
+    }
+    for (int c = 0; c < cycles; c++) {
+        void *thrower = my_dlopen("./bench/lib/libehthrow.so");
+        void *catcher = thrower ? my_dlopen("./bench/lib/libehcatch.so") : NULL;
+        eh_catch_fn fn = NULL;
+        if (catcher) {
+            *(void **) &fn = my_dlsym(catcher, "eh_catch");
+        }
+        if (!fn) {
+            return 1;
+        }
+        long unwound = 0;
+        long code = fn(8, 42 + c, &unwound);
+        if (code != 42 + c || unwound != 9) {
+            printf("cycle %d: caught %ld, %ld frames unwound\n", c, code, unwound);
+            return 1;
+        }
+        my_dlclose(catcher);
+        my_dlclose(thrower);
+    }
+    printf("caught 42, 9 frames unwound, %d cycle(s)\n", cycles);
+    return 0;
+}
+HOST
+
+# Test 1: exception thrown in one loaded image and caught in another
+run_test "Exception caught across loaded images" \
+         "gcc -Wall -Wextra -Werror -I./include -rdynamic -o $WORK_DIR/host $WORK_DIR/host.c libisosloader.a -pthread && $WORK_DIR/host" \
+         "caught 42, 9 frames unwound, 1 cycle(s)"
+
+# Test 2: tables removed on close, new images at new addresses registered again
+run_test "Repeated open/close cycles" \
+         "$WORK_DIR/host 200" \
+         "caught 42, 9 frames unwound, 200 cycle(s)"
+
+# Test 3: same through libisosloader.so, which leaves glibc's _dl_find_object alone
+run_test "Through libisosloader.so" \
+         "! nm -D libisosloader.so | grep -q '_dl_find_object' && gcc -Wall -Wextra -Werror -I./include -o $WORK_DIR/host_so $WORK_DIR/host.c -L. -lisosloader -Wl,-rpath,$PWD -pthread && $WORK_DIR/host_so 3" \
+         "caught 42, 9 frames unwound, 3 cycle(s)"
+
+# Test 4: tables handed to libgcc with __register_frame_info_bases()
+run_test "Host does not export _dl_find_object" \
+         "! nm -D $WORK_DIR/host | grep -q '_dl_find_object'" \
+         ""
+
+# Test 5: exceptions thrown and caught in the host while an image is registered
+cat > "$WORK_DIR/host_cxx.cpp" <<'HOST'
+#include <cstdio>
+#include "isosloader.h"
+
+int main() {
+    my_dldebug_init(0);
+    void *lib = my_dlopen("./bench/lib/libehthrow.so");
+    try {
+        throw 7;
+    } catch (int v) {
+        std::printf("host caught %d\n", v);
+    }
+    my_dlclose(lib);
+    return 0;
+}
+HOST
+run_test "Host exceptions unaffected" \
+         "g++ -Wall -Wextra -Werror -I./include -rdynamic -o $WORK_DIR/host_cxx $WORK_DIR/host_cxx.cpp libisosloader.a -pthread && $WORK_DIR/host_cxx" \
+         "host caught 7"
+
+# Données importées (typeinfo, personnalité) : résolues dans l'hôte, comme par ld.so
+cat > "$WORK_DIR/data_import.c" <<'LIB'
+#include <stddef.h>
+
+extern int isos_absent_variable __attribute__((weak));
+#ifdef MISSING
+extern int isos_missing_variable;
+#endif
+
+const char *data_import(void) {
+#ifdef MISSING
+    if (isos_missing_variable) {
+        return "missing import bound";
+    }
+#endif
+    return &isos_absent_variable == NULL ? "weak import left at 0" : "weak import bound";
+}
+LIB
+
+# Test 6: an absent weak import leaves its slot at 0
+run_test "Absent weak data import is 0" \
+         "gcc -shared -fPIC -o $WORK_DIR/libweak.so $WORK_DIR/data_import.c && ./isos_loader $WORK_DIR/libweak.so data_import" \
+         "weak import left at 0"
+
+# Test 7: an absent non-weak import fails the load
+run_test "Absent data import refused" \
+         "gcc -shared -fPIC -DMISSING -o $WORK_DIR/libstrong.so $WORK_DIR/data_import.c && ./isos_loader $WORK_DIR/libstrong.so data_import; test \$? -ne 0" \
+         "Symbole indéfini : isos_missing_variable"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -85,6 +85,188 @@ run_test "Corrupted ELF magic number" \
          "./isos_loader -v $TEMP_DIR/corrupt_magic.so foo_exported" \
          "Not an ELF file"
 
+# Test 7: corrupted dynamic metadata never makes the loader fault.
+# Headers, section headers, the table entries of PT_DYNAMIC (DT_RELA,
+# DT_RELASZ, DT_SYMTAB...) and relocation targets/symbols are mutated;
+# each copy is loaded with my_dlopen_mem() in a child process. The
+# library is built without the startup files: no constructor runs, since
+# corrupted code would fault in the image itself, under ld.so as well.
+cat > $TEMP_DIR/fuzz_lib.c <<'LIB'
+#include <stdio.h>
+
+static const char *names[] = {"alpha", "beta", "gamma"};
+const char **table = names;
+extern int fuzz_weak_data __attribute__((weak));
+
+const char *fuzz_name(int i) {
+    return table[i % 3];
+}
+
+int fuzz_print(const char *s) {
+    return puts(s) + (&fuzz_weak_data != 0);
+}
+LIB
+
+cat > $TEMP_DIR/fuzz.c <<'FUZZ'
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "isosloader.h"
+#include "elf_parser.h"
+#include "debug.h"
+
+#define MAX_FIELDS 4096
+
+typedef struct {
+    size_t offset;
+    size_t size;
+} field;
+
+static field fields[MAX_FIELDS];
+static int field_count;
+
+static void add_field(size_t offset, size_t size, size_t len) {
+    if (field_count < MAX_FIELDS && offset + size <= len) {
+        fields[field_count++] = (field){offset, size};
+    }
+}
+
+// Décalage dans le fichier d'une adresse de lien (PT_LOAD), 0 si aucune
+static size_t file_offset(const elf_header *hdr, const elf_phdr *ph, uint64_t vaddr) {
+    for (int i = 0; i < hdr->e_phnum; i++) {
+        if (ph[i].p_type == PT_LOAD && vaddr >= ph[i].p_vaddr &&
+            vaddr < ph[i].p_vaddr + ph[i].p_filesz) {
+            return vaddr - ph[i].p_vaddr + ph[i].p_offset;
+        }
+    }
+    return 0;
+}
+
+static void add_relocs(const unsigned char *buf, size_t len, size_t off, uint64_t size) {
+    for (uint64_t r = 0; off && r + sizeof(Elf64_Rela) <= size; r += sizeof(Elf64_Rela)) {
+        add_field(off + r, 8, len);       // r_offset
+        add_field(off + r + 12, 4, len);  // symbole de r_info (le type reste)
+    }
+    (void) buf;
+}
+
+// Champs à corrompre : en-têtes, tables de PT_DYNAMIC, entrées de
+// relocation. e_entry est laissé : il désigne loader_info, dont le loader
+// suit les pointeurs comme il exécute le code de l'image.
+static void collect_fields(const unsigned char *buf, size_t len) {
+    const elf_header *hdr = (const elf_header *) buf;
+    const elf_phdr *ph = (const elf_phdr *) (buf + hdr->e_phoff);
+    for (size_t off = 0x20; off < sizeof(elf_header); off += 2) {
+        add_field(off, 2, len);
+    }
+    for (int i = 0; i < hdr->e_phnum; i++) {
+        size_t base = hdr->e_phoff + i * sizeof(elf_phdr);
+        for (size_t f = 8; f < sizeof(elf_phdr); f += 8) {
+            add_field(base + f, 8, len);
+        }
+    }
+    for (int i = 0; i < hdr->e_shnum; i++) {
+        size_t base = hdr->e_shoff + i * sizeof(Elf64_Shdr);
+        for (size_t f = 24; f < 48; f += 8) {
+            add_field(base + f, 8, len);  // sh_offset, sh_size
+        }
+        add_field(base + 40, 4, len);     // sh_link
+    }
+    for (int i = 0; i < hdr->e_phnum; i++) {
+        if (ph[i].p_type != PT_DYNAMIC) {
+            continue;
+        }
+        const Elf64_Dyn *dyn = (const Elf64_Dyn *) (buf + ph[i].p_offset);
+        uint64_t rela = 0, relasz = 0, jmprel = 0, pltrelsz = 0;
+        for (size_t d = 0; (d + 1) * sizeof(Elf64_Dyn) <= ph[i].p_filesz; d++) {
+            switch (dyn[d].d_tag) {
+                case DT_RELA: rela = dyn[d].d_val; break;
+                case DT_RELASZ: relasz = dyn[d].d_val; break;
+                case DT_JMPREL: jmprel = dyn[d].d_val; break;
+                case DT_PLTRELSZ: pltrelsz = dyn[d].d_val; break;
+                case DT_SYMTAB: case DT_STRTAB: case DT_STRSZ: case DT_PLTGOT: break;
+                default: continue;
+            }
+            add_field(ph[i].p_offset + d * sizeof(Elf64_Dyn) + 8, 8, len);
+        }
+        add_relocs(buf, len, file_offset(hdr, ph, rela), relasz);
+        add_relocs(buf, len, file_offset(hdr, ph, jmprel), pltrelsz);
+    }
+}
+
+static uint64_t rand64(void) {
+    return ((uint64_t) rand() << 42) ^ ((uint64_t) rand() << 21) ^ (uint64_t) rand();
+}
+
+static void mutate(unsigned char *buf, const field *f) {
+    uint64_t value = 0;
+    memcpy(&value, buf + f->offset, f->size);
+    switch (rand() % 5) {
+        case 0: value = rand64(); break;
+        case 1: value += (uint64_t) (rand() % 4096) - 2048; break;
+        case 2: value = (uint64_t) rand() % (1 << 20); break;
+        case 3: value = UINT64_MAX - (uint64_t) (rand() % 64); break;
+        default: value ^= (uint64_t) 1 << (rand() % (8 * f->size)); break;
+    }
+    memcpy(buf + f->offset, &value, f->size);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s LIB COPIES\n", argv[0]);
+        return 1;
+    }
+    FILE *fp = fopen(argv[1], "rb");
+    static unsigned char orig[1 << 20];
+    size_t len = fp ? fread(orig, 1, sizeof(orig), fp) : 0;
+    if (fp) {
+        fclose(fp);
+    }
+    if (len < sizeof(elf_header)) {
+        return 1;
+    }
+    collect_fields(orig, len);
+    my_dldebug_init(DBG_NONE);
+
+    int copies = atoi(argv[2]);
+    int loaded = 0;
+    int crashed = 0;
+    static unsigned char copy[1 << 20];
+    srand(1);
+    for (int n = 0; n < copies; n++) {
+        memcpy(copy, orig, len);
+        int mutations = 1 + rand() % 3;
+        for (int m = 0; m < mutations; m++) {
+            mutate(copy, &fields[rand() % field_count]);
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            void *handle = my_dlopen_mem(copy, len);
+            if (handle) {
+                my_dlclose(handle);
+            }
+            _exit(handle ? 0 : 1);
+        }
+        int status;
+        waitpid(pid, &status, 0);
+        if (WIFSIGNALED(status)) {
+            printf("copy %d: signal %d\n", n, WTERMSIG(status));
+            crashed++;
+        } else if (WEXITSTATUS(status) == 0) {
+            loaded++;
+        }
+    }
+    printf("%d corrupted copies: %d loaded, %d refused, %d faults\n", copies, loaded,
+           copies - loaded - crashed, crashed);
+    return crashed ? 1 : 0;
+}
+FUZZ
+
+run_test "Corrupted dynamic tables (300 copies)" \
+         "gcc -shared -fPIC -nostartfiles -o $TEMP_DIR/libfuzz.so $TEMP_DIR/fuzz_lib.c && gcc -Wall -Wextra -Werror -I./include -rdynamic -o $TEMP_DIR/fuzz $TEMP_DIR/fuzz.c libisosloader.a -pthread && $TEMP_DIR/fuzz $TEMP_DIR/libfuzz.so 300" \
+         "0 faults"
 
 # Clean up
 echo -e "${YELLOW}Cleaning up test files...${NC}"
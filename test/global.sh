@@ -0,0 +1,70 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Global Lookup Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+
+if [ ! -f "libmylib_v2.so" ]; then
+    echo -e "${RED}Build failed! libmylib_v2.so is missing.${NC}"
+    exit 1
+fi
+
+# Test 1: the first library in load order wins
+run_test "Load order (v1 first)" \
+         "./isos_loader --global ./libmylib_v2.so ./libmylib.so foo_exported | awk '/Résultat/ && !/v2/ { print \"v1 result\" }'" \
+         "v1 result"
+
+# Test 2: same libraries, opposite order
+run_test "Load order (v2 first)" \
+         "./isos_loader --global ./libmylib.so ./libmylib_v2.so foo_exported" \
+         "Hello from foo_exported() [v2]"
+
+# Test 3: a name exported by no library is not found
+run_test "Global miss" \
+         "./isos_loader -d 3 --global ./libmylib_v2.so ./libmylib.so no_such_symbol" \
+         "Function not found in the library"
+
+# Test 4: the global lookup agrees with my_dlsym on many handles
+make bench/lib/libbigtext.so bench/bench_dlsym_global > /dev/null
+run_test "Bloom filters vs my_dlsym" \
+         "./bench/bench_dlsym_global ./bench/lib/libbigtext.so ./libmylib.so 4 10 2>&1 | grep -c mismatch; test \${PIPESTATUS[0]} -eq 0" \
+         "0"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
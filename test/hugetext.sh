@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Huge Page Text Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+make bench/lib/libbigtext.so > /dev/null
+
+# Test 1: a text smaller than 2 MiB falls back to regular pages
+run_test "Small text falls back" \
+         "./isos_loader --huge-text ./libmylib.so foo_imported" \
+         "dont 0 en pages de 2 Mo (pages normales)"
+
+# Test 2: calls still work when the text is remapped
+run_test "Calls through remapped text" \
+         "./isos_loader --huge-text ./libmylib.so kernel_caller args_imported" \
+         "Hello from new_args(1, 2, 3, 4, 5, 6, 7.5)"
+
+# Test 3: a 16 MiB text is placed and reported (THP, hugetlbfs or fallback)
+run_test "Large text load stats" \
+         "./isos_loader --huge-text ./bench/lib/libbigtext.so fn_1000 | grep Image" \
+         "en pages de 2 Mo ("
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,101 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== IFUNC Dispatch Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+# Expected variant for this CPU
+if grep -qw avx512f /proc/cpuinfo; then
+    VARIANT="avx512"
+elif grep -qw avx2 /proc/cpuinfo; then
+    VARIANT="avx2"
+else
+    VARIANT="scalar"
+fi
+
+# Test 1: exported IFUNC (R_X86_64_IRELATIVE in .rela.dyn)
+run_test "Exported IFUNC resolved at load time" \
+         "./isos_loader ./libmylib.so kernel_dispatch" \
+         "Hello from kernel_dispatch() [$VARIANT]"
+
+# Test 2: local call to an IFUNC (R_X86_64_IRELATIVE in .rela.plt)
+run_test "Local call through an IRELATIVE PLT slot" \
+         "./isos_loader ./libmylib.so kernel_caller" \
+         "Hello from kernel_dispatch() [$VARIANT]"
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Bibliothèque avec un IFUNC et une donnée importée (stdout, ou une variable absente)
+cat > "$WORK_DIR/ifunc_import.c" <<'LIB'
+#include <stdio.h>
+
+#ifdef MISSING
+extern int isos_missing_variable;
+#define IMPORTED (isos_missing_variable != -1)
+#else
+#define IMPORTED (stdout != NULL)
+#endif
+
+static const char *pick_generic(void) {
+    return "Hello from ifunc_import() [generic]";
+}
+
+static const char *(*resolve_pick(void))(void) {
+    return pick_generic;
+}
+
+const char *pick(void) __attribute__((ifunc("resolve_pick")));
+
+const char *ifunc_import(void) {
+    return IMPORTED ? pick() : "no import";
+}
+LIB
+
+# Test 3: imports found in the host do not block the IFUNC pass
+run_test "IFUNC with an import resolved in the host" \
+         "gcc -shared -fPIC -o $WORK_DIR/libok.so $WORK_DIR/ifunc_import.c && ./isos_loader $WORK_DIR/libok.so ifunc_import" \
+         "Hello from ifunc_import() [generic]"
+
+# Test 4: an unresolvable import fails the load instead of leaving IFUNC slots empty
+run_test "IFUNC with an unbound import refused" \
+         "gcc -shared -fPIC -DMISSING -o $WORK_DIR/libmissing.so $WORK_DIR/ifunc_import.c && ./isos_loader $WORK_DIR/libmissing.so ifunc_import; test \$? -ne 0" \
+         "Symbole indéfini : isos_missing_variable"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
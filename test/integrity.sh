@@ -0,0 +1,75 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Integrity Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+make bench/lib/libplain.so bench/lib/libbigtext.so bench/bench_crc32c > /dev/null
+cp libmylib.so bench/lib/libplain.so bench/lib/libbigtext.so "$WORK_DIR/"
+
+run_test "Embed checksum note" "./isos_loader -C $WORK_DIR/libmylib.so" "CRC32C de 4 segments"
+run_test "Note is a non-allocated ELF note" "readelf -n $WORK_DIR/libmylib.so" "ISOS"
+run_test "Verified load" "./isos_loader -V $WORK_DIR/libmylib.so foo bar" "Intégrité: "
+run_test "Checksum note can be rewritten" "./isos_loader -C $WORK_DIR/libmylib.so && ./isos_loader -V $WORK_DIR/libmylib.so foo" "Recherche de la fonction foo"
+
+./isos_loader -C "$WORK_DIR/libplain.so" > /dev/null
+run_test "Verified standard library" "./isos_loader -V $WORK_DIR/libplain.so plain_counter plain_counter" "counter = 2"
+
+# Texte de 16 Mo : tranches de 1 Mo réparties entre threads puis recombinées
+./isos_loader -C "$WORK_DIR/libbigtext.so" > /dev/null
+run_test "Verified large text" "./isos_loader -V $WORK_DIR/libbigtext.so fn_1000" "16838597 octets vérifiés"
+
+# Un octet modifié dans le texte : chargement refusé, sauf sans vérification
+cp "$WORK_DIR/libmylib.so" "$WORK_DIR/tampered.so"
+printf '\x90' | dd of="$WORK_DIR/tampered.so" bs=1 seek=$((0x1100)) conv=notrunc 2> /dev/null
+run_test "Tampered text refused" "./isos_loader -V $WORK_DIR/tampered.so foo; test \$? -ne 0" "altéré"
+run_test "Tampered text loads unverified" "./isos_loader $WORK_DIR/tampered.so foo" "Recherche de la fonction foo"
+run_test "Missing note refused" "./isos_loader -V ./libmylib.so foo; test \$? -ne 0" "Pas de note"
+
+# Vérification d'un conteneur compressé et d'un chargement asynchrone
+./isos_loader -z "$WORK_DIR/libplain.isosz" "$WORK_DIR/libplain.so" > /dev/null
+run_test "Verified compressed container" "./isos_loader -V $WORK_DIR/libplain.isosz plain_counter" "Intégrité: "
+run_test "Verified async load" "./isos_loader -A -V $WORK_DIR/libplain.so plain_counter" "Intégrité: "
+
+run_test "Integrity bench" "./bench/bench_crc32c bench/lib/libplain.so 2" "verify    cold"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
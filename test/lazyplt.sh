@@ -0,0 +1,136 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Lazy PLT Binding Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+
+make bench/lib/libplain.so bench/bench_lazyplt > /dev/null
+if [ ! -f "bench/lib/libplain.so" ]; then
+    echo -e "${RED}Build failed! bench/lib/libplain.so is missing.${NC}"
+    exit 1
+fi
+
+# Test 1: imports of an ordinary library resolved through the host table
+run_test "Lazy binding (host table)" \
+         "./isos_loader ./bench/lib/libplain.so plain_hello" \
+         "Hello from plain_hello() via Hello from new_foo()"
+
+# Test 2: libc imports (snprintf, strlen) resolved in the process
+run_test "Lazy binding (process symbols)" \
+         "./isos_loader ./bench/lib/libplain.so plain_length" \
+         "strlen(new_bar()) = 20"
+
+# Test 3: the .got.plt is bound the same way when loaded from memory
+run_test "Lazy binding from memory" \
+         "./isos_loader -m ./bench/lib/libplain.so plain_hello" \
+         "Hello from plain_hello() via Hello from new_foo()"
+
+# Test 4: an import found nowhere stops the process like ld.so does
+run_test "Undefined import" \
+         "./isos_loader ./bench/lib/libplain.so plain_call; test \$? -eq 127" \
+         "symbol lookup error: undefined symbol: plain_hook"
+
+# Test 5: bound through the executable once plain_hook is exported
+run_test "Lazy binding vs glibc" \
+         "./bench/bench_lazyplt ./bench/lib/libplain.so 10 1000" \
+         "glibc"
+
+# Test 6: images needing DT_RELR or TLS are refused instead of half loaded
+run_test "DT_RELR library refused" \
+         "./isos_loader /usr/lib/x86_64-linux-gnu/libm.so.6 sin; test \$? -ne 0" \
+         "non supporté"
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Bibliothèque ordinaire avec constructeurs (DT_INIT_ARRAY) et destructeur
+cat > "$WORK_DIR/ctor.c" << 'CEOF'
+#include <stdio.h>
+#include <string.h>
+
+static int order;
+static char state[64];
+
+__attribute__((constructor(101))) static void first(int argc, char **argv) {
+    order = argc > 0 && argv && argv[0] ? 1 : -1;
+}
+
+__attribute__((constructor(102))) static void second(void) {
+    snprintf(state, sizeof(state), "constructed (order %d)", order);
+}
+
+__attribute__((destructor)) static void fini(void) {
+    puts("ctor destructor");
+}
+
+const char *ctor_state(void) {
+    return state[0] ? state : "not constructed";
+}
+
+const char *ctor_import(void) {
+    return strchr(state, 'o');
+}
+CEOF
+gcc -shared -fPIC -O2 "$WORK_DIR/ctor.c" -o "$WORK_DIR/libctor.so"
+gcc -shared -fPIC -O2 -Wl,-z,now "$WORK_DIR/ctor.c" -o "$WORK_DIR/libctor_now.so"
+
+# Test 7: constructors run in order with argc/argv, the destructor at my_dlclose
+run_test "Constructors and destructor" \
+         "./isos_loader $WORK_DIR/libctor.so ctor_state | tr '\\n' ' '" \
+         "constructed (order 1) ctor destructor"
+
+# JUMP_SLOT liés pendant un appel à ctor_state (constructeurs et destructeur compris)
+bound_slots() {
+    echo "slots bound: $(./isos_loader -d 4 "$1" ctor_state 2>&1 | grep -c 'Slot JUMP_SLOT lié')"
+}
+
+# Test 8: without -z now only the imports actually called are bound (snprintf, puts)
+run_test "Lazy library left lazy" "bound_slots $WORK_DIR/libctor.so" "slots bound: 2"
+
+# Test 9: -z now binds strchr too, although ctor_import is never called. The three
+# slots are bound at load, then again by my_set_plt_resolve()
+run_test "BIND_NOW library" "bound_slots $WORK_DIR/libctor_now.so" "slots bound: 6"
+
+# Test 10: the constructors also run for an image loaded from memory
+run_test "Constructors from memory" \
+         "./isos_loader -m $WORK_DIR/libctor_now.so ctor_import" \
+         "onstructed (order 1)"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
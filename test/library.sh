@@ -0,0 +1,161 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Embedded Library Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+
+make libisosloader.a libisosloader.so bench/lib/libplain.so > /dev/null
+if [ ! -f "libisosloader.a" ] || [ ! -f "libisosloader.so" ]; then
+    echo -e "${RED}Build failed! libisosloader is missing.${NC}"
+    exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Service hôte : n'inclut que l'en-tête public
+cat > "$WORK_DIR/host.c" <<'HOST'
+#include <stdio.h>
+#include "isosloader.h"
+
+const char *new_foo(void) { return "host new_foo()"; }
+const char *new_bar(void) { return "host new_bar()"; }
+long plain_hook(long x) { return 2 * x; }
+
+int main(int argc, char **argv) {
+    my_dldebug_init(0);
+    for (int round = 0; round < 2; round++) {
+        void *lib = my_dlopen_flags(argv[1], LOAD_POPULATE);
+        if (!lib) {
+            return 1;
+        }
+        const char *(*hello)(void) = (const char *(*)(void)) my_dlsym(lib, "plain_hello");
+        long (*call)(long) = (long (*)(long)) my_dlsym(lib, "plain_call");
+        if (!hello || !call) {
+            return 1;
+        }
+        printf("%s\n", hello());
+        printf("plain_call(20) = %ld\n", call(20));
+        printf("populated %s\n", my_dlloadstats(lib)->populated_size > 0 ? "yes" : "no");
+        my_dlclose(lib);
+    }
+    printf("%d loads in-process\n", argc > 1 ? 2 : 0);
+    return 0;
+}
+HOST
+
+CFLAGS_HOST="-std=c99 -Wall -Wextra -Werror -I./include"
+
+run_test "Public header is self-contained" \
+         "gcc $CFLAGS_HOST -fsyntax-only $WORK_DIR/host.c && g++ -x c++ -Wall -Werror -I./include -fsyntax-only $WORK_DIR/host.c" \
+         ""
+
+run_test "Host linked against libisosloader.a" \
+         "gcc $CFLAGS_HOST -rdynamic -o $WORK_DIR/host_static $WORK_DIR/host.c libisosloader.a -pthread && $WORK_DIR/host_static ./bench/lib/libplain.so" \
+         "Hello from plain_hello() via host new_foo()"
+
+# Hôte qui définit ses propres crc32c, load_library, debug_printf...
+cat > "$WORK_DIR/clash.c" <<'HOST'
+#include <stdio.h>
+#include "isosloader.h"
+
+unsigned crc32c(unsigned crc, const void *buf, unsigned long len) { return crc + len + !buf; }
+int load_library(const char *name) { return name != NULL; }
+void debug_printf(int level, const char *fmt) { (void) level; (void) fmt; }
+void *arena_create(unsigned long size) { return (void *) size; }
+int bloom_init(void) { return 7; }
+
+const char *new_foo(void) { return "host new_foo()"; }
+const char *new_bar(void) { return "host new_bar()"; }
+
+int main(int argc, char **argv) {
+    void *lib = argc > 1 ? my_dlopen(argv[1]) : NULL;
+    const char *(*hello)(void) = lib ? (const char *(*)(void)) my_dlsym(lib, "plain_hello") : NULL;
+    if (!hello) {
+        return 1;
+    }
+    printf("%s, host crc32c %u\n", hello(), crc32c(1, "", 2));
+    my_dlclose(lib);
+    return 0;
+}
+HOST
+
+run_test "Internal symbols stay local in libisosloader.a" \
+         "! nm -g --defined-only libisosloader.a | grep -E ' (crc32c|load_library|debug_printf|arena_create|bloom_init|hist_init|lz4_compress)\$'" \
+         ""
+
+run_test "Host symbols do not clash with libisosloader.a" \
+         "gcc -Wall -Wextra -Werror -I./include -rdynamic -o $WORK_DIR/clash $WORK_DIR/clash.c libisosloader.a -pthread && $WORK_DIR/clash ./bench/lib/libplain.so" \
+         "via host new_foo(), host crc32c 3"
+
+run_test "Host linked against libisosloader.so" \
+         "gcc $CFLAGS_HOST -rdynamic -o $WORK_DIR/host_shared $WORK_DIR/host.c -L. -lisosloader -Wl,-rpath,$PWD && $WORK_DIR/host_shared ./bench/lib/libplain.so" \
+         "plain_call(20) = 41"
+
+run_test "Repeated in-process loads" \
+         "$WORK_DIR/host_shared ./bench/lib/libplain.so" \
+         "2 loads in-process"
+
+run_test "Silent with traces off" \
+         "! $WORK_DIR/host_shared ./bench/lib/libplain.so | grep -q 'ELF Header'" \
+         ""
+
+run_test "Load options reach the library" \
+         "$WORK_DIR/host_shared ./bench/lib/libplain.so" \
+         "populated yes"
+
+run_test "Only the public API is exported" \
+         "nm -D --defined-only libisosloader.so | grep -c ' T ' && ! nm -D --defined-only libisosloader.so | grep -q ' T elf_open'" \
+         ""
+
+run_test "Exports carry the ISOSLOADER_1 version" \
+         "readelf --dyn-syms -W libisosloader.so | grep ' my_dlopen@@'" \
+         "my_dlopen@@ISOSLOADER_1"
+
+run_test "Exports all carry a project prefix" \
+         "! nm -D --defined-only libisosloader.so | grep -E ' T (debug_init|check_elf|epoch_enter|epoch_leave|integrity_write)\$'" \
+         ""
+
+# La CLI ne voit de la bibliothèque que l'API publique
+run_test "CLI is a client of the library" \
+         "! nm isos_loader | grep -E ' T (load_library|elf_open|find_function_by_name)\$' && ./isos_loader ./libmylib.so foo" \
+         "Recherche de la fonction foo"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,64 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Memory Accounting Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+
+# Test 1: one line per PT_LOAD segment plus a total
+run_test "Per-segment report" \
+         "./isos_loader --meminfo ./libmylib.so foo_exported | grep -c -E '^  ([0-9]+ [R-][W-][X-]|total) '" \
+         "5"
+
+# Test 2: the writable segment holds private dirty pages (relocations)
+run_test "Private dirty data" \
+         "./isos_loader --meminfo ./libmylib.so foo_exported | awk '/^  [0-9]+ RW-/ && \$9 > 0 { print \"dirty\" }'" \
+         "dirty"
+
+# Test 3: with the populate policy every text page is resident
+run_test "Populated text resident" \
+         "./isos_loader --policy populate --meminfo ./libmylib.so foo_exported | awk '/^  [0-9]+ R-X/ && \$4 == \$5 { print \"resident\" }'" \
+         "resident"
+
+# Test 4: packed images are accounted the same way
+run_test "Packed image" \
+         "./isos_loader --packed --meminfo ./libmylib.so foo_exported | grep '^  total'" \
+         "total"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,82 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Namespace Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+make bench/lib/libplain.so bench/bench_namespace > /dev/null
+
+# Bibliothèque dont le texte est relogé (DT_TEXTREL)
+printf 'int x;\nconst char *textrel_get(void) { x++; return "textrel"; }\n' > "$WORK_DIR/textrel.c"
+gcc -shared -fno-pic -mcmodel=large -Wl,-z,notext "$WORK_DIR/textrel.c" -o "$WORK_DIR/libtextrel.so"
+
+# Test 1: every namespace gets its own data and BSS
+run_test "Private data per namespace" \
+         "./isos_loader -n 2 ./bench/lib/libplain.so plain_counter plain_counter | awk -F'= ' '/Résultat/ { printf \"[%s]\", \$2 }'" \
+         "[1][2][1][2]"
+
+# Test 2: libraries with loader_info get one instance per namespace too
+run_test "loader_info library in namespaces" \
+         "./isos_loader -n 3 ./libmylib.so foo_exported | grep -A3 'Espace 2'" \
+         "Hello from foo_exported()"
+
+# Test 3: the text is never written, hence never private to an instance
+run_test "Shared text" \
+         "./isos_loader -n 2 -M ./bench/lib/libplain.so plain_hello | awk '\$2 == \"R-X\" { printf \"[%s]\", \$9 }'" \
+         "[0][0]"
+
+# Test 4: the export table of a plain library is built once per file
+run_test "Shared export table" \
+         "./isos_loader -d 3 -n 3 ./bench/lib/libplain.so plain_hello | grep -c 'Table d.export partagée réutilisée' | sed 's/^/reused: /'" \
+         "reused: 2"
+
+# Test 5: relocations in the text cannot be applied to shared pages
+run_test "TEXTREL library refused" \
+         "./isos_loader -n 1 $WORK_DIR/libtextrel.so textrel_get; test \$? -ne 0" \
+         "Relocation dans un segment en lecture seule (TEXTREL)"
+
+# Test 6: namespaces vs my_dlopen, per instance
+run_test "Namespace benchmark" \
+         "./bench/bench_namespace ./libmylib.so 4" \
+         "my_dlmopen  x4"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,138 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Packed Layout Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+# Test 1: a single library loaded into a pack
+run_test "Packed load" \
+         "./isos_loader --packed ./libmylib.so foo_imported args_imported" \
+         "Hello from new_args(1, 2, 3, 4, 5, 6, 7.5)"
+
+# Test 2: IFUNC relocations in a packed image
+run_test "Packed IFUNC" \
+         "./isos_loader --packed ./libmylib.so kernel_caller" \
+         "Hello from kernel_dispatch()"
+
+# Tests 3-4: two libraries back to back in the same pack, served by the zygote
+SOCKET="/tmp/isos_pack_test_$$.sock"
+./isos_loader --packed --serve "$SOCKET" ./libmylib.so ./libmylib_v2.so &
+SERVER_PID=$!
+for i in $(seq 1 50); do
+    [ -S "$SOCKET" ] && break
+    sleep 0.1
+done
+
+run_test "First packed library" \
+         "./isos_loader --connect $SOCKET ./libmylib.so foo_imported" \
+         "Hello from new_foo()"
+
+run_test "Second packed library" \
+         "./isos_loader --connect $SOCKET ./libmylib_v2.so foo_exported" \
+         "Hello from foo_exported() [v2]"
+
+kill -TERM $SERVER_PID
+wait $SERVER_PID
+
+# Pack plein : chaque chargement refusé doit rendre ce qu'il a pris dans l'arène
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+cat > "$WORK_DIR/full.c" <<'HOST'
+#include <stdio.h>
+#include "dynloader.h"
+#include "debug.h"
+
+int main(int argc, char **argv) {
+    (void) argc;
+    debug_init(DBG_NONE);
+    // Pack rempli jusqu'au premier refus
+    lib_pack_t *pack = my_dlpack_create(256 * 1024);
+    void *first = pack ? my_dlopen_packed(pack, argv[1]) : NULL;
+    if (!first) {
+        return 1;
+    }
+    while (my_dlopen_packed(pack, argv[1])) {
+    }
+    size_t before = arena_used(pack->arena);
+    int refused = 0;
+    for (int i = 0; i < 1000; i++) {
+        refused += my_dlopen_packed(pack, argv[1]) == NULL;
+    }
+    const char *(*fn)(void) = (const char *(*)(void)) my_dlsym(first, "foo_exported");
+    printf("%d refused, arena growth %zu bytes, %s\n", refused, arena_used(pack->arena) - before,
+           fn ? fn() : "lost");
+    my_dlpack_destroy(pack);
+    return 0;
+}
+HOST
+
+# Test 5: a library that does not fit leaves neither its handle nor its metadata behind
+CORE_OBJS=$(ls obj/*.o | grep -v -e obj/main.o -e obj/mylib.o -e obj/isosloader.o | tr "\n" " ")
+run_test "Pack full" \
+         "gcc -Wall -Wextra -Werror -I./include -rdynamic -o $WORK_DIR/full $WORK_DIR/full.c $CORE_OBJS -pthread && $WORK_DIR/full ./libmylib.so" \
+         "1000 refused, arena growth 0 bytes, Hello from foo_exported()"
+
+# Hôte C++ : pack détruit avec une image encore ouverte, puis exception dans l'hôte
+make bench/lib/libehthrow.so libisosloader.a > /dev/null
+cat > "$WORK_DIR/destroy.cpp" <<'HOST'
+#include <cstdio>
+#include "isosloader.h"
+
+int main() {
+    my_dldebug_init(0);
+    void *pack = my_dlpack_create(0);
+    void *lib = pack ? my_dlopen_packed(pack, "./bench/lib/libehthrow.so") : NULL;
+    if (!lib || my_dlpack_destroy(pack) != 0) {
+        return 1;
+    }
+    try {
+        throw 7;
+    } catch (int v) {
+        std::printf("host caught %d after destroy\n", v);
+    }
+    return 0;
+}
+HOST
+
+# Test 6: still-open handles leave libgcc's frame registry when the pack goes
+run_test "Pack destroyed with open handles" \
+         "g++ -Wall -Wextra -Werror -I./include -rdynamic -o $WORK_DIR/destroy $WORK_DIR/destroy.cpp libisosloader.a -pthread && $WORK_DIR/destroy" \
+         "host caught 7 after destroy"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
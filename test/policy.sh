@@ -0,0 +1,67 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Residency Policy Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+# args_imported covers an import whose host side (snprintf("%f")) has
+# pages of its own; --faults touches them before counting
+FUNCS="foo_exported bar_exported foo_imported kernel_caller args_imported"
+
+# Test 1: lazy loading is today's behaviour and reports first-call faults
+run_test "Lazy policy" \
+         "./isos_loader --policy lazy --faults ./libmylib.so $FUNCS" \
+         "Défauts de page pendant les 5 premiers appels"
+
+# Test 2: populate leaves no fault for the first calls
+run_test "Populate policy" \
+         "./isos_loader --policy populate --faults ./libmylib.so $FUNCS" \
+         "5 premiers appels: 0 mineurs, 0 majeurs"
+
+# Test 3: lock reports the locked bytes
+run_test "Lock policy" \
+         "./isos_loader --policy readahead,lock ./libmylib.so foo_imported" \
+         "Résidence: 0 octets préchargés, 20480 verrouillés"
+
+# Test 4: unknown policy names are rejected
+run_test "Unknown policy" \
+         "./isos_loader --policy eager ./libmylib.so foo_exported; test \$? -ne 0" \
+         "unknown policy: eager"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,77 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Page Profile Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+
+# args_imported covers an import whose host side (snprintf("%f")) has
+# pages of its own; --faults touches them before counting
+FUNCS="foo_exported bar_exported foo_imported kernel_caller args_imported"
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+cp ./libmylib.so "$WORK_DIR/libmylib.so"
+LIB="$WORK_DIR/libmylib.so"
+
+# Test 1: a warm-up run records the pages it touched
+run_test "Record profile" \
+         "./isos_loader --record-profile $LIB $FUNCS && test -s $LIB.isosprof" \
+         "libmylib.so.isosprof:"
+
+# Test 2: the profile policy prefetches the recorded pages
+run_test "Profile policy" \
+         "./isos_loader -d 3 --policy profile $LIB foo_exported" \
+         "Profil d'accès chargé"
+
+# Test 3: the recorded pages are resident before the first calls
+run_test "Profile first calls" \
+         "./isos_loader --policy profile --faults $LIB $FUNCS" \
+         "5 premiers appels: 0 mineurs, 0 majeurs"
+
+# Test 4: a profile recorded for another build of the library is ignored
+run_test "Stale profile" \
+         "cp ./libmylib_v2.so $WORK_DIR/v2.so && cp $LIB.isosprof $WORK_DIR/v2.so.isosprof && ./isos_loader -d 3 --policy profile $WORK_DIR/v2.so foo_exported" \
+         "Profil d'accès périmé, ignoré"
+
+# Test 5: a corrupt profile is ignored and the library still loads
+run_test "Corrupt profile" \
+         "head -c 100 /dev/urandom > $LIB.isosprof && ./isos_loader -d 3 --policy profile $LIB foo_exported" \
+         "Profil d'accès invalide, ignoré"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Hot Reload Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+if [ ! -f "libmylib_v2.so" ]; then
+    echo -e "${RED}Build failed! libmylib_v2.so is missing.${NC}"
+    exit 1
+fi
+
+# Test 1: exports switch to the new version
+run_test "Reload switches exports" \
+         "./isos_loader --reload ./libmylib_v2.so ./libmylib.so foo_exported" \
+         "Hello from foo_exported() [v2]"
+
+# Test 2: imports of the new version are bound before the switch
+run_test "Reload keeps imports bound" \
+         "./isos_loader --reload ./libmylib_v2.so ./libmylib.so args_imported | tail -1" \
+         "Hello from new_args(1, 2, 3, 4, 5, 6, 7.5)"
+
+# Test 3: a failed reload keeps serving the current version
+run_test "Failed reload keeps the old version" \
+         "./isos_loader -d 2 --reload ./missing.so ./libmylib.so foo_exported | tail -1" \
+         "Résultat de l'appel: Hello from foo_exported()"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,151 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Symbol Index Sidecar Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+rm -f libmylib.so.isosidx
+
+# Test 1: write the sidecar
+run_test "Write libmylib.so.isosidx" \
+         "./isos_loader --index ./libmylib.so" \
+         "symboles indexés"
+
+# Test 2: lookups go through the index
+run_test "Lookup through the index" \
+         "./isos_loader -d 3 ./libmylib.so foo_exported" \
+         "Index de symboles chargé"
+
+run_test "Indexed symbol is callable" \
+         "./isos_loader ./libmylib.so kernel_caller args_imported" \
+         "Hello from new_args(1, 2, 3, 4, 5, 6, 7.5)"
+
+run_test "Missing symbol with the index" \
+         "./isos_loader -d 1 ./libmylib.so missing_one" \
+         "Symbols not found (1): missing_one"
+
+# Test 3: a corrupted sidecar is ignored
+printf 'garbage' | dd of=libmylib.so.isosidx bs=1 seek=0 conv=notrunc 2>/dev/null
+run_test "Corrupted index is ignored" \
+         "./isos_loader -d 2 ./libmylib.so foo_exported" \
+         "Hello from foo_exported()"
+
+rm -f libmylib.so.isosidx
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+CORE_OBJS=$(ls obj/*.o | grep -v -e obj/main.o -e obj/mylib.o -e obj/isosloader.o | tr "\n" " ")
+
+# Index falsifié : chaque slot occupé pointe loin hors de l'image
+cat > "$WORK_DIR/tamper.c" <<'HOST'
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "symbol_index.h"
+
+int main(int argc, char **argv) {
+    int fd = argc > 1 ? open(argv[1], O_RDWR) : -1;
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        return 1;
+    }
+    char *map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return 1;
+    }
+    isosidx_header *hdr = (isosidx_header *) map;
+    isosidx_slot *slots = (isosidx_slot *) (hdr + 1);
+    int tampered = 0;
+    for (uint32_t i = 0; i < hdr->bucket_count; i++) {
+        if (slots[i].name_off != ISOSIDX_EMPTY) {
+            slots[i].offset = (uint64_t) 1 << 40;
+            tampered++;
+        }
+    }
+    munmap(map, st.st_size);
+    printf("%d slots tampered\n", tampered);
+    return 0;
+}
+HOST
+
+# Test 4: offsets outside the image are never handed out
+run_test "Tampered index offsets rejected" \
+         "./isos_loader --index ./libmylib.so > /dev/null && gcc -Wall -Wextra -Werror -I./include -o $WORK_DIR/tamper $WORK_DIR/tamper.c && $WORK_DIR/tamper libmylib.so.isosidx && ./isos_loader -d 2 ./libmylib.so foo_exported; test \$? -lt 128" \
+         "adresse hors de l'image"
+
+rm -f libmylib.so.isosidx
+
+# Export hors de l'image (fonction de l'hôte) : pas d'entrée dans l'index
+cat > "$WORK_DIR/outside.c" <<'HOST'
+#include <stdio.h>
+#include "dynloader.h"
+#include "debug.h"
+
+const char *host_fn(void) { return "host"; }
+
+int main(int argc, char **argv) {
+    debug_init(DBG_NONE);
+    void *lib = argc > 1 ? my_dlopen(argv[1]) : NULL;
+    if (!lib) {
+        return 1;
+    }
+    lib_handle_t *h = lib;
+    symbol_entry table[] = {{"host_fn", (void *) host_fn},
+                            {"foo_exported", my_dlsym(lib, "foo_exported")},
+                            {NULL, NULL}};
+    h->exported_symbols = table;
+    int count = isosidx_write(argv[1], lib);
+    my_dlclose(lib);
+
+    lib = my_dlopen(argv[1]);
+    printf("%d indexed, host_fn %s, foo_exported %s\n", count,
+           my_dlsym(lib, "host_fn") ? "found" : "absent",
+           my_dlsym(lib, "foo_exported") ? "found" : "absent");
+    my_dlclose(lib);
+    return 0;
+}
+HOST
+
+# Test 5: isosidx_write() skips exports that do not lie in the image
+run_test "Exports outside the image not indexed" \
+         "cp libmylib.so $WORK_DIR/ && gcc -Wall -Wextra -Werror -I./include -rdynamic -o $WORK_DIR/outside $WORK_DIR/outside.c $CORE_OBJS -pthread && $WORK_DIR/outside $WORK_DIR/libmylib.so" \
+         "1 indexed, host_fn absent, foo_exported found"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
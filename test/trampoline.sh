@@ -0,0 +1,184 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== PLT Trampoline Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+# Test 1: import without arguments
+run_test "Import without arguments" \
+         "./isos_loader ./libmylib.so foo_imported" \
+         "Hello from new_foo()"
+
+# Test 2: arguments (integer and vector registers) survive the trampoline
+run_test "Import with integer and floating point arguments" \
+         "./isos_loader ./libmylib.so args_imported" \
+         "Hello from new_args(1, 2, 3, 4, 5, 6, 7.5)"
+
+# Test 3: second call goes through the bound slot
+run_test "Import called twice (bound slot)" \
+         "./isos_loader ./libmylib.so args_imported bar_imported args_imported" \
+         "Hello from new_bar()"
+
+# Test 4: throughput mode reports percentiles for PLT and direct calls
+run_test "Throughput mode (--repeat)" \
+         "./isos_loader --repeat 10000 ./libmylib.so foo_imported" \
+         "new_foo [direct]"
+
+# Test 4b: the replayed PLT entry hands defined arguments to the import
+run_test "PLT replay arguments" \
+         "./isos_loader --repeat 1000 ./libmylib.so args_imported" \
+         "=> Hello from new_args(1, 2, 3, 4, 5, 6, 7.5)"
+
+# Test 4c: batched samples are labelled as per-batch means, --batch 1 times each call
+run_test "Percentiles of batch means labelled" \
+         "./isos_loader --repeat 1000 ./libmylib.so foo_exported" \
+         "per-batch mean p50="
+run_test "Per-call percentiles (--batch 1)" \
+         "./isos_loader --repeat 1000 --batch 1 ./libmylib.so foo_exported | grep 'foo_exported ' | grep -v 'per-batch'" \
+         "p999="
+
+# Test 5: function list read from stdin
+run_test "Function list from stdin (--duration)" \
+         "printf 'foo_exported\\n# comment\\nbar_imported\\n' | ./isos_loader -t 0.05 -f - ./libmylib.so" \
+         "bar_imported"
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Hôte : fonction AVX appelée par la bibliothèque chargée via sa PLT
+cat > "$WORK_DIR/host.c" <<'HOST'
+#include <immintrin.h>
+#include <stdio.h>
+#include "dynloader.h"
+
+__m256d host_avx_add(__m256d a, __m256d b) {
+    return _mm256_add_pd(a, b);
+}
+
+// Appelé par le résolveur (table de my_set_plt_resolve) : code VEX qui
+// remet à zéro les moitiés hautes des ymm, comme les variantes AVX2 de
+// la libc
+int strcmp(const char *a, const char *b) {
+    __asm__ volatile("vzeroupper");
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return (unsigned char) *a - (unsigned char) *b;
+}
+
+int main(void) {
+    static symbol_entry table[] = {{"host_avx_add", (void *) host_avx_add}, {NULL, NULL}};
+    void *lib = my_dlopen(LIB);
+    double (*run_avx)(void) = lib ? (double (*)(void)) my_dlsym(lib, "run_avx") : NULL;
+    if (!run_avx || my_set_plt_resolve(lib, table) != 0) {
+        return 1;
+    }
+    // Premier appel : résolveur C entre l'appelant et la cible
+    double first = run_avx();
+    double second = run_avx();
+    printf("avx lanes: %g %g\n", first, second);
+    my_dlclose(lib);
+    return 0;
+}
+HOST
+
+cat > "$WORK_DIR/avx_args.c" <<'LIB'
+#include <immintrin.h>
+
+__m256d host_avx_add(__m256d a, __m256d b);
+
+double run_avx(void) {
+    double out[4];
+    _mm256_storeu_pd(out, host_avx_add(_mm256_set_pd(4, 3, 2, 1), _mm256_set_pd(40, 30, 20, 10)));
+    // Poids distincts : une moitié haute perdue change le résultat
+    return out[0] + 2 * out[1] + 3 * out[2] + 4 * out[3];
+}
+LIB
+
+# Test 6: upper halves of ymm arguments survive the resolver (XSAVE)
+if grep -qw avx /proc/cpuinfo; then
+    run_test "AVX arguments across the first (resolving) call" \
+             "gcc -shared -fPIC -O2 -mavx -o $WORK_DIR/libavx.so $WORK_DIR/avx_args.c && gcc -Wall -Wextra -Werror -O2 -mavx -I./include -rdynamic -DLIB='\"$WORK_DIR/libavx.so\"' -o $WORK_DIR/host $WORK_DIR/host.c libisosloader.a -pthread && $WORK_DIR/host" \
+             "avx lanes: 330 330"
+fi
+
+# Hôte dont la table ne fournit pas new_bar ; "range" appelle le
+# résolveur avec un id hors de la table des imports
+cat > "$WORK_DIR/missing.c" <<'HOST'
+#include <stdio.h>
+#include <string.h>
+#include "dynloader.h"
+#include "loader.h"
+
+const char *host_foo(void) { return "host new_foo()"; }
+
+int main(int argc, char **argv) {
+    static symbol_entry table[] = {{"new_foo", (void *) host_foo}, {NULL, NULL}};
+    void *lib = argc > 2 ? my_dlopen(argv[1]) : NULL;
+    if (!lib || my_set_plt_resolve(lib, table) != 0) {
+        return 1;
+    }
+    if (strcmp(argv[2], "range") == 0) {
+        printf("prebind missing %d\n", my_dlprebind(lib));
+        fflush(stdout);
+        loader_plt_resolver(lib, 1000);
+        return 0;
+    }
+    const char *(*fn)(void) = (const char *(*)(void)) my_dlsym(lib, argv[2]);
+    printf("%s\n", fn ? fn() : "lost");
+    fflush(stdout);
+    return 0;
+}
+HOST
+
+CORE_OBJS=$(ls obj/*.o | grep -v -e obj/main.o -e obj/mylib.o -e obj/isosloader.o | tr "\n" " ")
+gcc -Wall -Wextra -Werror -I./include -rdynamic -o "$WORK_DIR/missing" "$WORK_DIR/missing.c" $CORE_OBJS -pthread
+
+# Test 7: an import missing from the table stops the process instead of jumping to 0
+run_test "Unresolved loader PLT import" \
+         "$WORK_DIR/missing ./libmylib.so foo_imported && $WORK_DIR/missing ./libmylib.so bar_imported; test \$? -eq 127" \
+         "symbol lookup error: undefined symbol: new_bar"
+
+# Test 8: a symbol id past the import table is rejected, not read out of bounds
+run_test "Out of range symbol id" \
+         "$WORK_DIR/missing ./libmylib.so range; test \$? -eq 127" \
+         "prebind missing 2"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
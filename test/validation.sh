@@ -0,0 +1,78 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== ELF Validation Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Copie de libmylib.so dont un champ de phdr est réécrit (little-endian)
+# usage: patch_phdr NAME PHDR_INDEX FIELD_OFFSET BYTES
+patch_phdr() {
+    cp ./libmylib.so "$WORK_DIR/$1"
+    printf "$4" | dd of="$WORK_DIR/$1" bs=1 seek=$((64 + $2 * 56 + $3)) conv=notrunc 2>/dev/null
+}
+
+patch_phdr libdown.so 2 16 '\x00\x08'
+patch_phdr liboverlap.so 1 16 '\x00\x01'
+patch_phdr libuncovered.so 0 8 '\x00\x10'
+
+# Test 1: re-opening an unchanged library reuses the validation verdict
+run_test "Cached verdict" \
+         "./isos_loader -d 3 --reload ./libmylib.so ./libmylib.so foo_exported" \
+         "Validation ELF en cache"
+
+# Test 2: descending PT_LOAD addresses are rejected before anything is mapped
+run_test "Descending PT_LOAD" \
+         "./isos_loader $WORK_DIR/libdown.so foo_exported; test \$? -ne 0" \
+         "PT_LOAD segments not in ascending order"
+
+# Test 3: overlapping PT_LOAD segments are rejected
+run_test "Overlapping PT_LOAD" \
+         "./isos_loader $WORK_DIR/liboverlap.so foo_exported; test \$? -ne 0" \
+         "PT_LOAD segments overlap in memory"
+
+# Test 4: program header coverage is checked whatever the file name
+run_test "Uncovered program headers" \
+         "./isos_loader $WORK_DIR/libuncovered.so foo_exported; test \$? -ne 0" \
+         "No PT_LOAD segment spans all program headers"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"
@@ -0,0 +1,153 @@
+#!/bin/bash
+
+# Colors for better output readability
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}===== Zygote Server Test =====${NC}"
+echo ""
+
+# Make sure we have our binaries
+echo -e "${YELLOW}Building project...${NC}"
+make clean
+make
+if [ ! -f "isos_loader" ] || [ ! -f "libmylib.so" ]; then
+    echo -e "${RED}Build failed! Make sure all source files are present.${NC}"
+    exit 1
+fi
+
+# Function to run a test and report results
+run_test() {
+    local test_name="$1"
+    local command="$2"
+    local expected_result="$3"
+
+    echo -e "${YELLOW}Test: $test_name${NC}"
+
+    output=$(eval "$command" 2>&1)
+    exit_code=$?
+    echo "$output"
+
+    if [[ $exit_code -eq 0 && $output == *"$expected_result"* ]]; then
+        echo -e "${GREEN}PASSED${NC} (found expected message: '$expected_result')"
+    else
+        echo -e "${RED}FAILED${NC}"
+        echo "Command: $command"
+        echo "Exit code: $exit_code"
+    fi
+    echo ""
+}
+
+SOCKET="/tmp/isos_zygote_test_$$.sock"
+
+# Start the server in the background and wait for its socket; the
+# permissive umask must not leak into the socket mode
+OLD_UMASK=$(umask)
+umask 000
+./isos_loader --serve "$SOCKET" ./libmylib.so &
+SERVER_PID=$!
+umask "$OLD_UMASK"
+for i in $(seq 1 50); do
+    [ -S "$SOCKET" ] && break
+    sleep 0.1
+done
+
+# Test 1: plain call through a forked child
+run_test "Zygote call" \
+         "./isos_loader --connect $SOCKET ./libmylib.so foo_imported" \
+         "Hello from new_foo()"
+
+# Test 2: several functions, including IFUNC and many-argument imports
+run_test "Zygote multiple calls" \
+         "./isos_loader --connect $SOCKET ./libmylib.so args_imported kernel_caller" \
+         "Hello from new_args(1, 2, 3, 4, 5, 6, 7.5)"
+
+# Test 3: only the server's user can reach the socket
+run_test "Socket mode 0600" \
+         "stat -c %a $SOCKET" \
+         "600"
+
+# Test 4: a library the server does not hold is refused
+run_test "Library not served" \
+         "./isos_loader -d 2 --connect $SOCKET ./libother.so foo_imported; test \$? -ne 0" \
+         "library not served"
+
+# Stop the server: it must remove its socket on SIGTERM
+kill -TERM $SERVER_PID
+wait $SERVER_PID
+run_test "Socket removed on shutdown" \
+         "test ! -e $SOCKET && echo removed" \
+         "removed"
+
+# Le client se connecte dès que la socket apparaît : elle doit déjà écouter
+race_start() {
+    local refused=0
+    for i in $(seq 1 20); do
+        ./isos_loader --serve "$SOCKET" ./libmylib.so > /dev/null 2>&1 &
+        local pid=$!
+        while [ ! -S "$SOCKET" ]; do
+            sleep 0.001
+        done
+        ./isos_loader --connect "$SOCKET" ./libmylib.so foo_imported > /dev/null 2>&1 || refused=$((refused + 1))
+        kill -TERM $pid
+        wait $pid
+    done
+    echo "$refused refused"
+}
+
+# Test 5: the socket path only appears once the server listens
+run_test "Socket ready when it appears" "race_start" "0 refused"
+
+# Hôte qui sert puis reprend la main : ses gestionnaires doivent revenir
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+cat > "$WORK_DIR/host.c" <<'HOST'
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "isosloader.h"
+#include "zygote.h"
+
+static void on_chld(int sig) { (void) sig; }
+
+int main(int argc, char **argv) {
+    (void) argc;
+    my_dldebug_init(0);
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_chld;
+    sigaction(SIGCHLD, &sa, NULL);
+
+    void *handle = my_dlopen(argv[2]);
+    if (!handle || fork() == 0) {
+        // Attend la socket, puis arrête le serveur
+        struct stat st;
+        while (stat(argv[1], &st) != 0) {
+            usleep(10000);
+        }
+        kill(getppid(), SIGTERM);
+        _exit(0);
+    }
+    if (zygote_serve(argv[1], &argv[2], &handle, 1) != 0) {
+        return 1;
+    }
+    struct sigaction chld, term;
+    sigaction(SIGCHLD, NULL, &chld);
+    sigaction(SIGTERM, NULL, &term);
+    printf("SIGCHLD %s, SIGTERM %s\n", chld.sa_handler == on_chld ? "restored" : "lost",
+           term.sa_handler == SIG_DFL ? "restored" : "lost");
+    return 0;
+}
+HOST
+
+# Test 6: zygote_serve() gives back the caller's signal handlers
+CORE_OBJS=$(ls obj/*.o | grep -v -e obj/main.o -e obj/mylib.o -e obj/isosloader.o | tr "\n" " ")
+run_test "Signal handlers restored" \
+         "gcc -Wall -Wextra -Werror -I./include -rdynamic -o $WORK_DIR/host $WORK_DIR/host.c $CORE_OBJS -pthread && $WORK_DIR/host $WORK_DIR/host.sock ./libmylib.so" \
+         "SIGCHLD restored, SIGTERM restored"
+
+echo -e "${YELLOW}===== Test Complete =====${NC}"